@@ -15,7 +15,30 @@ public class PeakPursuit : ModuleRules
 			"InputCore", 
 			"HeadMountedDisplay", 
 			"EnhancedInput",
-            "MotionWarping"
+            "MotionWarping",
+            "AnimationBudgetAllocator",
+            "AIModule",
+            "NavigationSystem"
         });
+
+		PrivateDependencyModuleNames.AddRange(new string[] {
+			"AssetRegistry",
+			"Json",
+			"DeveloperSettings",
+			"SignificanceManager",
+			"MassEntity",
+			"MassCommon",
+			"MassSpawner",
+			"MeshDescription",
+			"StaticMeshDescription",
+			"MeshUtilitiesCommon"
+		});
+
+		if (Target.bBuildEditor)
+		{
+			PrivateDependencyModuleNames.Add("MeshReductionInterface");
+		}
+
+		SetupGameplayDebuggerSupport(Target);
 	}
 }
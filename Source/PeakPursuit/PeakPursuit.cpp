@@ -2,6 +2,38 @@
 
 #include "PeakPursuit.h"
 #include "Modules/ModuleManager.h"
+#include "Debug/GameplayDebuggerCategory_Climb.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, PeakPursuit, "PeakPursuit" );
- 
\ No newline at end of file
+#if WITH_GAMEPLAY_DEBUGGER && WITH_CLIMB_PROBE_RECORDER
+#include "GameplayDebugger.h"
+#endif
+
+DEFINE_LOG_CATEGORY(LogClimb);
+
+class FPeakPursuitModule : public FDefaultGameModuleImpl
+{
+public:
+	virtual void StartupModule() override
+	{
+#if WITH_GAMEPLAY_DEBUGGER && WITH_CLIMB_PROBE_RECORDER
+		IGameplayDebugger& GameplayDebugger = IGameplayDebugger::Get();
+		GameplayDebugger.RegisterCategory("Climb", IGameplayDebugger::FOnGetCategory::CreateStatic(&FGameplayDebuggerCategory_Climb::MakeInstance),
+			EGameplayDebuggerCategoryState::EnabledInGameAndSimulate);
+		GameplayDebugger.NotifyCategoriesChanged();
+#endif
+	}
+
+	virtual void ShutdownModule() override
+	{
+#if WITH_GAMEPLAY_DEBUGGER && WITH_CLIMB_PROBE_RECORDER
+		if (IGameplayDebugger::IsAvailable())
+		{
+			IGameplayDebugger& GameplayDebugger = IGameplayDebugger::Get();
+			GameplayDebugger.UnregisterCategory("Climb");
+			GameplayDebugger.NotifyCategoriesChanged();
+		}
+#endif
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FPeakPursuitModule, PeakPursuit, "PeakPursuit" );
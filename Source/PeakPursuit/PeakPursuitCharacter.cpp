@@ -10,21 +10,57 @@
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "Components/ClimbMovementComponent.h"
+#include "Climb/ClimbMath.h"
 #include "DebugHelper.h"
 #include "MotionWarpingComponent.h"
+#include "SkeletalMeshComponentBudgeted.h"
+#include "PeakPursuit.h"
+#include "Kismet/GameplayStatics.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+
+
+#if !UE_BUILD_SHIPPING
+static FAutoConsoleCommandWithWorldAndArgs CmdClimbRecordInput(
+	TEXT("climb.RecordInput"),
+	TEXT("Toggles recording of the local player's climb input. climb.RecordInput [Filename]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		APeakPursuitCharacter* Character = Cast<APeakPursuitCharacter>(UGameplayStatics::GetPlayerCharacter(World, 0));
+		if (!Character) { return; }
+
+		if (Character->IsRecordingInput())
+		{
+			Character->StopInputRecording();
+			return;
+		}
+
+		const FString Filename = Args.Num() > 0
+			? Args[0]
+			: FPaths::ProjectSavedDir() / TEXT("ClimbRecordings") / FDateTime::Now().ToString() + TEXT(".climbinput");
+		Character->StartInputRecording(Filename);
+	})
+);
+#endif
 
 
 //////////////////////////////////////////////////////////////////////////
 // APeakPursuitCharacter
 
 APeakPursuitCharacter::APeakPursuitCharacter(const FObjectInitializer& ObjInitializer) 
-	: Super(ObjInitializer.SetDefaultSubobjectClass<UClimbMovementComponent>(ACharacter::CharacterMovementComponentName))
+	: Super(ObjInitializer
+		.SetDefaultSubobjectClass<UClimbMovementComponent>(ACharacter::CharacterMovementComponentName)
+		.SetDefaultSubobjectClass<USkeletalMeshComponentBudgeted>(ACharacter::MeshComponentName))
 {
 	ClimbMovementComponent = Cast<UClimbMovementComponent>(GetCharacterMovement());
 	MotionWarpingComponent = CreateDefaultSubobject<UMotionWarpingComponent>(TEXT("MotionWarpingComp"));
 
 	// Set size for collision capsule
 	GetCapsuleComponent()->InitCapsuleSize(42.f, 96.0f);
+
+	// Distant characters update their animation less often, through the budget allocator when a.Budget.Enabled is set
+	// and through update rate optimizations otherwise
+	GetMesh()->bEnableUpdateRateOptimizations = true;
 		
 	// Don't rotate when the controller rotates. Let that just affect the camera.
 	bUseControllerRotationPitch = false;
@@ -69,6 +105,7 @@ void APeakPursuitCharacter::BeginPlay()
 	{
 		ClimbMovementComponent->OnEnterClimbState.BindUObject(this, &ThisClass::OnPlayerEnterClimbState);
 		ClimbMovementComponent->OnExitClimbState.BindUObject(this, &ThisClass::OnPlayerExitClimbState);
+		ClimbMovementComponent->OnClimbMontageChanged.BindUObject(this, &ThisClass::UpdateAnimationBudget);
 	}
 }
 
@@ -81,8 +118,8 @@ void APeakPursuitCharacter::SetupPlayerInputComponent(class UInputComponent* Pla
 	if (UEnhancedInputComponent* EnhancedInputComponent = CastChecked<UEnhancedInputComponent>(PlayerInputComponent)) {
 		
 		//Jumping
-		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Triggered, this, &ACharacter::Jump);
-		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Completed, this, &ACharacter::StopJumping);
+		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Triggered, this, &APeakPursuitCharacter::OnJumpActionTriggered);
+		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Completed, this, &APeakPursuitCharacter::OnJumpActionCompleted);
 
 		//Moving
 		EnhancedInputComponent->BindAction(MoveAction, ETriggerEvent::Triggered, this, &APeakPursuitCharacter::HandleGroundMovementInput);
@@ -104,6 +141,93 @@ void APeakPursuitCharacter::SetupPlayerInputComponent(class UInputComponent* Pla
 
 }
 
+void APeakPursuitCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	StopInputRecording();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void APeakPursuitCharacter::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	UpdateAnimationBudget();
+
+	//Input for this frame has been processed by the controller, movement has not run yet
+	if (InputRecorder)
+	{
+		InputRecorder->CommitFrame(DeltaSeconds, GetActorLocation(), Controller ? Controller->GetControlRotation() : FRotator::ZeroRotator);
+	}
+}
+
+void APeakPursuitCharacter::UpdateAnimationBudget()
+{
+	if (!ClimbMovementComponent) { return; }
+
+	//Climb montages carry root motion and motion warp windows, a skipped or interpolated frame can miss the window
+	const bool bNeverSkip = ClimbMovementComponent->IsPlayingClimbMontage();
+
+	static constexpr float TierSignificance[(int32)EClimbLODTier::Num] = { 1.0f, 0.5f, 0.1f };
+	const float Significance = TierSignificance[(int32)ClimbMovementComponent->GetClimbLODTier()];
+
+	if (bNeverSkip == bAnimationNeverSkip && Significance == AnimationSignificance) { return; }
+
+	bAnimationNeverSkip = bNeverSkip;
+	AnimationSignificance = Significance;
+
+	GetMesh()->bEnableUpdateRateOptimizations = !bNeverSkip;
+
+	if (USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(GetMesh()))
+	{
+		BudgetedMesh->SetComponentSignificance(Significance, bNeverSkip, false, !bNeverSkip);
+	}
+}
+
+void APeakPursuitCharacter::StartInputRecording(const FString& Filename)
+{
+	InputRecorder = MakeUnique<FClimbInputRecorder>(Filename);
+
+	//Playback reseeds with the same value so anything random in movement or animation repeats
+	FClimbInputRecording& Recording = InputRecorder->GetRecording();
+	Recording.RandomSeed = (int32)FPlatformTime::Cycles();
+	FMath::RandInit(Recording.RandomSeed);
+
+	Recording.MapName = UWorld::RemovePIEPrefix(GetWorld()->GetOutermost()->GetName());
+	Recording.CharacterClassPath = GetClass()->GetPathName();
+	Recording.StartTransform = GetActorTransform();
+	Recording.StartControlRotation = Controller ? Controller->GetControlRotation() : FRotator::ZeroRotator;
+	Recording.bStartClimbing = ClimbMovementComponent->IsClimbing();
+	Recording.StartSurfaceLocation = ClimbMovementComponent->GetClimbableSurfaceLocation();
+	Recording.StartSurfaceNormal = ClimbMovementComponent->GetClimbableSurfaceNormal();
+
+	UE_LOG(LogClimb, Display, TEXT("Recording climb input to %s"), *Filename);
+}
+
+void APeakPursuitCharacter::StopInputRecording()
+{
+	if (!InputRecorder) { return; }
+
+	InputRecorder->Finish(GetActorTransform());
+	InputRecorder.Reset();
+}
+
+void APeakPursuitCharacter::ApplyRecordedInput(const FClimbInputFrame& Frame)
+{
+	if (Frame.HasFlag(FClimbInputFrame::GroundMove)) { HandleGroundMovementInput(FInputActionValue(FVector2D(Frame.GroundMoveValue))); }
+	if (Frame.HasFlag(FClimbInputFrame::ClimbMove)) { HandleClimbMovementInput(FInputActionValue(FVector2D(Frame.ClimbMoveValue))); }
+	if (Frame.HasFlag(FClimbInputFrame::JumpTriggered)) { OnJumpActionTriggered(FInputActionValue(true)); }
+	if (Frame.HasFlag(FClimbInputFrame::JumpCompleted)) { OnJumpActionCompleted(FInputActionValue(false)); }
+	if (Frame.HasFlag(FClimbInputFrame::ClimbStarted)) { OnClimbActionStarted(FInputActionValue(true)); }
+	if (Frame.HasFlag(FClimbInputFrame::HopStarted)) { OnClimbHopActionStarted(FInputActionValue(true)); }
+
+	//Live look input updates the control rotation after the move handlers ran, keep that order
+	if (Frame.HasFlag(FClimbInputFrame::ControlRotation) && Controller)
+	{
+		Controller->SetControlRotation(FRotator(Frame.ControlRotationValue));
+	}
+}
+
 void APeakPursuitCharacter::OnPlayerEnterClimbState()
 {
 	AddInputMappingContext(ClimbMappingContext, 1);
@@ -158,6 +282,8 @@ void APeakPursuitCharacter::HandleGroundMovementInput(const FInputActionValue& V
 	// input is a Vector2D
 	const FVector2D MovementVector = Value.Get<FVector2D>();
 
+	if (InputRecorder) { InputRecorder->RecordGroundMove(MovementVector); }
+
 	if (Controller != nullptr)
 	{
 		// find out which way is forward
@@ -181,13 +307,12 @@ void APeakPursuitCharacter::HandleClimbMovementInput(const FInputActionValue& Va
 	// input is a Vector2D
 	const FVector2D MovementVector = Value.Get<FVector2D>();
 
-	const FVector SurfaceNormal = -(ClimbMovementComponent->GetClimbableSurfaceNormal());
+	if (InputRecorder) { InputRecorder->RecordClimbMove(MovementVector); }
 
-	// get forward vector
-	const FVector ForwardDirection = FVector::CrossProduct(SurfaceNormal, GetActorRightVector());
-
-	// get right vector 
-	const FVector RightDirection = FVector::CrossProduct(SurfaceNormal, -GetActorUpVector());
+	// get forward and right vectors on the surface plane
+	FVector ForwardDirection;
+	FVector RightDirection;
+	ClimbMath::GetClimbInputAxes(ClimbMovementComponent->GetClimbableSurfaceNormal(), GetActorRightVector(), GetActorUpVector(), ForwardDirection, RightDirection);
 
 	// add movement 
 	AddMovementInput(ForwardDirection, MovementVector.Y);
@@ -208,8 +333,24 @@ void APeakPursuitCharacter::Look(const FInputActionValue& Value)
 	}
 }
 
+void APeakPursuitCharacter::OnJumpActionTriggered(const FInputActionValue& Value)
+{
+	if (InputRecorder) { InputRecorder->RecordAction(FClimbInputFrame::JumpTriggered); }
+
+	Jump();
+}
+
+void APeakPursuitCharacter::OnJumpActionCompleted(const FInputActionValue& Value)
+{
+	if (InputRecorder) { InputRecorder->RecordAction(FClimbInputFrame::JumpCompleted); }
+
+	StopJumping();
+}
+
 void APeakPursuitCharacter::OnClimbActionStarted(const FInputActionValue& Value)
 {
+	if (InputRecorder) { InputRecorder->RecordAction(FClimbInputFrame::ClimbStarted); }
+
 	if (!ClimbMovementComponent){ return; }
 
 	ClimbMovementComponent->ToggleClimbing();
@@ -217,6 +358,8 @@ void APeakPursuitCharacter::OnClimbActionStarted(const FInputActionValue& Value)
 
 void APeakPursuitCharacter::OnClimbHopActionStarted(const FInputActionValue& Value)
 {
+	if (InputRecorder) { InputRecorder->RecordAction(FClimbInputFrame::HopStarted); }
+
 	if (!ClimbMovementComponent) { return; }
 
 	ClimbMovementComponent->RequestHoping();
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "InputActionValue.h"
+#include "Climb/ClimbInputRecording.h"
 #include "PeakPursuitCharacter.generated.h"
 
 
@@ -68,6 +69,15 @@ private:
 	void OnPlayerExitClimbState();
 	void AddInputMappingContext(UInputMappingContext* ContextToAdd, int32 InPriority);
 	void RemoveInputMappingContext(UInputMappingContext* ContextToRemove);
+
+	/** Climb LOD significance and never-skip state last handed to the animation budget allocator */
+	float AnimationSignificance = -1.0f;
+	bool bAnimationNeverSkip = false;
+
+	void UpdateAnimationBudget();
+
+	/** Set while climb.RecordInput is capturing this character's input */
+	TUniquePtr<FClimbInputRecorder> InputRecorder;
 	
 protected:
 	/** Called for movement input */
@@ -79,6 +89,8 @@ protected:
 	/** Called for looking input */
 	void Look(const FInputActionValue& Value);
 
+	void OnJumpActionTriggered(const FInputActionValue& Value);
+	void OnJumpActionCompleted(const FInputActionValue& Value);
 	void OnClimbActionStarted(const FInputActionValue& Value);
 	void OnClimbHopActionStarted(const FInputActionValue& Value);
 			
@@ -89,6 +101,8 @@ protected:
 	
 	// To add mapping context
 	virtual void BeginPlay();
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void Tick(float DeltaSeconds) override;
 
 public:
 	/** Returns CameraBoom subobject **/
@@ -99,5 +113,13 @@ public:
 	FORCEINLINE class UClimbMovementComponent* GetClimbMovementComponent() const { return ClimbMovementComponent; }
 	/** Returns Motion Warping Component subobject **/
 	FORCEINLINE class UMotionWarpingComponent* GetMotionWarpingComponent() const { return MotionWarpingComponent; }
+
+	/** Captures every input action and the control rotation, per frame, until StopInputRecording writes the file */
+	void StartInputRecording(const FString& Filename);
+	void StopInputRecording();
+	bool IsRecordingInput() const { return InputRecorder.IsValid(); }
+
+	/** Feeds one recorded frame through the same handlers as live input, used by the replay commandlet */
+	void ApplyRecordedInput(const FClimbInputFrame& Frame);
 };
 
@@ -2,8 +2,68 @@
 
 #include "PeakPursuitGameMode.h"
 #include "PeakPursuitCharacter.h"
+#include "PeakPursuit.h"
+#include "AI/ClimbSoakController.h"
+#include "Climb/ClimbSettings.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
 #include "UObject/ConstructorHelpers.h"
 
+namespace ClimbSoak
+{
+	//Frame times are bucketed at this resolution, anything slower than the last bucket lands in it
+	static constexpr double FrameBucketMs = 0.1;
+	static constexpr int32 NumFrameBuckets = 2500;
+
+	//Seconds between memory samples, progress logs and respawns of climbers that fell out of the world
+	static constexpr double SampleInterval = 10.0;
+
+	static double GetFramePercentileMs(const TArray<int32>& Histogram, int64 NumFrames, double Percentile)
+	{
+		const int64 Target = FMath::Max<int64>(FMath::CeilToInt64(NumFrames * Percentile), 1);
+		int64 Count = 0;
+
+		for (int32 Bucket = 0; Bucket < Histogram.Num(); Bucket++)
+		{
+			Count += Histogram[Bucket];
+			if (Count >= Target) { return (Bucket + 1) * FrameBucketMs; }
+		}
+
+		return Histogram.Num() * FrameBucketMs;
+	}
+
+	/** Least squares slope of the samples, in MB per second */
+	static double GetMemoryGrowth(const TArray<FVector2D>& Samples)
+	{
+		if (Samples.Num() < 2) { return 0.0; }
+
+		double MeanX = 0.0;
+		double MeanY = 0.0;
+		for (const FVector2D& Sample : Samples)
+		{
+			MeanX += Sample.X;
+			MeanY += Sample.Y;
+		}
+		MeanX /= Samples.Num();
+		MeanY /= Samples.Num();
+
+		double Covariance = 0.0;
+		double Variance = 0.0;
+		for (const FVector2D& Sample : Samples)
+		{
+			Covariance += (Sample.X - MeanX) * (Sample.Y - MeanY);
+			Variance += FMath::Square(Sample.X - MeanX);
+		}
+
+		return Variance > 0.0 ? Covariance / Variance : 0.0;
+	}
+}
+
 APeakPursuitGameMode::APeakPursuitGameMode()
 {
 	// set default pawn class to our Blueprinted character
@@ -12,4 +72,231 @@ APeakPursuitGameMode::APeakPursuitGameMode()
 	{
 		DefaultPawnClass = PlayerPawnBPClass.Class;
 	}
+
+	//Only soak runs tick, see StartPlay
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+}
+
+void APeakPursuitGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	const TCHAR* CommandLine = FCommandLine::Get();
+	bClimbSoak = FParse::Param(CommandLine, TEXT("ClimbSoak"));
+	if (!bClimbSoak) { return; }
+
+	SoakOutput = FPaths::ProjectSavedDir() / TEXT("ClimbSoak/ClimbSoak.csv");
+
+	FParse::Value(CommandLine, TEXT("SoakClimbers="), SoakClimbers);
+	FParse::Value(CommandLine, TEXT("SoakDuration="), SoakDuration);
+	FParse::Value(CommandLine, TEXT("SoakWarmup="), SoakWarmup);
+	FParse::Value(CommandLine, TEXT("SoakRadius="), SoakRadius);
+	FParse::Value(CommandLine, TEXT("SoakSeed="), SoakSeed);
+	FParse::Value(CommandLine, TEXT("SoakOutput="), SoakOutput);
+
+	//The soak picks its own pawn so the map and game mode defaults stay as they are for normal play
+	FString SoakPawnPath = GetDefault<UClimbSettings>()->ClimbCharacterClass.ToString();
+	FParse::Value(CommandLine, TEXT("SoakPawn="), SoakPawnPath);
+	SoakPawnClass = LoadClass<APeakPursuitCharacter>(nullptr, *SoakPawnPath);
+
+	SoakClimbers = FMath::Max(SoakClimbers, 1);
+	SoakWarmup = FMath::Max(SoakWarmup, 0.0f);
+}
+
+void APeakPursuitGameMode::StartPlay()
+{
+	Super::StartPlay();
+
+	if (!bClimbSoak) { return; }
+
+	if (!SoakPawnClass)
+	{
+		UE_LOG(LogClimb, Error, TEXT("Climb soak could not load a PeakPursuitCharacter pawn class, pass one with -SoakPawn="));
+		bClimbSoak = false;
+		FPlatformMisc::RequestExitWithStatus(false, 1);
+		return;
+	}
+
+	const AActor* PlayerStart = FindPlayerStart(nullptr);
+	const FVector Center = PlayerStart ? PlayerStart->GetActorLocation() : FVector::ZeroVector;
+	FRandomStream Random(SoakSeed);
+
+	for (int32 ClimberIndex = 0; ClimberIndex < SoakClimbers; ClimberIndex++)
+	{
+		//Homes spread evenly around the start so the climbers do not pile onto the same wall
+		const float Angle = 2.0f * PI * ClimberIndex / SoakClimbers;
+		const float Distance = SoakRadius * 0.5f * FMath::Sqrt(Random.FRand());
+
+		AClimbSoakController* SoakController = GetWorld()->SpawnActor<AClimbSoakController>();
+		SoakController->SetHome(Center + FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f) * Distance, SoakRadius);
+		SoakController->SetRandomSeed(Random.RandHelper(MAX_int32));
+		SoakControllers.Add(SoakController);
+
+		SpawnSoakClimber(SoakController);
+	}
+
+	FrameHistogram.SetNumZeroed(ClimbSoak::NumFrameBuckets);
+	MemorySamples.Reserve(FMath::CeilToInt32(SoakDuration / ClimbSoak::SampleInterval) + 2);
+
+	SoakStartTime = FPlatformTime::Seconds();
+	LastFrameTime = SoakStartTime;
+	SetActorTickEnabled(true);
+
+	UE_LOG(LogClimb, Display, TEXT("Climb soak: %d climbers around %s for %.0fs after %.0fs of warmup, summary to %s"),
+		SoakControllers.Num(), *Center.ToString(), SoakDuration, SoakWarmup, *SoakOutput);
+}
+
+void APeakPursuitGameMode::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (!bClimbSoak) { return; }
+
+	//Wall clock, the world delta is clamped on hitches and those are what the soak is looking for
+	const double Now = FPlatformTime::Seconds();
+	SampleSoak(Now, Now - LastFrameTime);
+	LastFrameTime = Now;
+
+	if (Now - SoakStartTime >= SoakWarmup + SoakDuration)
+	{
+		FinishSoak();
+	}
+}
+
+bool APeakPursuitGameMode::SpawnSoakClimber(AClimbSoakController* SoakController)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButDontSpawnIfColliding;
+
+	const FRotator Rotation(0.0f, FMath::FRandRange(-180.0f, 180.0f), 0.0f);
+	APawn* Climber = GetWorld()->SpawnActor<APawn>(SoakPawnClass, SoakController->GetHome(), Rotation, SpawnParams);
+
+	if (!Climber)
+	{
+		UE_LOG(LogClimb, Warning, TEXT("Could not spawn a soak climber at %s"), *SoakController->GetHome().ToString());
+		return false;
+	}
+
+	SoakController->Possess(Climber);
+	return true;
+}
+
+void APeakPursuitGameMode::SampleSoak(double Now, double FrameSeconds)
+{
+	const double SampleTime = Now - SoakStartTime - SoakWarmup;
+
+	if (!bSoakWarmedUp)
+	{
+		if (SampleTime < 0.0) { return; }
+
+		//Everything before this point is montage streaming and climbers spreading out
+		bSoakWarmedUp = true;
+		NextMemorySampleTime = Now;
+		for (AClimbSoakController* SoakController : SoakControllers)
+		{
+			SoakController->ResetSoakStats();
+		}
+	}
+
+	const double FrameMs = FrameSeconds * 1000.0;
+	FrameHistogram[FMath::Min(FMath::FloorToInt32(FrameMs / ClimbSoak::FrameBucketMs), FrameHistogram.Num() - 1)]++;
+	MaxFrameMs = FMath::Max(MaxFrameMs, FrameMs);
+	TotalFrameMs += FrameMs;
+	NumFrames++;
+
+	if (Now < NextMemorySampleTime) { return; }
+	NextMemorySampleTime += ClimbSoak::SampleInterval;
+
+	const double MemoryMB = FPlatformMemory::GetStats().UsedPhysical / (1024.0 * 1024.0);
+	PeakMemoryMB = FMath::Max(PeakMemoryMB, MemoryMB);
+	MemorySamples.Add(FVector2D(SampleTime, MemoryMB));
+
+	int32 NumStuck = 0;
+	for (AClimbSoakController* SoakController : SoakControllers)
+	{
+		//Climbers that fell out of the world were destroyed, put a new one at home
+		if (!SoakController->GetPawn() && SpawnSoakClimber(SoakController))
+		{
+			SoakController->AddRespawn();
+		}
+
+		NumStuck += SoakController->GetSoakStats().StuckEvents;
+	}
+
+	UE_LOG(LogClimb, Display, TEXT("Climb soak %.0f/%.0fs: frame %.2fms mean, %.2fms max, %.1f MB used, %d stuck"),
+		SampleTime, SoakDuration, TotalFrameMs / NumFrames, MaxFrameMs, MemoryMB, NumStuck);
+}
+
+void APeakPursuitGameMode::FinishSoak()
+{
+	bClimbSoak = false;
+	SetActorTickEnabled(false);
+
+	FClimbSoakStats Totals;
+	int32 StuckClimbers = 0;
+
+	for (AClimbSoakController* SoakController : SoakControllers)
+	{
+		const FClimbSoakStats& Stats = SoakController->GetSoakStats();
+		Totals.Queries += Stats.Queries;
+		Totals.MontageFailures += Stats.MontageFailures;
+		Totals.StuckEvents += Stats.StuckEvents;
+		Totals.Respawns += Stats.Respawns;
+		for (int32 StateIndex = 0; StateIndex < (int32)EClimbState::Num; StateIndex++)
+		{
+			Totals.StateEntries[StateIndex] += Stats.StateEntries[StateIndex];
+		}
+
+		if (Stats.StuckEvents > 0) { StuckClimbers++; }
+	}
+
+	const double Seconds = LastFrameTime - SoakStartTime - SoakWarmup;
+	const int64 SafeNumFrames = FMath::Max<int64>(NumFrames, 1);
+	const double MemoryStartMB = MemorySamples.Num() > 0 ? MemorySamples[0].Y : 0.0;
+	const double MemoryEndMB = MemorySamples.Num() > 0 ? MemorySamples.Last().Y : 0.0;
+	const double MemoryGrowthPerHour = ClimbSoak::GetMemoryGrowth(MemorySamples) * 3600.0;
+
+	FString Header = TEXT("Timestamp,Map,Climbers,Seconds,Frames,FrameMsMean,FrameMsP50,FrameMsP95,FrameMsP99,FrameMsMax,")
+		TEXT("MemoryStartMB,MemoryEndMB,MemoryPeakMB,MemoryGrowthMBPerHour,ClimbQueries,ClimbQueriesPerClimberFrame,")
+		TEXT("StuckClimbers,StuckEvents,MontageFailures,Respawns");
+
+	FString Row = FString::Printf(TEXT("%s,%s,%d,%.1f,%lld,%.3f,%.3f,%.3f,%.3f,%.3f,%.1f,%.1f,%.1f,%.2f,%lld,%.3f,%d,%d,%d,%d"),
+		*FDateTime::UtcNow().ToIso8601(), *GetWorld()->GetMapName(), SoakControllers.Num(), Seconds, NumFrames,
+		TotalFrameMs / SafeNumFrames,
+		ClimbSoak::GetFramePercentileMs(FrameHistogram, NumFrames, 0.5),
+		ClimbSoak::GetFramePercentileMs(FrameHistogram, NumFrames, 0.95),
+		ClimbSoak::GetFramePercentileMs(FrameHistogram, NumFrames, 0.99),
+		MaxFrameMs,
+		MemoryStartMB, MemoryEndMB, PeakMemoryMB, MemoryGrowthPerHour,
+		Totals.Queries, (double)Totals.Queries / (SafeNumFrames * FMath::Max(SoakControllers.Num(), 1)),
+		StuckClimbers, Totals.StuckEvents, Totals.MontageFailures, Totals.Respawns);
+
+	for (int32 StateIndex = 0; StateIndex < (int32)EClimbState::Num; StateIndex++)
+	{
+		Header += FString::Printf(TEXT(",Entered%s"), ClimbStateMachine::GetStateName((EClimbState)StateIndex));
+		Row += FString::Printf(TEXT(",%d"), Totals.StateEntries[StateIndex]);
+	}
+
+	//One row per run, appended so nightly runs can be compared from a single file
+	const FString Csv = IFileManager::Get().FileExists(*SoakOutput) ? Row + TEXT("\n") : Header + TEXT("\n") + Row + TEXT("\n");
+	const bool bSaved = FFileHelper::SaveStringToFile(Csv, *SoakOutput, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+
+	if (!bSaved)
+	{
+		UE_LOG(LogClimb, Error, TEXT("Failed to write %s"), *SoakOutput);
+	}
+
+	UE_LOG(LogClimb, Display, TEXT("Climb soak done after %.0fs: frame p99 %.2fms, memory %+.1f MB/h, %lld climb queries, %d stuck climbers, %d montage failures"),
+		Seconds, ClimbSoak::GetFramePercentileMs(FrameHistogram, NumFrames, 0.99), MemoryGrowthPerHour, Totals.Queries, StuckClimbers, Totals.MontageFailures);
+
+	//No climbing at all means the climbers never found a wall, not that climbing is healthy
+	const bool bNeverClimbed = Totals.StateEntries[(int32)EClimbState::Climbing] == 0;
+	if (bNeverClimbed)
+	{
+		UE_LOG(LogClimb, Error, TEXT("Climb soak: no climber entered the climbing state"));
+	}
+
+	const bool bFailed = !bSaved || Totals.StuckEvents > 0 || Totals.MontageFailures > 0 || bNeverClimbed;
+	FPlatformMisc::RequestExitWithStatus(false, bFailed ? 1 : 0);
 }
@@ -6,6 +6,18 @@
 #include "GameFramework/GameModeBase.h"
 #include "PeakPursuitGameMode.generated.h"
 
+class AClimbSoakController;
+class APeakPursuitCharacter;
+
+/**
+ * Passing -ClimbSoak runs a soak test instead of normal play: AI climbers roam the map climbing, hopping, vaulting and
+ * mantling for a set duration, then a CSV summary row is appended to the output and the game exits, with code 1 when
+ * any climber got stuck, a montage failed or no climber ever climbed.
+ * The project default BP_PeakPursuit_GameMode is not one of these, so the map URL has to pick this game mode with ?game=
+ * Climbers spawn as UClimbSettings::ClimbCharacterClass unless -SoakPawn= names another PeakPursuitCharacter class.
+ * UnrealEditor PeakPursuit.uproject /Game/ThirdPerson/Maps/ThirdPersonMap?game=/Script/PeakPursuit.PeakPursuitGameMode -game -nullrhi -nosound -unattended -ClimbSoak
+ *     [-SoakClimbers=32] [-SoakDuration=3600] [-SoakWarmup=30] [-SoakRadius=1500] [-SoakSeed=0] [-SoakPawn=/Game/PeakPursuit/Pawns/BP_PeakPursuitCharacter.BP_PeakPursuitCharacter_C] [-SoakOutput=Saved/ClimbSoak/ClimbSoak.csv]
+ */
 UCLASS(minimalapi)
 class APeakPursuitGameMode : public AGameModeBase
 {
@@ -13,6 +25,45 @@ class APeakPursuitGameMode : public AGameModeBase
 
 public:
 	APeakPursuitGameMode();
+
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+	virtual void StartPlay() override;
+	virtual void Tick(float DeltaSeconds) override;
+
+private:
+	bool SpawnSoakClimber(AClimbSoakController* SoakController);
+	void SampleSoak(double Now, double FrameSeconds);
+	void FinishSoak();
+
+	bool bClimbSoak = false;
+	int32 SoakClimbers = 32;
+	float SoakDuration = 3600.0f;
+	/** Seconds left out of the stats while montages stream in and the climbers spread out */
+	float SoakWarmup = 30.0f;
+	float SoakRadius = 1500.0f;
+	int32 SoakSeed = 0;
+	FString SoakOutput;
+
+	UPROPERTY(Transient)
+	TSubclassOf<APeakPursuitCharacter> SoakPawnClass;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AClimbSoakController>> SoakControllers;
+
+	double SoakStartTime = 0.0;
+	double LastFrameTime = 0.0;
+	double NextMemorySampleTime = 0.0;
+	bool bSoakWarmedUp = false;
+
+	/** Frame times in fixed buckets so hours of frames take no more memory than the first one */
+	TArray<int32> FrameHistogram;
+	double MaxFrameMs = 0.0;
+	double TotalFrameMs = 0.0;
+	int64 NumFrames = 0;
+
+	/** Used physical memory, in MB against seconds since the warmup ended */
+	TArray<FVector2D> MemorySamples;
+	double PeakMemoryMB = 0.0;
 };
 
 
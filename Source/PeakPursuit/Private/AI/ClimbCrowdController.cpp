@@ -0,0 +1,33 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "AI/ClimbCrowdController.h"
+#include "PeakPursuitCharacter.h"
+#include "Components/ClimbMovementComponent.h"
+
+
+AClimbCrowdController::AClimbCrowdController()
+{
+    PrimaryActorTick.bCanEverTick = true;
+    bWantsPlayerState = false;
+}
+
+
+void AClimbCrowdController::Tick(float DeltaSeconds)
+{
+    Super::Tick(DeltaSeconds);
+
+    APeakPursuitCharacter* Climber = Cast<APeakPursuitCharacter>(GetPawn());
+    const UClimbMovementComponent* Movement = Climber ? Climber->GetClimbMovementComponent() : nullptr;
+    if (!Movement) { return; }
+
+    //Climbers stay on their surface like the Mass simulation keeps them, walkers on the ground
+    const FVector PlaneNormal = Movement->IsClimbing() ? Movement->GetClimbableSurfaceNormal() : FVector::UpVector;
+    const FVector Desired = FVector::VectorPlaneProject(DesiredVelocity, PlaneNormal);
+    const float MaxSpeed = Movement->GetMaxSpeed();
+
+    if (Desired.IsNearlyZero() || MaxSpeed <= 0.0f) { return; }
+
+    //Same input a player holding the stick towards the velocity would give, the movement component does the rest
+    Climber->AddMovementInput(Desired.GetSafeNormal(), FMath::Min(Desired.Size() / MaxSpeed, 1.0f));
+}
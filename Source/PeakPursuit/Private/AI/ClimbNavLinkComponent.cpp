@@ -0,0 +1,51 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "AI/ClimbNavLinkComponent.h"
+#include "PeakPursuit/PeakPursuit.h"
+#include "AI/ClimbRouteFollowerComponent.h"
+#include "Subsystems/ClimbGraphSubsystem.h"
+#include "Navigation/PathFollowingComponent.h"
+#include "AIController.h"
+
+
+void UClimbNavLinkComponent::SetRoute(int32 InFromNode, int32 InToNode, const FVector& FromLocation, const FVector& ToLocation)
+{
+    FromNode = InFromNode;
+    ToNode = InToNode;
+    SetLinkData(FromLocation, ToLocation, ENavLinkDirection::LeftToRight);
+}
+
+
+bool UClimbNavLinkComponent::OnLinkMoveStarted(UObject* PathComp, const FVector& DestPoint)
+{
+    UPathFollowingComponent* PathFollowing = Cast<UPathFollowingComponent>(PathComp);
+    const AAIController* Controller = PathFollowing ? Cast<AAIController>(PathFollowing->GetOwner()) : nullptr;
+    UClimbRouteFollowerComponent* RouteFollower = Controller ? Controller->FindComponentByClass<UClimbRouteFollowerComponent>() : nullptr;
+    UClimbGraphSubsystem* ClimbGraphSubsystem = GetWorld()->GetSubsystem<UClimbGraphSubsystem>();
+
+    FClimbGraphPath Path;
+    if (!RouteFollower || !ClimbGraphSubsystem || !ClimbGraphSubsystem->FindPath(FromNode, ToNode, Path))
+    {
+        return Super::OnLinkMoveStarted(PathComp, DestPoint);
+    }
+
+    //Path following waits on the link until the climber is back on the ground
+    TWeakObjectPtr<UPathFollowingComponent> WeakPathFollowing = PathFollowing;
+    RouteFollower->FollowPath(Path, FOnClimbRouteFinished::CreateWeakLambda(this, [this, WeakPathFollowing](bool bSuccess)
+    {
+        UPathFollowingComponent* FinishedPathFollowing = WeakPathFollowing.Get();
+        if (!FinishedPathFollowing) { return; }
+
+        if (bSuccess)
+        {
+            FinishedPathFollowing->FinishUsingCustomLink(this);
+        }
+        else
+        {
+            FinishedPathFollowing->AbortMove(*this, FPathFollowingResultFlags::MovementStop);
+        }
+    }));
+
+    return true;
+}
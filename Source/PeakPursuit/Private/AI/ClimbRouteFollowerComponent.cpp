@@ -0,0 +1,238 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "AI/ClimbRouteFollowerComponent.h"
+#include "PeakPursuit/PeakPursuit.h"
+#include "PeakPursuitCharacter.h"
+#include "Components/ClimbMovementComponent.h"
+#include "Climb/ClimbInputRecording.h"
+#include "Climb/ClimbMath.h"
+#include "GameFramework/Controller.h"
+
+
+UClimbRouteFollowerComponent::UClimbRouteFollowerComponent()
+{
+    PrimaryComponentTick.bCanEverTick = true;
+    PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+
+void UClimbRouteFollowerComponent::FollowPath(const FClimbGraphPath& InPath, FOnClimbRouteFinished InOnFinished)
+{
+    AbortPath();
+
+    Path = InPath;
+    OnFinished = MoveTemp(InOnFinished);
+    TargetIndex = 1;
+    LinkTime = 0.0f;
+    bActionPressed = false;
+    bActionStarted = false;
+
+    if (!IsFollowingPath())
+    {
+        Finish(Path.Points.Num() == 1);
+        return;
+    }
+
+    SetComponentTickEnabled(true);
+}
+
+
+void UClimbRouteFollowerComponent::AbortPath()
+{
+    if (IsFollowingPath())
+    {
+        Finish(false);
+    }
+}
+
+
+void UClimbRouteFollowerComponent::Finish(bool bSuccess)
+{
+    //The callback may start the next path right away
+    FOnClimbRouteFinished FinishedDelegate = MoveTemp(OnFinished);
+    OnFinished.Unbind();
+    TargetIndex = INDEX_NONE;
+    Path.Reset();
+    SetComponentTickEnabled(false);
+
+    FinishedDelegate.ExecuteIfBound(bSuccess);
+}
+
+
+void UClimbRouteFollowerComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    if (!IsFollowingPath()) { return; }
+
+    const AController* Controller = GetOwner<AController>();
+    APeakPursuitCharacter* Climber = Controller ? Cast<APeakPursuitCharacter>(Controller->GetPawn()) : nullptr;
+    const UClimbMovementComponent* Movement = Climber ? Climber->GetClimbMovementComponent() : nullptr;
+
+    if (!Movement)
+    {
+        Finish(false);
+        return;
+    }
+
+    LinkTime += DeltaTime;
+    if (bActionPressed && Movement->IsPlayingClimbMontage()) { bActionStarted = true; }
+
+    const EClimbGraphLinkType LinkType = Path.Points[TargetIndex].LinkType;
+    const bool bActionNeverStarted = bActionPressed && !bActionStarted && LinkTime - ActionPressedTime > ActionStartTimeout;
+
+    if (LinkTime > LinkTimeout || bActionNeverStarted)
+    {
+        UE_LOG(LogClimb, Warning, TEXT("%s gave up the %s link to climb graph node %d at %s"), *GetNameSafe(Climber),
+            *StaticEnum<EClimbGraphLinkType>()->GetNameStringByValue((int64)LinkType), Path.Points[TargetIndex].Node, *Climber->GetActorLocation().ToCompactString());
+        Finish(false);
+        return;
+    }
+
+    FClimbInputFrame Frame;
+    Frame.DeltaTime = DeltaTime;
+
+    const ELinkProgress Progress = UpdateLink(*Climber, *Movement, Frame);
+
+    if (Frame.Flags != 0)
+    {
+        Climber->ApplyRecordedInput(Frame);
+    }
+
+    if (Progress == ELinkProgress::Failed)
+    {
+        Finish(false);
+    }
+    else if (Progress == ELinkProgress::Done)
+    {
+        TargetIndex++;
+        LinkTime = 0.0f;
+        bActionPressed = false;
+        bActionStarted = false;
+
+        if (!IsFollowingPath())
+        {
+            Finish(true);
+        }
+    }
+}
+
+
+UClimbRouteFollowerComponent::ELinkProgress UClimbRouteFollowerComponent::UpdateAction(const UClimbMovementComponent& Movement, bool bEndsClimbing) const
+{
+    //Actions are over once their montage blended out and left the climber in the mode the link leads to
+    if (!bActionStarted || Movement.IsPlayingClimbMontage()) { return ELinkProgress::InProgress; }
+
+    return Movement.IsClimbing() != bEndsClimbing ? ELinkProgress::Done : ELinkProgress::Failed;
+}
+
+
+UClimbRouteFollowerComponent::ELinkProgress UClimbRouteFollowerComponent::UpdateLink(APeakPursuitCharacter& Climber, const UClimbMovementComponent& Movement, FClimbInputFrame& Frame)
+{
+    const FClimbGraphPathPoint& From = Path.Points[TargetIndex - 1];
+    const FClimbGraphPathPoint& To = Path.Points[TargetIndex];
+
+    auto PressAction = [this, &Frame](FClimbInputFrame::EFlags Action)
+    {
+        Frame.Flags |= Action;
+        bActionPressed = true;
+        ActionPressedTime = LinkTime;
+    };
+
+    auto SetClimbMove = [&Frame](const FVector2f& Value)
+    {
+        Frame.Flags |= FClimbInputFrame::ClimbMove;
+        Frame.ClimbMoveValue = Value;
+    };
+
+    switch (To.LinkType)
+    {
+    case EClimbGraphLinkType::Climb:
+    {
+        if (!Movement.IsClimbing()) { return ELinkProgress::Failed; }
+
+        const FVector ToTarget = To.Location - Climber.GetActorLocation();
+        if (ToTarget.SizeSquared() <= FMath::Square(AcceptanceRadius)) { return ELinkProgress::Done; }
+
+        //Same surface plane axes the climb input is applied along
+        FVector ForwardDirection;
+        FVector RightDirection;
+        ClimbMath::GetClimbInputAxes(Movement.GetClimbableSurfaceNormal(), Climber.GetActorRightVector(), Climber.GetActorUpVector(), ForwardDirection, RightDirection);
+
+        const FVector2f Input(FVector::DotProduct(ToTarget, RightDirection), FVector::DotProduct(ToTarget, ForwardDirection));
+        SetClimbMove(Input.GetSafeNormal());
+        return ELinkProgress::InProgress;
+    }
+
+    case EClimbGraphLinkType::HopUp:
+    case EClimbGraphLinkType::HopDown:
+    {
+        if (bActionPressed) { return UpdateAction(Movement, false); }
+        if (!Movement.IsClimbing()) { return ELinkProgress::Failed; }
+
+        //The hop direction is read from the climb input of the same move
+        SetClimbMove(FVector2f(0.0f, To.LinkType == EClimbGraphLinkType::HopUp ? 1.0f : -1.0f));
+        PressAction(FClimbInputFrame::HopStarted);
+        return ELinkProgress::InProgress;
+    }
+
+    case EClimbGraphLinkType::Mantle:
+    {
+        //Climbing up until the ledge check starts the climb to top montage
+        if (Movement.IsPlayingClimbMontage() && !bActionPressed)
+        {
+            bActionPressed = true;
+            bActionStarted = true;
+        }
+
+        if (bActionStarted) { return UpdateAction(Movement, true); }
+        if (!Movement.IsClimbing()) { return ELinkProgress::Failed; }
+
+        SetClimbMove(FVector2f(0.0f, 1.0f));
+        return ELinkProgress::InProgress;
+    }
+
+    case EClimbGraphLinkType::Drop:
+    {
+        if (Movement.IsMovingOnGround()) { return ELinkProgress::Done; }
+
+        if (Movement.IsClimbing())
+        {
+            SetClimbMove(FVector2f(0.0f, -1.0f));
+        }
+
+        return ELinkProgress::InProgress;
+    }
+
+    case EClimbGraphLinkType::ClimbStart:
+    case EClimbGraphLinkType::ClimbDownLedge:
+    case EClimbGraphLinkType::Vault:
+    {
+        if (bActionPressed) { return UpdateAction(Movement, To.LinkType == EClimbGraphLinkType::Vault); }
+        if (!Movement.IsMovingOnGround()) { return ELinkProgress::InProgress; }
+
+        FVector ToStart = From.Location - Climber.GetActorLocation();
+        ToStart.Z = 0.0f;
+
+        if (ToStart.SizeSquared() > FMath::Square(AcceptanceRadius))
+        {
+            Climber.AddMovementInput(ToStart.GetSafeNormal());
+            return ELinkProgress::InProgress;
+        }
+
+        //The checks look along the capsule, which orients to movement on the ground
+        const FVector Facing = FVector(To.Location.X - From.Location.X, To.Location.Y - From.Location.Y, 0.0f);
+        if (!Facing.IsNearlyZero())
+        {
+            Climber.SetActorRotation(FRotator(0.0f, Facing.Rotation().Yaw, 0.0f));
+        }
+
+        PressAction(FClimbInputFrame::ClimbStarted);
+        return ELinkProgress::InProgress;
+    }
+
+    default:
+        return ELinkProgress::Failed;
+    }
+}
@@ -0,0 +1,194 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "AI/ClimbSoakController.h"
+#include "PeakPursuit/PeakPursuit.h"
+#include "PeakPursuitCharacter.h"
+#include "Components/ClimbMovementComponent.h"
+#include "Climb/ClimbInputRecording.h"
+
+namespace ClimbSoak
+{
+    static constexpr float MinDecisionTime = 0.5f;
+    static constexpr float MaxDecisionTime = 2.0f;
+
+    //Moving less than this with climb input held counts towards stuck
+    static constexpr float StuckDistance = 5.0f;
+
+    //Chances per decision, the rest of the time a new direction is picked
+    static constexpr float ReleaseChance = 0.15f;
+    static constexpr float HopChance = 0.25f;
+    static constexpr float ClimbChance = 0.6f;
+    static constexpr float JumpChance = 0.1f;
+}
+
+
+AClimbSoakController::AClimbSoakController()
+{
+    PrimaryActorTick.bCanEverTick = true;
+    bWantsPlayerState = false;
+}
+
+
+void AClimbSoakController::OnPossess(APawn* InPawn)
+{
+    Super::OnPossess(InPawn);
+
+    //A new pawn counts its queries and failures from zero
+    LastQueries = 0;
+    LastMontageFailures = 0;
+    LastState = EClimbState::Idle;
+    TimeInState = 0.0f;
+    TimeWithoutMoving = 0.0f;
+    TimeToDecide = 0.0f;
+    StuckCheckLocation = InPawn ? InPawn->GetActorLocation() : FVector::ZeroVector;
+}
+
+
+void AClimbSoakController::Tick(float DeltaSeconds)
+{
+    Super::Tick(DeltaSeconds);
+
+    APeakPursuitCharacter* Climber = Cast<APeakPursuitCharacter>(GetPawn());
+    UClimbMovementComponent* Movement = Climber ? Climber->GetClimbMovementComponent() : nullptr;
+    if (!Movement) { return; }
+
+    UpdateSoakStats(*Movement, DeltaSeconds);
+
+    if (UpdateStuck(*Movement, DeltaSeconds))
+    {
+        //Let go and try somewhere else
+        if (Movement->IsClimbing()) { PendingActions |= FClimbInputFrame::ClimbStarted; }
+        TimeToDecide = 0.0f;
+    }
+
+    TimeToDecide -= DeltaSeconds;
+    if (TimeToDecide <= 0.0f)
+    {
+        Decide(*Movement);
+    }
+
+    FClimbInputFrame Frame;
+    Frame.DeltaTime = DeltaSeconds;
+    Frame.Flags = PendingActions;
+
+    if (Movement->IsClimbing())
+    {
+        Frame.Flags |= FClimbInputFrame::ClimbMove;
+        Frame.ClimbMoveValue = ClimbMoveValue;
+    }
+    else
+    {
+        Frame.Flags |= FClimbInputFrame::GroundMove;
+        Frame.GroundMoveValue = GroundMoveValue;
+    }
+
+    Climber->ApplyRecordedInput(Frame);
+
+    //Releasing jump in the frame it was pressed would cancel it
+    PendingActions = Frame.HasFlag(FClimbInputFrame::JumpTriggered) ? FClimbInputFrame::JumpCompleted : 0;
+}
+
+
+void AClimbSoakController::Decide(const UClimbMovementComponent& Movement)
+{
+    TimeToDecide = Random.FRandRange(ClimbSoak::MinDecisionTime, ClimbSoak::MaxDecisionTime);
+
+    if (Movement.IsClimbing())
+    {
+        const float Roll = Random.FRand();
+
+        if (Roll < ClimbSoak::ReleaseChance)
+        {
+            PendingActions |= FClimbInputFrame::ClimbStarted;
+            return;
+        }
+
+        if (Roll < ClimbSoak::ReleaseChance + ClimbSoak::HopChance)
+        {
+            PendingActions |= FClimbInputFrame::HopStarted;
+        }
+
+        //Mostly up so the climbers reach ledges and mantle
+        const float Direction = Random.FRand();
+        if (Direction < 0.5f) { ClimbMoveValue = FVector2f(0.0f, 1.0f); }
+        else if (Direction < 0.65f) { ClimbMoveValue = FVector2f(1.0f, 0.0f); }
+        else if (Direction < 0.8f) { ClimbMoveValue = FVector2f(-1.0f, 0.0f); }
+        else { ClimbMoveValue = FVector2f(0.0f, -1.0f); }
+        return;
+    }
+
+    //Walk towards a new goal around home, the focus turns the control rotation towards it
+    const float Angle = Random.FRandRange(0.0f, 2.0f * PI);
+    const float Distance = RoamRadius * FMath::Sqrt(Random.FRand());
+    SetFocalPoint(Home + FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f) * Distance);
+    GroundMoveValue = FVector2f(0.0f, 1.0f);
+
+    //Climbs, vaults or climbs down wherever the climber happens to be, a miss costs a few probes
+    if (Random.FRand() < ClimbSoak::ClimbChance) { PendingActions |= FClimbInputFrame::ClimbStarted; }
+    if (Random.FRand() < ClimbSoak::JumpChance) { PendingActions |= FClimbInputFrame::JumpTriggered; }
+}
+
+
+void AClimbSoakController::UpdateSoakStats(const UClimbMovementComponent& Movement, float DeltaSeconds)
+{
+    const int32 Queries = Movement.GetClimbQuery().GetNumQueries();
+    SoakStats.Queries += Queries - LastQueries;
+    LastQueries = Queries;
+
+    const int32 MontageFailures = Movement.GetNumClimbActionFailures();
+    SoakStats.MontageFailures += MontageFailures - LastMontageFailures;
+    LastMontageFailures = MontageFailures;
+
+    const EClimbState State = Movement.GetClimbStateMachine().GetState();
+    if (State != LastState)
+    {
+        SoakStats.StateEntries[(int32)State]++;
+        LastState = State;
+        TimeInState = 0.0f;
+    }
+    else
+    {
+        TimeInState += DeltaSeconds;
+    }
+}
+
+
+bool AClimbSoakController::UpdateStuck(const UClimbMovementComponent& Movement, float DeltaSeconds)
+{
+    const FVector Location = GetPawn()->GetActorLocation();
+
+    if (Movement.IsClimbing() && !ClimbMoveValue.IsNearlyZero()
+        && FVector::DistSquared(Location, StuckCheckLocation) < FMath::Square(ClimbSoak::StuckDistance))
+    {
+        TimeWithoutMoving += DeltaSeconds;
+    }
+    else
+    {
+        TimeWithoutMoving = 0.0f;
+        StuckCheckLocation = Location;
+    }
+
+    //Actions end when their montage blends out, one lasting this long never did
+    const EClimbState State = Movement.GetClimbStateMachine().GetState();
+    const bool bStuckInAction = State != EClimbState::Idle && State != EClimbState::Climbing && TimeInState > StuckTime;
+
+    if (!bStuckInAction && TimeWithoutMoving <= StuckTime) { return false; }
+
+    SoakStats.StuckEvents++;
+    TimeWithoutMoving = 0.0f;
+    TimeInState = 0.0f;
+
+    UE_LOG(LogClimb, Warning, TEXT("%s stuck %s at %s"), *GetNameSafe(GetPawn()),
+        bStuckInAction ? ClimbStateMachine::GetStateName(State) : TEXT("climbing without moving"), *Location.ToString());
+
+    TArray<FClimbStateTransitionRecord> History;
+    Movement.GetClimbStateMachine().GetHistory(History);
+    for (const FClimbStateTransitionRecord& Record : History)
+    {
+        UE_LOG(LogClimb, Warning, TEXT("    %.3f: %s -> %s on %s"), Record.Time,
+            ClimbStateMachine::GetStateName(Record.From), ClimbStateMachine::GetStateName(Record.To), ClimbStateMachine::GetEventName(Record.Event));
+    }
+
+    return true;
+}
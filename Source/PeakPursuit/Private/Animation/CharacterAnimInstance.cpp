@@ -4,7 +4,6 @@
 #include "Animation/CharacterAnimInstance.h"
 #include "PeakPursuit/PeakPursuitCharacter.h"
 #include "Components/ClimbMovementComponent.h"
-#include "Kismet/KismetMathLibrary.h"
 
 void UCharacterAnimInstance::NativeInitializeAnimation()
 {
@@ -25,6 +24,15 @@ void UCharacterAnimInstance::NativeUpdateAnimation(float DeltaSeconds)
 
     if (!IsValid(MyCharacter) || !ClimbMovementComponent) { return; }
 
+    //Only game thread work, NativeThreadSafeUpdateAnimation reads this copy
+    Snapshot = ClimbMovementComponent->GetAnimSnapshot();
+}
+
+
+void UCharacterAnimInstance::NativeThreadSafeUpdateAnimation(float DeltaSeconds)
+{
+    Super::NativeThreadSafeUpdateAnimation(DeltaSeconds);
+
     GetGroundSpeed();
     GetAirSpeed();
     GetShouldMove();
@@ -36,36 +44,34 @@ void UCharacterAnimInstance::NativeUpdateAnimation(float DeltaSeconds)
 
 void UCharacterAnimInstance::GetGroundSpeed()
 {
-    GroundSpeed = UKismetMathLibrary::VSizeXY(MyCharacter->GetVelocity());
+    GroundSpeed = Snapshot.GroundSpeed;
 }
 
 
 void UCharacterAnimInstance::GetAirSpeed()
 {
-    AirSpeed = MyCharacter->GetVelocity().Z;
+    AirSpeed = Snapshot.AirSpeed;
 }
 
 
 void UCharacterAnimInstance::GetShouldMove()
 {
-    bool IsAccelerating = ClimbMovementComponent->GetCurrentAcceleration().Size() > 0.0;
-
-    bShouldMove = IsAccelerating && GroundSpeed > 5.0f && !bIsFalling;
+    bShouldMove = Snapshot.bIsAccelerating && GroundSpeed > 5.0f && !bIsFalling;
 }
 
 
 void UCharacterAnimInstance::GetIsFalling()
 {
-    bIsFalling = ClimbMovementComponent->IsFalling();
+    bIsFalling = Snapshot.bIsFalling;
 }
 
 
 void UCharacterAnimInstance::GetIsClimbing()
 {
-    bIsClimbing = ClimbMovementComponent->IsClimbing();
+    bIsClimbing = Snapshot.bIsClimbing;
 }
 
 void UCharacterAnimInstance::GetClimbVelocity()
 {
-    ClimbVelocity = ClimbMovementComponent->GetUnrotatedClimbVelocity();
+    ClimbVelocity = Snapshot.ClimbVelocity;
 }
@@ -0,0 +1,264 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Climb/ClimbAABBTree.h"
+
+
+FClimbAABBTree::FClimbAABBTree(float InFatMargin)
+    : FatMargin(InFatMargin)
+{
+}
+
+
+void FClimbAABBTree::Reset()
+{
+    Nodes.Reset();
+    Root = INDEX_NONE;
+    FreeList = INDEX_NONE;
+    NumProxies = 0;
+}
+
+
+double FClimbAABBTree::GetSurfaceArea(const FBox& Box)
+{
+    const FVector Size = Box.GetSize();
+    return 2.0 * (Size.X * Size.Y + Size.Y * Size.Z + Size.Z * Size.X);
+}
+
+
+int32 FClimbAABBTree::AllocateNode()
+{
+    if (FreeList == INDEX_NONE)
+    {
+        return Nodes.AddDefaulted();
+    }
+
+    const int32 NodeIndex = FreeList;
+    FreeList = Nodes[NodeIndex].Parent;
+    Nodes[NodeIndex] = FNode();
+    return NodeIndex;
+}
+
+
+void FClimbAABBTree::FreeNode(int32 NodeIndex)
+{
+    FNode& Node = Nodes[NodeIndex];
+    Node.Parent = FreeList;
+    Node.Height = INDEX_NONE;
+    FreeList = NodeIndex;
+}
+
+
+int32 FClimbAABBTree::CreateProxy(const FBox& Bounds, int32 UserData)
+{
+    const int32 ProxyId = AllocateNode();
+    FNode& Leaf = Nodes[ProxyId];
+    Leaf.Bounds = Bounds.ExpandBy(FatMargin);
+    Leaf.UserData = UserData;
+    Leaf.Height = 0;
+
+    InsertLeaf(ProxyId);
+    NumProxies++;
+
+    return ProxyId;
+}
+
+
+void FClimbAABBTree::DestroyProxy(int32 ProxyId)
+{
+    check(Nodes.IsValidIndex(ProxyId) && Nodes[ProxyId].IsLeaf() && Nodes[ProxyId].Height == 0);
+
+    RemoveLeaf(ProxyId);
+    FreeNode(ProxyId);
+    NumProxies--;
+}
+
+
+bool FClimbAABBTree::MoveProxy(int32 ProxyId, const FBox& Bounds)
+{
+    check(Nodes.IsValidIndex(ProxyId) && Nodes[ProxyId].IsLeaf() && Nodes[ProxyId].Height == 0);
+
+    if (Nodes[ProxyId].Bounds.IsInside(Bounds)) { return false; }
+
+    RemoveLeaf(ProxyId);
+    Nodes[ProxyId].Bounds = Bounds.ExpandBy(FatMargin);
+    InsertLeaf(ProxyId);
+
+    return true;
+}
+
+
+void FClimbAABBTree::InsertLeaf(int32 Leaf)
+{
+    if (Root == INDEX_NONE)
+    {
+        Root = Leaf;
+        Nodes[Root].Parent = INDEX_NONE;
+        return;
+    }
+
+    //Walk down to the sibling that makes the tree grow the least, a child is only worth it when it beats pairing here
+    const FBox LeafBounds = Nodes[Leaf].Bounds;
+    int32 Sibling = Root;
+
+    while (!Nodes[Sibling].IsLeaf())
+    {
+        const FNode& Node = Nodes[Sibling];
+        const double Area = GetSurfaceArea(Node.Bounds);
+        const double CombinedArea = GetSurfaceArea(Node.Bounds + LeafBounds);
+
+        //Pairing with this node creates a parent of CombinedArea, and every ancestor below it grows by the inheritance cost
+        const double PairCost = 2.0 * CombinedArea;
+        const double InheritanceCost = 2.0 * (CombinedArea - Area);
+
+        auto GetDescendCost = [this, &LeafBounds, InheritanceCost](int32 Child)
+        {
+            const FNode& ChildNode = Nodes[Child];
+            const double ChildCombinedArea = GetSurfaceArea(ChildNode.Bounds + LeafBounds);
+            return ChildNode.IsLeaf()
+                ? ChildCombinedArea + InheritanceCost
+                : ChildCombinedArea - GetSurfaceArea(ChildNode.Bounds) + InheritanceCost;
+        };
+
+        const double Cost1 = GetDescendCost(Node.Child1);
+        const double Cost2 = GetDescendCost(Node.Child2);
+
+        if (PairCost < Cost1 && PairCost < Cost2) { break; }
+
+        Sibling = Cost1 < Cost2 ? Node.Child1 : Node.Child2;
+    }
+
+    const int32 OldParent = Nodes[Sibling].Parent;
+    const int32 NewParent = AllocateNode();
+
+    FNode& ParentNode = Nodes[NewParent];
+    ParentNode.Parent = OldParent;
+    ParentNode.Bounds = LeafBounds + Nodes[Sibling].Bounds;
+    ParentNode.Height = Nodes[Sibling].Height + 1;
+    ParentNode.Child1 = Sibling;
+    ParentNode.Child2 = Leaf;
+
+    if (OldParent == INDEX_NONE)
+    {
+        Root = NewParent;
+    }
+    else if (Nodes[OldParent].Child1 == Sibling)
+    {
+        Nodes[OldParent].Child1 = NewParent;
+    }
+    else
+    {
+        Nodes[OldParent].Child2 = NewParent;
+    }
+
+    Nodes[Sibling].Parent = NewParent;
+    Nodes[Leaf].Parent = NewParent;
+
+    RefitAncestors(NewParent);
+}
+
+
+void FClimbAABBTree::RemoveLeaf(int32 Leaf)
+{
+    if (Leaf == Root)
+    {
+        Root = INDEX_NONE;
+        return;
+    }
+
+    //The parent goes away and the sibling takes its place
+    const int32 Parent = Nodes[Leaf].Parent;
+    const int32 GrandParent = Nodes[Parent].Parent;
+    const int32 Sibling = Nodes[Parent].Child1 == Leaf ? Nodes[Parent].Child2 : Nodes[Parent].Child1;
+
+    if (GrandParent == INDEX_NONE)
+    {
+        Root = Sibling;
+        Nodes[Sibling].Parent = INDEX_NONE;
+        FreeNode(Parent);
+        return;
+    }
+
+    if (Nodes[GrandParent].Child1 == Parent)
+    {
+        Nodes[GrandParent].Child1 = Sibling;
+    }
+    else
+    {
+        Nodes[GrandParent].Child2 = Sibling;
+    }
+
+    Nodes[Sibling].Parent = GrandParent;
+    FreeNode(Parent);
+
+    RefitAncestors(GrandParent);
+}
+
+
+void FClimbAABBTree::RefitAncestors(int32 NodeIndex)
+{
+    while (NodeIndex != INDEX_NONE)
+    {
+        NodeIndex = Balance(NodeIndex);
+
+        FNode& Node = Nodes[NodeIndex];
+        const FNode& Child1 = Nodes[Node.Child1];
+        const FNode& Child2 = Nodes[Node.Child2];
+
+        Node.Height = 1 + FMath::Max(Child1.Height, Child2.Height);
+        Node.Bounds = Child1.Bounds + Child2.Bounds;
+
+        NodeIndex = Node.Parent;
+    }
+}
+
+
+int32 FClimbAABBTree::Balance(int32 A)
+{
+    if (Nodes[A].IsLeaf() || Nodes[A].Height < 2) { return A; }
+
+    const int32 B = Nodes[A].Child1;
+    const int32 C = Nodes[A].Child2;
+    const int32 HeightDifference = Nodes[C].Height - Nodes[B].Height;
+
+    if (FMath::Abs(HeightDifference) <= 1) { return A; }
+
+    //The taller child Up replaces A, A takes the place of Up's shorter child, which moves under A
+    const int32 Up = HeightDifference > 0 ? C : B;
+    const int32 Down = HeightDifference > 0 ? B : C;
+    const int32 UpChild1 = Nodes[Up].Child1;
+    const int32 UpChild2 = Nodes[Up].Child2;
+
+    Nodes[Up].Child1 = A;
+    Nodes[Up].Parent = Nodes[A].Parent;
+    Nodes[A].Parent = Up;
+
+    if (Nodes[Up].Parent == INDEX_NONE)
+    {
+        Root = Up;
+    }
+    else if (Nodes[Nodes[Up].Parent].Child1 == A)
+    {
+        Nodes[Nodes[Up].Parent].Child1 = Up;
+    }
+    else
+    {
+        Nodes[Nodes[Up].Parent].Child2 = Up;
+    }
+
+    const bool bKeepChild1 = Nodes[UpChild1].Height > Nodes[UpChild2].Height;
+    const int32 Kept = bKeepChild1 ? UpChild1 : UpChild2;
+    const int32 Moved = bKeepChild1 ? UpChild2 : UpChild1;
+
+    Nodes[Up].Child2 = Kept;
+    Nodes[A].Child1 = Down;
+    Nodes[A].Child2 = Moved;
+    Nodes[Moved].Parent = A;
+
+    Nodes[A].Bounds = Nodes[Down].Bounds + Nodes[Moved].Bounds;
+    Nodes[A].Height = 1 + FMath::Max(Nodes[Down].Height, Nodes[Moved].Height);
+    Nodes[Up].Bounds = Nodes[A].Bounds + Nodes[Kept].Bounds;
+    Nodes[Up].Height = 1 + FMath::Max(Nodes[A].Height, Nodes[Kept].Height);
+
+    return Up;
+}
@@ -0,0 +1,351 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Climb/ClimbBenchmark.h"
+#include "PeakPursuitCharacter.h"
+#include "Components/ClimbMovementComponent.h"
+#include "Climb/ClimbDiagnostics.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Components/StaticMeshComponent.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/FileHelper.h"
+#include "Algo/Find.h"
+
+#if !UE_BUILD_SHIPPING
+
+namespace ClimbBenchmark
+{
+    //Climbers walking off their scenario are put back at the start
+    static constexpr float MaxTravel = 300.0f;
+
+    enum class EStep : uint8
+    {
+        PhysClimb,
+        /** PhysClimb after moving the platform the climber hangs on */
+        PhysClimbMovingBase,
+        CanStartClimbing,
+        CanStartVaulting,
+        CanHopUp,
+        CanHopDown,
+        CanClimbDownLedge,
+    };
+
+    struct FScenario
+    {
+        const TCHAR* Name;
+        FVector Location;
+        float Yaw;
+        bool bClimbing;
+        /** Climb input for PhysClimb scenarios, in world space */
+        FVector Input;
+        EStep Step;
+    };
+
+    static const FVector WallLocation(250.0f, 0.0f, 600.0f);
+    static const FVector MovingBaseLocation(250.0f, -4000.0f, 600.0f);
+
+    //The moving platform slides along its face by this much and back, about once a second
+    static constexpr float MovingBaseAmplitude = 50.0f;
+    static constexpr float MovingBasePhasePerStep = 0.1f;
+
+    static const FScenario Scenarios[] =
+    {
+        { TEXT("PhysClimb.Idle"), WallLocation, 0.0f, true, FVector::ZeroVector, EStep::PhysClimb },
+        { TEXT("PhysClimb.Up"), WallLocation, 0.0f, true, FVector::UpVector, EStep::PhysClimb },
+        { TEXT("PhysClimb.Down"), WallLocation, 0.0f, true, FVector::DownVector, EStep::PhysClimb },
+        { TEXT("PhysClimb.Side"), WallLocation, 0.0f, true, FVector::RightVector, EStep::PhysClimb },
+        { TEXT("PhysClimb.Ledge"), FVector(250.0f, 3000.0f, 180.0f), 0.0f, true, FVector::UpVector, EStep::PhysClimb },
+        { TEXT("PhysClimb.MovingBase"), MovingBaseLocation, 0.0f, true, FVector::ZeroVector, EStep::PhysClimbMovingBase },
+        { TEXT("CanStartClimbing"), FVector(250.0f, 0.0f, 96.0f), 0.0f, false, FVector::ZeroVector, EStep::CanStartClimbing },
+        { TEXT("CanStartVaulting"), FVector(200.0f, -3000.0f, 96.0f), 0.0f, false, FVector::ZeroVector, EStep::CanStartVaulting },
+        { TEXT("CanHopUp"), WallLocation, 0.0f, true, FVector::ZeroVector, EStep::CanHopUp },
+        { TEXT("CanHopDown"), WallLocation, 0.0f, true, FVector::ZeroVector, EStep::CanHopDown },
+        { TEXT("CanClimbDownLedge"), FVector(370.0f, 3000.0f, 396.0f), 180.0f, false, FVector::ZeroVector, EStep::CanClimbDownLedge },
+    };
+
+    static UStaticMeshComponent* SpawnBox(UWorld* World, UStaticMesh* CubeMesh, const FVector& Min, const FVector& Max, ECollisionChannel ObjectType,
+        EComponentMobility::Type Mobility = EComponentMobility::Static)
+    {
+        //Engine cube is 100 units wide
+        const FTransform BoxTransform(FQuat::Identity, (Min + Max) * 0.5f, (Max - Min) / 100.0f);
+
+        //Deferred so static boxes have their mesh, type and scale before they register, like placed level geometry
+        AStaticMeshActor* Box = World->SpawnActorDeferred<AStaticMeshActor>(AStaticMeshActor::StaticClass(), BoxTransform);
+        UStaticMeshComponent* BoxComponent = Box->GetStaticMeshComponent();
+        BoxComponent->SetMobility(Mobility);
+        BoxComponent->SetStaticMesh(CubeMesh);
+        BoxComponent->SetCollisionObjectType(ObjectType);
+        Box->FinishSpawning(BoxTransform);
+
+        return BoxComponent;
+    }
+}
+
+
+TSharedRef<FJsonObject> FClimbBenchmarkSamples::Summarize()
+{
+    Micros.Sort();
+
+    const int32 Num = Micros.Num();
+    double Total = 0.0;
+    for (const double Sample : Micros)
+    {
+        Total += Sample;
+    }
+
+    TSharedRef<FJsonObject> Summary = MakeShared<FJsonObject>();
+    Summary->SetNumberField(TEXT("Samples"), Num);
+    Summary->SetNumberField(TEXT("MeanUs"), Num > 0 ? Total / Num : 0.0);
+    Summary->SetNumberField(TEXT("P50Us"), Num > 0 ? Micros[Num / 2] : 0.0);
+    Summary->SetNumberField(TEXT("P99Us"), Num > 0 ? Micros[FMath::Min(Num - 1, (Num * 99) / 100)] : 0.0);
+    Summary->SetNumberField(TEXT("QueriesPerCall"), Num > 0 ? (double)Queries / Num : 0.0);
+    Summary->SetNumberField(TEXT("AllocationsPerCall"), Num > 0 ? (double)Allocations / Num : 0.0);
+    Summary->SetNumberField(TEXT("MoveSweepsPerCall"), Num > 0 ? (double)MoveSweeps / Num : 0.0);
+    Summary->SetNumberField(TEXT("TransformUpdatesPerCall"), Num > 0 ? (double)TransformUpdates / Num : 0.0);
+    return Summary;
+}
+
+
+FClimbBenchmarkWorld::~FClimbBenchmarkWorld()
+{
+    if (!World) { return; }
+
+    GEngine->DestroyWorldContext(World);
+    World->DestroyWorld(false);
+}
+
+
+bool FClimbBenchmarkWorld::Initialize(const FString& CharacterClassPath, FString& OutError)
+{
+    using namespace ClimbBenchmark;
+
+    UClass* CharacterClass = LoadClass<APeakPursuitCharacter>(nullptr, *CharacterClassPath);
+    UStaticMesh* CubeMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+
+    if (!CharacterClass || !CubeMesh)
+    {
+        OutError = FString::Printf(TEXT("Could not load %s or the engine cube"), *CharacterClassPath);
+        return false;
+    }
+
+    const UClimbMovementComponent* DefaultMovement = Cast<UClimbMovementComponent>(CharacterClass->GetDefaultObject<APeakPursuitCharacter>()->GetCharacterMovement());
+    if (!DefaultMovement || DefaultMovement->GetClimbableSurfaceTypes().IsEmpty())
+    {
+        OutError = FString::Printf(TEXT("No ClimbableSurfaceTypes found on %s"), *CharacterClassPath);
+        return false;
+    }
+
+    const ECollisionChannel ClimbableChannel = UEngineTypes::ConvertToCollisionChannel(DefaultMovement->GetClimbableSurfaceTypes()[0]);
+
+    //Transient level, nothing in it but the benchmark geometry and one character
+    World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("ClimbBenchmark"));
+    FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+    WorldContext.SetCurrentWorld(World);
+
+    const FURL URL;
+    World->SetGameMode(URL);
+    World->InitializeActorsForPlay(URL);
+    World->BeginPlay();
+
+    //Floor, a tall wall facing -X, a 300 high ledge, a 100 high vault box and a tall moving platform, all faces at X=300
+    SpawnBox(World, CubeMesh, FVector(-5000.0f, -5000.0f, -100.0f), FVector(5000.0f, 5000.0f, 0.0f), ECC_WorldStatic);
+    SpawnBox(World, CubeMesh, FVector(300.0f, -500.0f, 0.0f), FVector(400.0f, 500.0f, 2000.0f), ClimbableChannel);
+    SpawnBox(World, CubeMesh, FVector(300.0f, 2500.0f, 0.0f), FVector(400.0f, 3500.0f, 300.0f), ClimbableChannel);
+    SpawnBox(World, CubeMesh, FVector(300.0f, -3100.0f, 0.0f), FVector(400.0f, -2900.0f, 100.0f), ClimbableChannel);
+
+    //Only the moving platform is movable, every other scenario climbs static geometry
+    MovingBase = SpawnBox(World, CubeMesh, FVector(300.0f, -4500.0f, 0.0f), FVector(400.0f, -3500.0f, 2000.0f), ClimbableChannel, EComponentMobility::Movable);
+    MovingBaseOrigin = MovingBase->GetComponentLocation();
+
+    FActorSpawnParameters SpawnParameters;
+    SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    Character = World->SpawnActor<APeakPursuitCharacter>(CharacterClass, FVector(0.0f, 0.0f, 100.0f), FRotator::ZeroRotator, SpawnParameters);
+    Movement = Character ? Character->GetClimbMovementComponent() : nullptr;
+
+    if (!Movement)
+    {
+        OutError = FString::Printf(TEXT("Could not spawn %s"), *CharacterClassPath);
+        return false;
+    }
+
+    //Every transform update of the capsule also moves the mesh, camera boom and other children
+    Movement->UpdatedComponent->TransformUpdated.AddLambda([this](USceneComponent*, EUpdateTransformFlags, ETeleportType) { NumTransformUpdates++; });
+
+    return true;
+}
+
+
+void FClimbBenchmarkWorld::GetScenarioNames(TArray<FString>& OutNames)
+{
+    for (const ClimbBenchmark::FScenario& Scenario : ClimbBenchmark::Scenarios)
+    {
+        OutNames.Add(Scenario.Name);
+    }
+}
+
+
+void FClimbBenchmarkWorld::ResetScenario(const ClimbBenchmark::FScenario& Scenario)
+{
+    Movement->SetMovementMode(MOVE_Walking);
+    Character->SetActorLocationAndRotation(Scenario.Location, FRotator(0.0f, Scenario.Yaw, 0.0f), false, nullptr, ETeleportType::TeleportPhysics);
+    Movement->Velocity = FVector::ZeroVector;
+
+    if (Scenario.bClimbing && Movement->CanStartClimbing())
+    {
+        Movement->StartClimbing();
+    }
+}
+
+
+void FClimbBenchmarkWorld::StepScenario(const ClimbBenchmark::FScenario& Scenario)
+{
+    using ClimbBenchmark::EStep;
+
+    FVector Start, End;
+
+    switch (Scenario.Step)
+    {
+    case EStep::PhysClimb: Movement->PhysClimb(DeltaTime, 0); break;
+    case EStep::PhysClimbMovingBase:
+        NumMovingBaseSteps++;
+        MovingBase->SetWorldLocation(MovingBaseOrigin + FVector(0.0f, FMath::Sin(NumMovingBaseSteps * ClimbBenchmark::MovingBasePhasePerStep) * ClimbBenchmark::MovingBaseAmplitude, 0.0f));
+        Movement->PhysClimb(DeltaTime, 0);
+        break;
+    case EStep::CanStartClimbing: Movement->CanStartClimbing(); break;
+    case EStep::CanStartVaulting: Movement->CanStartVaulting(Start, End); break;
+    case EStep::CanHopUp: Movement->CanHopUp(End); break;
+    case EStep::CanHopDown: Movement->CanHopDown(End); break;
+    case EStep::CanClimbDownLedge: Movement->CanClimbDownLedge(); break;
+    }
+}
+
+
+bool FClimbBenchmarkWorld::RunScenario(const FString& ScenarioName, int32 WarmupIterations, int32 Iterations, FClimbBenchmarkSamples& OutSamples, FString& OutError)
+{
+    const ClimbBenchmark::FScenario* Scenario = Algo::FindByPredicate(ClimbBenchmark::Scenarios, [&ScenarioName](const ClimbBenchmark::FScenario& Candidate) { return ScenarioName == Candidate.Name; });
+
+    if (!Scenario || !Movement)
+    {
+        OutError = FString::Printf(TEXT("%s: no such scenario or the benchmark world is not initialized"), *ScenarioName);
+        return false;
+    }
+
+    ResetScenario(*Scenario);
+
+    if (Scenario->bClimbing && !Movement->IsClimbing())
+    {
+        OutError = FString::Printf(TEXT("%s: could not start climbing at %s"), Scenario->Name, *Scenario->Location.ToString());
+        return false;
+    }
+
+    const double MicrosPerCycle = FPlatformTime::GetSecondsPerCycle64() * 1000000.0;
+    OutSamples.Micros.Reserve(Iterations);
+
+    for (int32 Iteration = 0; Iteration < WarmupIterations + Iterations; Iteration++)
+    {
+        const bool bLeftScenario = Movement->IsClimbing() != Scenario->bClimbing
+            || FVector::DistSquared(Character->GetActorLocation(), Scenario->Location) > FMath::Square(ClimbBenchmark::MaxTravel);
+
+        if (bLeftScenario)
+        {
+            ResetScenario(*Scenario);
+        }
+
+        Movement->Acceleration = Scenario->Input * Movement->GetMaxAcceleration();
+        Movement->ClimbQuery.ResetNumQueries();
+        Movement->NumClimbMoveSweeps = 0;
+        const int64 TransformUpdatesBefore = NumTransformUpdates;
+        const uint64 AllocationsBefore = ClimbDiagnostics::GetAllocationCount();
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+
+        StepScenario(*Scenario);
+
+        const uint64 EndCycles = FPlatformTime::Cycles64();
+        const uint64 AllocationsAfter = ClimbDiagnostics::GetAllocationCount();
+
+        if (Iteration < WarmupIterations) { continue; }
+
+        OutSamples.Micros.Add((EndCycles - StartCycles) * MicrosPerCycle);
+        OutSamples.Queries += Movement->ClimbQuery.GetNumQueries();
+        OutSamples.Allocations += AllocationsAfter - AllocationsBefore;
+        OutSamples.AllocatingCalls += AllocationsAfter != AllocationsBefore ? 1 : 0;
+        OutSamples.MoveSweeps += Movement->NumClimbMoveSweeps;
+        OutSamples.TransformUpdates += NumTransformUpdates - TransformUpdatesBefore;
+    }
+
+    return true;
+}
+
+
+FString FClimbBenchmarkWorld::Describe(const FString& ScenarioName, const FJsonObject& Summary)
+{
+    return FString::Printf(TEXT("%-24s mean %8.2fus  p50 %8.2fus  p99 %8.2fus  queries %5.2f  allocations %5.2f  sweeps %5.2f  transform updates %5.2f"),
+        *ScenarioName,
+        Summary.GetNumberField(TEXT("MeanUs")),
+        Summary.GetNumberField(TEXT("P50Us")),
+        Summary.GetNumberField(TEXT("P99Us")),
+        Summary.GetNumberField(TEXT("QueriesPerCall")),
+        Summary.GetNumberField(TEXT("AllocationsPerCall")),
+        Summary.GetNumberField(TEXT("MoveSweepsPerCall")),
+        Summary.GetNumberField(TEXT("TransformUpdatesPerCall"))
+    );
+}
+
+
+TSharedPtr<FJsonObject> FClimbBenchmarkWorld::LoadBaselineFunctions(const FString& BaselinePath)
+{
+    FString BaselineString;
+    TSharedPtr<FJsonObject> Baseline;
+    const TSharedPtr<FJsonObject>* BaselineFunctions = nullptr;
+
+    if (!FFileHelper::LoadFileToString(BaselineString, *BaselinePath)
+        || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BaselineString), Baseline)
+        || !Baseline.IsValid()
+        || !Baseline->TryGetObjectField(TEXT("Functions"), BaselineFunctions))
+    {
+        return nullptr;
+    }
+
+    return *BaselineFunctions;
+}
+
+
+bool FClimbBenchmarkWorld::IsRegression(const FJsonObject& Summary, const FJsonObject& BaselineSummary, float TolerancePercent, FString& OutDescription)
+{
+    const double Mean = Summary.GetNumberField(TEXT("MeanUs"));
+    const double BaselineMean = BaselineSummary.GetNumberField(TEXT("MeanUs"));
+    const double Queries = Summary.GetNumberField(TEXT("QueriesPerCall"));
+    const double BaselineQueries = BaselineSummary.GetNumberField(TEXT("QueriesPerCall"));
+    const double Allocations = Summary.GetNumberField(TEXT("AllocationsPerCall"));
+    const double BaselineAllocations = BaselineSummary.GetNumberField(TEXT("AllocationsPerCall"));
+    const double Moves = Summary.GetNumberField(TEXT("MoveSweepsPerCall")) + Summary.GetNumberField(TEXT("TransformUpdatesPerCall"));
+
+    //Baselines written before moves were counted have no move fields, they never flag a regression
+    double BaselineMoveSweeps = 0.0;
+    double BaselineTransformUpdates = 0.0;
+    const bool bHasBaselineMoves = BaselineSummary.TryGetNumberField(TEXT("MoveSweepsPerCall"), BaselineMoveSweeps)
+        && BaselineSummary.TryGetNumberField(TEXT("TransformUpdatesPerCall"), BaselineTransformUpdates);
+    const double BaselineMoves = BaselineMoveSweeps + BaselineTransformUpdates;
+
+    const bool bSlower = BaselineMean > 0.0 && Mean > BaselineMean * (1.0 + TolerancePercent / 100.0);
+    const bool bMoreQueries = Queries > BaselineQueries + KINDA_SMALL_NUMBER;
+    const bool bMoreAllocations = Allocations > BaselineAllocations + KINDA_SMALL_NUMBER;
+    const bool bMoreMoves = bHasBaselineMoves && Moves > BaselineMoves + KINDA_SMALL_NUMBER;
+
+    OutDescription = FString::Printf(TEXT("mean %8.2fus (%+6.1f%%)  queries %5.2f -> %5.2f  allocations %5.2f -> %5.2f  moves %5.2f -> %5.2f"),
+        Mean,
+        BaselineMean > 0.0 ? (Mean / BaselineMean - 1.0) * 100.0 : 0.0,
+        BaselineQueries, Queries,
+        BaselineAllocations, Allocations,
+        BaselineMoves, Moves
+    );
+
+    return bSlower || bMoreQueries || bMoreAllocations || bMoreMoves;
+}
+
+#endif
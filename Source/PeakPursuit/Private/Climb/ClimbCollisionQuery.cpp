@@ -0,0 +1,222 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Climb/ClimbCollisionQuery.h"
+#include "Climb/ClimbStats.h"
+#include "Engine/World.h"
+#include "Components/PrimitiveComponent.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "Algo/AllOf.h"
+
+
+namespace ClimbCollisionQuery
+{
+    /** One simple collision shape, so the scene has exactly one hit to report for it */
+    static bool HasSingleShape(const UPrimitiveComponent* Primitive)
+    {
+        const UBodySetup* BodySetup = Primitive->GetBodySetup();
+        return BodySetup
+            && BodySetup->GetCollisionTraceFlag() != CTF_UseComplexAsSimple
+            && BodySetup->AggGeom.GetElementCount() == 1;
+    }
+}
+
+
+FClimbCollisionQuery::FClimbCollisionQuery()
+    : SweepQueryParams(SCENE_QUERY_STAT(ClimbCapsuleSweep), false)
+    , LineQueryParams(SCENE_QUERY_STAT(ClimbLineTrace), false)
+{
+}
+
+
+void FClimbCollisionQuery::SetClimbableSurfaceTypes(const TArray<TEnumAsByte<EObjectTypeQuery>>& InClimbableSurfaceTypes)
+{
+    ObjectQueryParams = FCollisionObjectQueryParams(InClimbableSurfaceTypes);
+}
+
+
+bool FClimbCollisionQuery::SweepCapsule(const UWorld* World, const FVector& Start, const FVector& End, float Radius, float HalfHeight, FClimbHitResults& OutHits) const
+{
+    OutHits.Reset();
+
+    if (!World || !ObjectQueryParams.IsValid()) { return false; }
+
+    ++NumQueries;
+
+    const FCollisionShape CapsuleShape = FCollisionShape::MakeCapsule(Radius, HalfHeight);
+    const FVector CapsuleExtent(Radius, Radius, HalfHeight);
+    FClimbablePrimitiveCandidates Candidates;
+
+    //SweepComponent finds nothing for a sweep that does not move and only the closest shape of a primitive,
+    //overlap probes and compound primitives get one hit per shape from the scene instead
+    const bool bUseCandidates = !Start.Equals(End)
+        && GatherCandidates(FBox(Start.ComponentMin(End) - CapsuleExtent, Start.ComponentMax(End) + CapsuleExtent), Candidates, true);
+
+    if (bUseCandidates)
+    {
+        //One hit per single shape primitive in sweep order, like the multi sweep against the scene
+        FHitResult CandidateHit;
+        for (UPrimitiveComponent* Candidate : Candidates)
+        {
+            if (Candidate->SweepComponent(CandidateHit, Start, End, FQuat::Identity, CapsuleShape, SweepQueryParams.bTraceComplex))
+            {
+                OutHits.Add(CandidateHit);
+            }
+        }
+
+        OutHits.Sort([](const FHitResult& A, const FHitResult& B) { return A.Time < B.Time; });
+    }
+    else
+    {
+        //The scene only writes into default allocated arrays, the scratch one keeps its capacity between sweeps
+        World->SweepMultiByObjectType(SceneHits, Start, End, FQuat::Identity, ObjectQueryParams, CapsuleShape, SweepQueryParams);
+        OutHits.Append(SceneHits);
+    }
+
+    CLIMB_COUNTER_ADD(ClimbTraces, 1);
+    CLIMB_COUNTER_ADD(ClimbTraceHits, OutHits.Num());
+
+#if WITH_CLIMB_PROBE_RECORDER
+    if (ProbeRecorder && ProbeRecorder->IsRecording())
+    {
+        ProbeRecorder->RecordCapsule(Start, End, Radius, HalfHeight, OutHits);
+    }
+#endif
+
+    return !OutHits.IsEmpty();
+}
+
+
+bool FClimbCollisionQuery::LineTrace(const UWorld* World, const FVector& Start, const FVector& End, FHitResult& OutHit) const
+{
+    OutHit = FHitResult(1.0f);
+
+    if (World && ObjectQueryParams.IsValid())
+    {
+        ++NumQueries;
+        FClimbablePrimitiveCandidates Candidates;
+
+        if (GatherCandidates(FBox(Start.ComponentMin(End), Start.ComponentMax(End)), Candidates))
+        {
+            LineTraceCandidates(Candidates, Start, End, OutHit);
+        }
+        else
+        {
+            World->LineTraceSingleByObjectType(OutHit, Start, End, ObjectQueryParams, LineQueryParams);
+        }
+
+        CLIMB_COUNTER_ADD(ClimbTraces, 1);
+        CLIMB_COUNTER_ADD(ClimbTraceHits, OutHit.bBlockingHit ? 1 : 0);
+
+#if WITH_CLIMB_PROBE_RECORDER
+        if (ProbeRecorder && ProbeRecorder->IsRecording())
+        {
+            ProbeRecorder->RecordLine(Start, End, OutHit.bBlockingHit, OutHit.ImpactPoint, OutHit.ImpactNormal);
+        }
+#endif
+    }
+
+    //Callers walk on from TraceEnd when nothing was hit
+    OutHit.TraceStart = Start;
+    OutHit.TraceEnd = End;
+
+    return OutHit.bBlockingHit;
+}
+
+
+int32 FClimbCollisionQuery::TraceRayFan(const UWorld* World, FClimbRayFan& Fan, uint32 RayMask, TFunctionRef<bool(const FClimbRayFan&)> IsDecided) const
+{
+    Fan.TracedMask = 0;
+    Fan.HitMask = 0;
+
+    if (!World || !ObjectQueryParams.IsValid()) { return 0; }
+
+    int32 NumTraced = 0;
+    FHitResult RayHit;
+
+    //One gather for the whole fan, each ray then only tests the primitives around it
+    FBox FanBounds(ForceInit);
+    for (int32 RayIndex = 0; RayIndex < Fan.Num(); RayIndex++)
+    {
+        if (!(RayMask & (1u << RayIndex))) { continue; }
+
+        FanBounds += Fan.Starts[RayIndex];
+        FanBounds += Fan.Ends[RayIndex];
+    }
+
+    FClimbablePrimitiveCandidates Candidates;
+    const bool bUseCandidates = FanBounds.IsValid && GatherCandidates(FanBounds, Candidates);
+
+#if WITH_CLIMB_PROBE_RECORDER
+    const bool bRecordProbes = ProbeRecorder && ProbeRecorder->IsRecording();
+#endif
+
+    for (int32 RayIndex = 0; RayIndex < Fan.Num(); RayIndex++)
+    {
+        const uint32 RayBit = 1u << RayIndex;
+        if (!(RayMask & RayBit)) { continue; }
+
+        ++NumQueries;
+        ++NumTraced;
+        Fan.TracedMask |= RayBit;
+
+        const bool bRayHit = bUseCandidates
+            ? LineTraceCandidates(Candidates, Fan.Starts[RayIndex], Fan.Ends[RayIndex], RayHit)
+            : World->LineTraceSingleByObjectType(RayHit, Fan.Starts[RayIndex], Fan.Ends[RayIndex], ObjectQueryParams, LineQueryParams);
+
+        if (bRayHit)
+        {
+            Fan.HitMask |= RayBit;
+            Fan.HitPoints[RayIndex] = RayHit.ImpactPoint;
+            Fan.HitNormals[RayIndex] = RayHit.ImpactNormal;
+        }
+
+#if WITH_CLIMB_PROBE_RECORDER
+        if (bRecordProbes)
+        {
+            ProbeRecorder->RecordLine(Fan.Starts[RayIndex], Fan.Ends[RayIndex], Fan.IsHit(RayIndex), RayHit.ImpactPoint, RayHit.ImpactNormal);
+        }
+#endif
+
+        if (IsDecided(Fan)) { break; }
+    }
+
+    CLIMB_COUNTER_ADD(ClimbTraces, NumTraced);
+    CLIMB_COUNTER_ADD(ClimbTraceHits, FMath::CountBits(Fan.HitMask));
+
+    return NumTraced;
+}
+
+
+int32 FClimbCollisionQuery::TraceRayFan(const UWorld* World, FClimbRayFan& Fan) const
+{
+    return TraceRayFan(World, Fan, Fan.GetAllRaysMask(), [](const FClimbRayFan&) { return false; });
+}
+
+
+bool FClimbCollisionQuery::GatherCandidates(const FBox& Bounds, FClimbablePrimitiveCandidates& OutCandidates, bool bSingleShapesOnly) const
+{
+    if (!PrimitiveRegistry || !PrimitiveRegistry->GatherCandidates(Bounds, ObjectQueryParams, OutCandidates)) { return false; }
+    if (bSingleShapesOnly && !Algo::AllOf(OutCandidates, &ClimbCollisionQuery::HasSingleShape)) { return false; }
+
+    CLIMB_COUNTER_ADD(ClimbProbesCulled, 1);
+    return true;
+}
+
+
+bool FClimbCollisionQuery::LineTraceCandidates(const FClimbablePrimitiveCandidates& Candidates, const FVector& Start, const FVector& End, FHitResult& OutHit) const
+{
+    OutHit = FHitResult(1.0f);
+    FHitResult CandidateHit;
+
+    for (UPrimitiveComponent* Candidate : Candidates)
+    {
+        if (Candidate->LineTraceComponent(CandidateHit, Start, End, LineQueryParams) && CandidateHit.Time < OutHit.Time)
+        {
+            OutHit = CandidateHit;
+            OutHit.bBlockingHit = true;
+        }
+    }
+
+    return OutHit.bBlockingHit;
+}
@@ -0,0 +1,145 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Climb/ClimbGraphPathfinder.h"
+#include "Climb/ClimbStats.h"
+#include "Algo/Reverse.h"
+
+
+void FClimbGraphPathfinder::BeginSearch(const UClimbGraphData& Graph, int32 StartNode)
+{
+    const int32 NumNodes = Graph.Nodes.Num();
+
+    if (Generations.Num() != NumNodes)
+    {
+        Costs.SetNumUninitialized(NumNodes);
+        Parents.SetNumUninitialized(NumNodes);
+        ParentLinks.SetNumUninitialized(NumNodes);
+        Generations.Init(0, NumNodes);
+        ClosedGenerations.Init(0, NumNodes);
+        Generation = 0;
+    }
+
+    //Zero marks untouched nodes, clear everything again when the generation wraps around to it
+    if (++Generation == 0)
+    {
+        Generations.Init(0, NumNodes);
+        ClosedGenerations.Init(0, NumNodes);
+        Generation = 1;
+    }
+
+    Open.Reset();
+    NumExpanded = 0;
+}
+
+
+void FClimbGraphPathfinder::Visit(int32 Node, int32 Parent, EClimbGraphLinkType Link, float Cost, float Estimate)
+{
+    Generations[Node] = Generation;
+    Costs[Node] = Cost;
+    Parents[Node] = Parent;
+    ParentLinks[Node] = Link;
+    Open.HeapPush({ Estimate, Node });
+}
+
+
+bool FClimbGraphPathfinder::FindPath(const UClimbGraphData& Graph, int32 StartNode, int32 GoalNode, FClimbGraphPath& OutPath)
+{
+    CLIMB_SCOPE(FindClimbPath);
+
+    OutPath.Reset();
+
+    if (!Graph.Nodes.IsValidIndex(StartNode) || !Graph.Nodes.IsValidIndex(GoalNode)) { return false; }
+
+    BeginSearch(Graph, StartNode);
+
+    //Straight line at the fastest speed of any link never overestimates the remaining cost
+    const FVector GoalLocation = Graph.Nodes[GoalNode].Location;
+    const float InvHeuristicSpeed = 1.0f / FMath::Max(Graph.HeuristicSpeed, 1.0f);
+
+    Visit(StartNode, INDEX_NONE, EClimbGraphLinkType::Climb, 0.0f, FVector::Dist(Graph.Nodes[StartNode].Location, GoalLocation) * InvHeuristicSpeed);
+
+    while (Open.Num() > 0)
+    {
+        FOpenNode Current;
+        Open.HeapPop(Current, false);
+
+        //A node is pushed again whenever a cheaper way to it is found, the older entries are stale
+        if (IsClosed(Current.Node)) { continue; }
+
+        ClosedGenerations[Current.Node] = Generation;
+        NumExpanded++;
+
+        if (Current.Node == GoalNode)
+        {
+            for (int32 Node = GoalNode; Node != INDEX_NONE; Node = Parents[Node])
+            {
+                const FClimbGraphNode& GraphNode = Graph.Nodes[Node];
+
+                FClimbGraphPathPoint& Point = OutPath.Points.AddDefaulted_GetRef();
+                Point.Node = Node;
+                Point.Location = GraphNode.Location;
+                Point.Normal = GraphNode.Normal;
+                Point.NodeType = GraphNode.Type;
+                Point.LinkType = ParentLinks[Node];
+            }
+
+            Algo::Reverse(OutPath.Points);
+            OutPath.Cost = Costs[GoalNode];
+            return true;
+        }
+
+        for (const FClimbGraphLink& Link : Graph.GetLinks(Current.Node))
+        {
+            if (IsClosed(Link.To)) { continue; }
+
+            const float Cost = Costs[Current.Node] + Link.Cost;
+            if (IsVisited(Link.To) && Cost >= Costs[Link.To]) { continue; }
+
+            Visit(Link.To, Current.Node, Link.Type, Cost, Cost + FVector::Dist(Graph.Nodes[Link.To].Location, GoalLocation) * InvHeuristicSpeed);
+        }
+    }
+
+    return false;
+}
+
+
+void FClimbGraphPathfinder::FindGroundRoutes(const UClimbGraphData& Graph, int32 StartNode, TArray<FClimbGraphRoute>& OutRoutes)
+{
+    if (!Graph.Nodes.IsValidIndex(StartNode)) { return; }
+
+    BeginSearch(Graph, StartNode);
+    Visit(StartNode, INDEX_NONE, EClimbGraphLinkType::Climb, 0.0f, 0.0f);
+
+    //Dijkstra, there is no single goal to aim the search at
+    while (Open.Num() > 0)
+    {
+        FOpenNode Current;
+        Open.HeapPop(Current, false);
+
+        if (IsClosed(Current.Node)) { continue; }
+
+        ClosedGenerations[Current.Node] = Generation;
+        NumExpanded++;
+
+        //Walking on from another ground node is the nav mesh's job
+        if (Current.Node != StartNode && Graph.Nodes[Current.Node].Type == EClimbGraphNodeType::Ground)
+        {
+            FClimbGraphRoute& Route = OutRoutes.AddDefaulted_GetRef();
+            Route.From = StartNode;
+            Route.To = Current.Node;
+            Route.Cost = Costs[Current.Node];
+            continue;
+        }
+
+        for (const FClimbGraphLink& Link : Graph.GetLinks(Current.Node))
+        {
+            if (IsClosed(Link.To)) { continue; }
+
+            const float Cost = Costs[Current.Node] + Link.Cost;
+            if (IsVisited(Link.To) && Cost >= Costs[Link.To]) { continue; }
+
+            Visit(Link.To, Current.Node, Link.Type, Cost, Cost);
+        }
+    }
+}
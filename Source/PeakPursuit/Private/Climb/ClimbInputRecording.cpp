@@ -0,0 +1,121 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Climb/ClimbInputRecording.h"
+#include "PeakPursuit/PeakPursuit.h"
+#include "HAL/FileManager.h"
+#include "Serialization/Archive.h"
+
+
+FArchive& operator<<(FArchive& Ar, FClimbInputFrame& Frame)
+{
+    Ar << Frame.DeltaTime;
+    Ar << Frame.Flags;
+
+    if (Frame.HasFlag(FClimbInputFrame::GroundMove)) { Ar << Frame.GroundMoveValue; }
+    if (Frame.HasFlag(FClimbInputFrame::ClimbMove)) { Ar << Frame.ClimbMoveValue; }
+    if (Frame.HasFlag(FClimbInputFrame::ControlRotation)) { Ar << Frame.ControlRotationValue; }
+
+    Ar << Frame.Location;
+    return Ar;
+}
+
+
+FArchive& operator<<(FArchive& Ar, FClimbInputRecording& Recording)
+{
+    uint32 Magic = FClimbInputRecording::Magic;
+    uint32 Version = FClimbInputRecording::Version;
+    Ar << Magic;
+    Ar << Version;
+
+    if (Magic != FClimbInputRecording::Magic || Version < FClimbInputRecording::MinVersion || Version > FClimbInputRecording::Version)
+    {
+        Ar.SetError();
+        return Ar;
+    }
+
+    Ar << Recording.MapName;
+    if (Version >= 2) { Ar << Recording.CharacterClassPath; }
+    Ar << Recording.RandomSeed;
+    Ar << Recording.StartTransform;
+    Ar << Recording.StartControlRotation;
+    Ar << Recording.bStartClimbing;
+    Ar << Recording.StartSurfaceLocation;
+    Ar << Recording.StartSurfaceNormal;
+    Ar << Recording.Frames;
+    Ar << Recording.FinalTransform;
+    return Ar;
+}
+
+
+bool FClimbInputRecording::SaveToFile(const FString& Filename) const
+{
+    TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*Filename));
+    if (!Writer) { return false; }
+
+    *Writer << const_cast<FClimbInputRecording&>(*this);
+    return Writer->Close();
+}
+
+
+bool FClimbInputRecording::LoadFromFile(const FString& Filename)
+{
+    TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Filename));
+    if (!Reader) { return false; }
+
+    *Reader << *this;
+    return Reader->Close();
+}
+
+
+void FClimbInputRecorder::RecordGroundMove(const FVector2D& Value)
+{
+    PendingFrame.Flags |= FClimbInputFrame::GroundMove;
+    PendingFrame.GroundMoveValue = FVector2f(Value);
+}
+
+
+void FClimbInputRecorder::RecordClimbMove(const FVector2D& Value)
+{
+    PendingFrame.Flags |= FClimbInputFrame::ClimbMove;
+    PendingFrame.ClimbMoveValue = FVector2f(Value);
+}
+
+
+void FClimbInputRecorder::RecordAction(FClimbInputFrame::EFlags Action)
+{
+    PendingFrame.Flags |= Action;
+}
+
+
+void FClimbInputRecorder::CommitFrame(float DeltaTime, const FVector& Location, const FRotator& ControlRotation)
+{
+    //Control rotation stands in for look input, only stored when it changed
+    if (Recording.Frames.IsEmpty() || !ControlRotation.Equals(LastControlRotation, 0.0f))
+    {
+        PendingFrame.Flags |= FClimbInputFrame::ControlRotation;
+        PendingFrame.ControlRotationValue = FRotator3f(ControlRotation);
+        LastControlRotation = ControlRotation;
+    }
+
+    PendingFrame.DeltaTime = DeltaTime;
+    PendingFrame.Location = FVector3f(Location);
+
+    Recording.Frames.Add(PendingFrame);
+    PendingFrame = FClimbInputFrame();
+}
+
+
+bool FClimbInputRecorder::Finish(const FTransform& FinalTransform)
+{
+    Recording.FinalTransform = FinalTransform;
+
+    if (!Recording.SaveToFile(Filename))
+    {
+        UE_LOG(LogClimb, Error, TEXT("Failed to write climb input recording %s"), *Filename);
+        return false;
+    }
+
+    UE_LOG(LogClimb, Display, TEXT("Wrote %d frames of climb input to %s"), Recording.Frames.Num(), *Filename);
+    return true;
+}
@@ -0,0 +1,280 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Climb/ClimbMeshUtils.h"
+
+#if WITH_EDITOR
+#include "Engine/StaticMesh.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "GameFramework/Character.h"
+#include "MeshDescription.h"
+#include "StaticMeshAttributes.h"
+#include "StaticMeshOperations.h"
+#include "Components/ClimbMovementComponent.h"
+#include "Data/ClimbLedgeData.h"
+
+
+bool ClimbMeshUtils::GatherTriangles(const UStaticMesh* Mesh, TArray<FVector>& OutPositions, TArray<int32>& OutIndices, TFunctionRef<bool(FName MaterialSlotName)> SectionFilter)
+{
+    OutPositions.Reset();
+    OutIndices.Reset();
+
+    const FMeshDescription* MeshDescription = Mesh ? Mesh->GetMeshDescription(0) : nullptr;
+    if (!MeshDescription) { return false; }
+
+    return GatherTriangles(*MeshDescription, OutPositions, OutIndices, SectionFilter);
+}
+
+
+bool ClimbMeshUtils::GatherTriangles(const FMeshDescription& MeshDescription, TArray<FVector>& OutPositions, TArray<int32>& OutIndices, TFunctionRef<bool(FName MaterialSlotName)> SectionFilter)
+{
+    OutPositions.Reset();
+    OutIndices.Reset();
+
+    FStaticMeshConstAttributes Attributes(MeshDescription);
+    TVertexAttributesConstRef<FVector3f> VertexPositions = Attributes.GetVertexPositions();
+    TPolygonGroupAttributesConstRef<FName> MaterialSlotNames = Attributes.GetPolygonGroupMaterialSlotNames();
+
+    //Vertex ids can be sparse, compact them
+    TArray<int32> VertexRemap;
+    VertexRemap.Init(INDEX_NONE, MeshDescription.Vertices().GetArraySize());
+    OutPositions.Reserve(MeshDescription.Vertices().Num());
+
+    for (const FVertexID VertexID : MeshDescription.Vertices().GetElementIDs())
+    {
+        VertexRemap[VertexID.GetValue()] = OutPositions.Add(FVector(VertexPositions[VertexID]));
+    }
+
+    OutIndices.Reserve(MeshDescription.Triangles().Num() * 3);
+
+    for (const FTriangleID TriangleID : MeshDescription.Triangles().GetElementIDs())
+    {
+        const FPolygonGroupID PolygonGroupID = MeshDescription.GetTrianglePolygonGroup(TriangleID);
+        if (!SectionFilter(MaterialSlotNames[PolygonGroupID])) { continue; }
+
+        for (const FVertexID VertexID : MeshDescription.GetTriangleVertices(TriangleID))
+        {
+            OutIndices.Add(VertexRemap[VertexID.GetValue()]);
+        }
+    }
+
+    return !OutIndices.IsEmpty();
+}
+
+
+bool ClimbMeshUtils::GatherTriangles(const UStaticMesh* Mesh, TArray<FVector>& OutPositions, TArray<int32>& OutIndices)
+{
+    return GatherTriangles(Mesh, OutPositions, OutIndices, [](FName) { return true; });
+}
+
+
+void ClimbMeshUtils::ExtractLedgeSegments(const TArray<FVector>& Positions, const TArray<int32>& Indices, const FTransform& Transform, float WalkableFloorZ, float MaxWallNormalZ, float MinSegmentLength, TArray<FClimbLedgeSegment>& OutSegments)
+{
+    TArray<FVector> WorldPositions;
+    WorldPositions.Reserve(Positions.Num());
+    for (const FVector& Position : Positions)
+    {
+        WorldPositions.Add(Transform.TransformPosition(Position));
+    }
+
+    //Mirroring transforms flip the winding
+    const float WindingSign = Transform.GetDeterminant() < 0.0f ? -1.0f : 1.0f;
+
+    struct FEdgeFaces
+    {
+        int32 TopTriangle = INDEX_NONE;
+        int32 WallTriangle = INDEX_NONE;
+    };
+    TMap<TPair<int32, int32>, FEdgeFaces> Edges;
+
+    const int32 NumTriangles = Indices.Num() / 3;
+    TArray<FVector> Normals;
+    Normals.SetNumUninitialized(NumTriangles);
+
+    for (int32 Triangle = 0; Triangle < NumTriangles; Triangle++)
+    {
+        const FVector& A = WorldPositions[Indices[Triangle * 3 + 0]];
+        const FVector& B = WorldPositions[Indices[Triangle * 3 + 1]];
+        const FVector& C = WorldPositions[Indices[Triangle * 3 + 2]];
+        Normals[Triangle] = (FVector::CrossProduct(C - A, B - A) * WindingSign).GetSafeNormal();
+
+        const bool bTop = Normals[Triangle].Z >= WalkableFloorZ;
+        const bool bWall = FMath::Abs(Normals[Triangle].Z) < MaxWallNormalZ;
+        if (!bTop && !bWall) { continue; }
+
+        for (int32 Corner = 0; Corner < 3; Corner++)
+        {
+            const int32 V0 = Indices[Triangle * 3 + Corner];
+            const int32 V1 = Indices[Triangle * 3 + (Corner + 1) % 3];
+            FEdgeFaces& EdgeFaces = Edges.FindOrAdd(TPair<int32, int32>(FMath::Min(V0, V1), FMath::Max(V0, V1)));
+            (bTop ? EdgeFaces.TopTriangle : EdgeFaces.WallTriangle) = Triangle;
+        }
+    }
+
+    for (const TPair<TPair<int32, int32>, FEdgeFaces>& Edge : Edges)
+    {
+        if (Edge.Value.TopTriangle == INDEX_NONE || Edge.Value.WallTriangle == INDEX_NONE) { continue; }
+
+        const FVector& Start = WorldPositions[Edge.Key.Key];
+        const FVector& End = WorldPositions[Edge.Key.Value];
+        if (FVector::DistSquared(Start, End) < FMath::Square(MinSegmentLength)) { continue; }
+
+        const FVector OutwardNormal = FVector(Normals[Edge.Value.WallTriangle].X, Normals[Edge.Value.WallTriangle].Y, 0.0f).GetSafeNormal();
+        if (OutwardNormal.IsZero()) { continue; }
+
+        //Convex only: the walkable top must lie behind the wall, a floor in front of it is the foot of the wall
+        const int32 TopTriangle = Edge.Value.TopTriangle;
+        const FVector TopCentroid = (WorldPositions[Indices[TopTriangle * 3]] + WorldPositions[Indices[TopTriangle * 3 + 1]] + WorldPositions[Indices[TopTriangle * 3 + 2]]) / 3.0f;
+        if (FVector::DotProduct(TopCentroid - (Start + End) * 0.5f, OutwardNormal) >= 0.0f) { continue; }
+
+        FClimbLedgeSegment& Segment = OutSegments.AddDefaulted_GetRef();
+        Segment.Start = Start;
+        Segment.End = End;
+        Segment.OutwardNormal = OutwardNormal;
+    }
+}
+
+
+void ClimbMeshUtils::BuildMeshDescription(const TArray<FVector>& Positions, const TArray<int32>& Indices, FName MaterialSlotName, FMeshDescription& OutMeshDescription)
+{
+    OutMeshDescription.Empty();
+
+    FStaticMeshAttributes Attributes(OutMeshDescription);
+    Attributes.Register();
+
+    TVertexAttributesRef<FVector3f> VertexPositions = Attributes.GetVertexPositions();
+    OutMeshDescription.ReserveNewVertices(Positions.Num());
+    OutMeshDescription.ReserveNewVertexInstances(Indices.Num());
+    OutMeshDescription.ReserveNewTriangles(Indices.Num() / 3);
+
+    for (const FVector& Position : Positions)
+    {
+        VertexPositions[OutMeshDescription.CreateVertex()] = FVector3f(Position);
+    }
+
+    const FPolygonGroupID PolygonGroupID = OutMeshDescription.CreatePolygonGroup();
+    Attributes.GetPolygonGroupMaterialSlotNames()[PolygonGroupID] = MaterialSlotName;
+
+    for (int32 Triangle = 0; Triangle < Indices.Num() / 3; Triangle++)
+    {
+        const int32 A = Indices[Triangle * 3 + 0];
+        const int32 B = Indices[Triangle * 3 + 1];
+        const int32 C = Indices[Triangle * 3 + 2];
+        if (A == B || B == C || C == A) { continue; }
+
+        const FVertexInstanceID Corners[3] =
+        {
+            OutMeshDescription.CreateVertexInstance(FVertexID(A)),
+            OutMeshDescription.CreateVertexInstance(FVertexID(B)),
+            OutMeshDescription.CreateVertexInstance(FVertexID(C))
+        };
+        OutMeshDescription.CreateTriangle(PolygonGroupID, TArrayView<const FVertexInstanceID>(Corners, 3));
+    }
+
+    //No hard edges, so the normals come out smoothed across the whole shell
+    FStaticMeshOperations::ComputeTriangleTangentsAndNormals(OutMeshDescription);
+    FStaticMeshOperations::ComputeTangentsAndNormals(OutMeshDescription, EComputeNTBsFlags::Normals);
+}
+
+
+void ClimbMeshUtils::SmoothTriangles(TArray<FVector>& Positions, const TArray<int32>& Indices, int32 Iterations, float Weight)
+{
+    if (Iterations <= 0) { return; }
+
+    TArray<FVector> Sums;
+    TArray<int32> Counts;
+
+    for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+    {
+        Sums.Init(FVector::ZeroVector, Positions.Num());
+        Counts.Init(0, Positions.Num());
+
+        //Every triangle edge pulls on both ends, shared edges count twice which only weights them, not the average
+        for (int32 Index = 0; Index < Indices.Num(); Index++)
+        {
+            const int32 Vertex = Indices[Index];
+            const int32 Next = Indices[Index - Index % 3 + (Index + 1) % 3];
+            Sums[Vertex] += Positions[Next];
+            Sums[Next] += Positions[Vertex];
+            Counts[Vertex]++;
+            Counts[Next]++;
+        }
+
+        for (int32 Vertex = 0; Vertex < Positions.Num(); Vertex++)
+        {
+            if (Counts[Vertex] == 0) { continue; }
+            Positions[Vertex] = FMath::Lerp(Positions[Vertex], Sums[Vertex] / Counts[Vertex], Weight);
+        }
+    }
+}
+
+
+void ClimbMeshUtils::MeasureDeviation(const TArray<FVector>& SourcePositions, const TArray<int32>& SourceIndices, const TArray<FVector>& ProxyPositions, const TArray<int32>& ProxyIndices, float SampleSpacing, float& OutMeanDeviation, float& OutMaxDeviation)
+{
+    OutMeanDeviation = 0.0f;
+    OutMaxDeviation = 0.0f;
+
+    if (SourceIndices.IsEmpty() || ProxyIndices.IsEmpty()) { return; }
+
+    //Fixed seed, so rebuilding an unchanged mesh reports the same numbers
+    FRandomStream RandomStream(0x5EED);
+    const double SampleArea = FMath::Square(FMath::Max(SampleSpacing, 1.0f));
+    double DeviationSum = 0.0;
+    int32 NumSamples = 0;
+
+    for (int32 Triangle = 0; Triangle < SourceIndices.Num() / 3; Triangle++)
+    {
+        const FVector& A = SourcePositions[SourceIndices[Triangle * 3 + 0]];
+        const FVector& B = SourcePositions[SourceIndices[Triangle * 3 + 1]];
+        const FVector& C = SourcePositions[SourceIndices[Triangle * 3 + 2]];
+        const double Area = FVector::CrossProduct(B - A, C - A).Size() * 0.5;
+        const int32 NumTriangleSamples = FMath::Max(1, FMath::RoundToInt(Area / SampleArea));
+
+        for (int32 Sample = 0; Sample < NumTriangleSamples; Sample++)
+        {
+            //Uniform over the triangle
+            const float SqrtU = FMath::Sqrt(RandomStream.FRand());
+            const float V = RandomStream.FRand();
+            const FVector Point = A * (1.0f - SqrtU) + B * (SqrtU * (1.0f - V)) + C * (SqrtU * V);
+
+            double ClosestDistSquared = TNumericLimits<double>::Max();
+            for (int32 ProxyTriangle = 0; ProxyTriangle < ProxyIndices.Num() / 3; ProxyTriangle++)
+            {
+                const FVector Closest = FMath::ClosestPointOnTriangleToPoint(Point,
+                    ProxyPositions[ProxyIndices[ProxyTriangle * 3 + 0]], ProxyPositions[ProxyIndices[ProxyTriangle * 3 + 1]], ProxyPositions[ProxyIndices[ProxyTriangle * 3 + 2]]);
+                ClosestDistSquared = FMath::Min(ClosestDistSquared, FVector::DistSquared(Point, Closest));
+            }
+
+            const float Deviation = FMath::Sqrt(ClosestDistSquared);
+            DeviationSum += Deviation;
+            OutMaxDeviation = FMath::Max(OutMaxDeviation, Deviation);
+            NumSamples++;
+        }
+    }
+
+    OutMeanDeviation = DeviationSum / NumSamples;
+}
+
+
+bool ClimbMeshUtils::IsClimbableMesh(const UStaticMesh* Mesh, const TArray<TEnumAsByte<EObjectTypeQuery>>& ClimbableSurfaceTypes)
+{
+    const UBodySetup* BodySetup = Mesh ? Mesh->GetBodySetup() : nullptr;
+    if (!BodySetup) { return false; }
+
+    const EObjectTypeQuery MeshObjectType = UEngineTypes::ConvertToObjectType(BodySetup->DefaultInstance.GetObjectType());
+    return ClimbableSurfaceTypes.Contains(MeshObjectType);
+}
+
+
+bool ClimbMeshUtils::GetClimbableSurfaceTypes(const FString& CharacterClassPath, TArray<TEnumAsByte<EObjectTypeQuery>>& OutTypes)
+{
+    const UClass* CharacterClass = LoadClass<ACharacter>(nullptr, *CharacterClassPath);
+    const ACharacter* CharacterCDO = CharacterClass ? CharacterClass->GetDefaultObject<ACharacter>() : nullptr;
+    const UClimbMovementComponent* ClimbMovementComponent = CharacterCDO ? Cast<UClimbMovementComponent>(CharacterCDO->GetCharacterMovement()) : nullptr;
+
+    if (!ClimbMovementComponent) { return false; }
+
+    OutTypes = ClimbMovementComponent->GetClimbableSurfaceTypes();
+    return !OutTypes.IsEmpty();
+}
+#endif
@@ -0,0 +1,109 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "Kismet/GameplayStatics.h"
+#include "Kismet/KismetSystemLibrary.h"
+#include "Components/ClimbMovementComponent.h"
+#include "Climb/ClimbRayFan.h"
+
+#if !UE_BUILD_SHIPPING
+
+namespace ClimbProbeBenchmark
+{
+    //Previous path, one Kismet trace per ray with a fresh ignore list and a by value result
+    static void TraceLegacy(UWorld* World, const UClimbMovementComponent& ClimbMovement, const FClimbRayFan& Fan, int32& OutNumTraces)
+    {
+        for (int32 RayIndex = 0; RayIndex < Fan.Num(); RayIndex++)
+        {
+            FHitResult HitResult;
+            UKismetSystemLibrary::LineTraceSingleForObjects(
+                World,
+                Fan.Starts[RayIndex],
+                Fan.Ends[RayIndex],
+                ClimbMovement.GetClimbableSurfaceTypes(),
+                false,
+                TArray<AActor*>(),
+                EDrawDebugTrace::None,
+                HitResult,
+                false
+            );
+            OutNumTraces++;
+        }
+    }
+
+    static void Run(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+    {
+        const int32 Iterations = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 1000;
+
+        const ACharacter* Character = UGameplayStatics::GetPlayerCharacter(World, 0);
+        const UClimbMovementComponent* ClimbMovement = Character ? Cast<UClimbMovementComponent>(Character->GetCharacterMovement()) : nullptr;
+
+        if (!ClimbMovement)
+        {
+            Ar.Log(TEXT("climb.BenchRayFan needs a local player character with a UClimbMovementComponent"));
+            return;
+        }
+
+        struct FProbeSet
+        {
+            const TCHAR* Name;
+            FClimbRayFan Fan;
+            uint32 RayMask;
+        };
+
+        FProbeSet ProbeSets[4];
+        ProbeSets[0].Name = TEXT("Vault");
+        ClimbMovement->BuildVaultRayFan(ProbeSets[0].Fan);
+        ProbeSets[0].RayMask = UClimbMovementComponent::GetVaultRayMask();
+        ProbeSets[1].Name = TEXT("HopUp");
+        ClimbMovement->BuildHopUpRayFan(ProbeSets[1].Fan);
+        ProbeSets[2].Name = TEXT("HopDown");
+        ClimbMovement->BuildHopDownRayFan(ProbeSets[2].Fan);
+        ProbeSets[3].Name = TEXT("ClimbDownLedge");
+        ClimbMovement->BuildClimbDownLedgeRayFan(ProbeSets[3].Fan);
+
+        for (int32 SetIndex = 1; SetIndex < UE_ARRAY_COUNT(ProbeSets); SetIndex++)
+        {
+            ProbeSets[SetIndex].RayMask = ProbeSets[SetIndex].Fan.GetAllRaysMask();
+        }
+
+        Ar.Logf(TEXT("climb.BenchRayFan: %d iterations from %s"), Iterations, *Character->GetActorLocation().ToString());
+
+        for (FProbeSet& ProbeSet : ProbeSets)
+        {
+            int32 LegacyTraces = 0;
+            const uint64 LegacyStart = FPlatformTime::Cycles64();
+            for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+            {
+                TraceLegacy(World, *ClimbMovement, ProbeSet.Fan, LegacyTraces);
+            }
+            const double LegacyMicroseconds = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - LegacyStart) * 1000.0 / Iterations;
+
+            int32 FanTraces = 0;
+            const uint64 FanStart = FPlatformTime::Cycles64();
+            for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+            {
+                FanTraces += ClimbMovement->GetClimbQuery().TraceRayFan(World, ProbeSet.Fan, ProbeSet.RayMask, [](const FClimbRayFan& Fan) { return Fan.HasMiss(); });
+            }
+            const double FanMicroseconds = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - FanStart) * 1000.0 / Iterations;
+
+            Ar.Logf(TEXT("  %-16s legacy %7.2f us (%.1f traces)  fan %7.2f us (%.1f traces, hit mask 0x%x)"),
+                ProbeSet.Name,
+                LegacyMicroseconds, (float)LegacyTraces / Iterations,
+                FanMicroseconds, (float)FanTraces / Iterations,
+                ProbeSet.Fan.HitMask);
+        }
+    }
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice ClimbBenchRayFanCommand(
+    TEXT("climb.BenchRayFan"),
+    TEXT("climb.BenchRayFan [Iterations] - Times the vault, hop and climb down probes as sequential Kismet traces versus a ray fan, from the local player"),
+    FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&ClimbProbeBenchmark::Run)
+);
+
+#endif
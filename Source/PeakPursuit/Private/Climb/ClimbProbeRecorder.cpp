@@ -0,0 +1,28 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Climb/ClimbProbeRecorder.h"
+#include "HAL/IConsoleManager.h"
+
+#if WITH_CLIMB_PROBE_RECORDER
+
+bool FClimbProbeRecorder::bRecordAll = false;
+
+static FAutoConsoleVariableRef CVarClimbRecordProbes(
+    TEXT("climb.RecordProbes"),
+    FClimbProbeRecorder::bRecordAll,
+    TEXT("Record the climb queries of every climber, not only the one selected in the Climb gameplay debugger category."));
+
+
+void FClimbProbeRecorder::Allocate()
+{
+    Records.SetNumZeroed(Capacity);
+}
+
+
+void FClimbProbeRecorder::Reset()
+{
+    NumRecorded = 0;
+}
+
+#endif
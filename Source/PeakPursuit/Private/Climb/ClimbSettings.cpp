@@ -0,0 +1,22 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Climb/ClimbSettings.h"
+
+
+EClimbLODTier UClimbSettings::GetTier(float Distance, bool bVisible, bool bPlayerControlled) const
+{
+    if (bPlayerControlled || !bEnableClimbLOD)
+    {
+        return EClimbLODTier::Full;
+    }
+
+    if (bVisible)
+    {
+        if (Distance <= FullTierDistance) { return EClimbLODTier::Full; }
+        if (Distance <= ReducedTierDistance) { return EClimbLODTier::Reduced; }
+        return EClimbLODTier::Kinematic;
+    }
+
+    return Distance <= OffscreenReducedTierDistance ? EClimbLODTier::Reduced : EClimbLODTier::Kinematic;
+}
@@ -0,0 +1,50 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Climb/ClimbStateMachine.h"
+
+
+const TCHAR* ClimbStateMachine::GetStateName(EClimbState State)
+{
+    static const TCHAR* const Names[] = { TEXT("Idle"), TEXT("EnteringClimb"), TEXT("Climbing"), TEXT("Hopping"), TEXT("Mantling"), TEXT("Vaulting"), TEXT("ExitingClimb") };
+    static_assert(UE_ARRAY_COUNT(Names) == (int32)EClimbState::Num, "Missing climb state name");
+
+    return State < EClimbState::Num ? Names[(int32)State] : TEXT("Invalid");
+}
+
+
+const TCHAR* ClimbStateMachine::GetEventName(EClimbEvent Event)
+{
+    static const TCHAR* const Names[] = { TEXT("EnterStarted"), TEXT("VaultStarted"), TEXT("HopStarted"), TEXT("LedgeReached"), TEXT("ClimbStarted"), TEXT("ClimbStopped"), TEXT("Landed"), TEXT("ActionFinished") };
+    static_assert(UE_ARRAY_COUNT(Names) == (int32)EClimbEvent::Num, "Missing climb event name");
+
+    return Event < EClimbEvent::Num ? Names[(int32)Event] : TEXT("Invalid");
+}
+
+
+bool FClimbStateMachine::Dispatch(EClimbEvent Event, double Time)
+{
+    const EClimbState To = ClimbStateMachine::FindTransition(State, Event);
+    if (To == EClimbState::Num) { return false; }
+
+    FClimbStateTransitionRecord& Record = History[NumRecorded % HistorySize];
+    Record.From = State;
+    Record.To = To;
+    Record.Event = Event;
+    Record.Time = Time;
+    NumRecorded++;
+
+    State = To;
+    return true;
+}
+
+
+void FClimbStateMachine::GetHistory(TArray<FClimbStateTransitionRecord>& OutHistory) const
+{
+    OutHistory.Reset();
+
+    for (int32 RecordIndex = FMath::Max(NumRecorded - HistorySize, 0); RecordIndex < NumRecorded; RecordIndex++)
+    {
+        OutHistory.Add(History[RecordIndex % HistorySize]);
+    }
+}
@@ -0,0 +1,43 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Climb/ClimbStats.h"
+
+CSV_DEFINE_CATEGORY_MODULE(PEAKPURSUIT_API, Climb, true);
+
+DEFINE_STAT(STAT_ClimbersFull);
+DEFINE_STAT(STAT_ClimbersReduced);
+DEFINE_STAT(STAT_ClimbersKinematic);
+DEFINE_STAT(STAT_ClimbersMass);
+DEFINE_STAT(STAT_ClimbersPromoted);
+DEFINE_STAT(STAT_ClimbTraces);
+DEFINE_STAT(STAT_ClimbTraceHits);
+DEFINE_STAT(STAT_ClimbProbesIssued);
+DEFINE_STAT(STAT_ClimbProbesSaved);
+DEFINE_STAT(STAT_ClimbMoveSweeps);
+DEFINE_STAT(STAT_ClimbProbeBudget);
+DEFINE_STAT(STAT_ClimbProbeBudgetUsed);
+DEFINE_STAT(STAT_ClimbProbesDeferred);
+DEFINE_STAT(STAT_ClimbProbesForced);
+DEFINE_STAT(STAT_ClimbProbesCulled);
+DEFINE_STAT(STAT_Climb_PhysClimb);
+DEFINE_STAT(STAT_Climb_PhysClimbKinematic);
+DEFINE_STAT(STAT_Climb_MoveAlongClimbableSurface);
+DEFINE_STAT(STAT_Climb_MassProcessor);
+DEFINE_STAT(STAT_Climb_GetClimbableSurfaces);
+DEFINE_STAT(STAT_Climb_RequestAsyncClimbableSurfaces);
+DEFINE_STAT(STAT_Climb_ConsumeAsyncClimbableSurfaces);
+DEFINE_STAT(STAT_Climb_SampleClimbableSurfaceField);
+DEFINE_STAT(STAT_Climb_TraceFromEyeHeight);
+DEFINE_STAT(STAT_Climb_TraceFromLedgeHeight);
+DEFINE_STAT(STAT_Climb_CanStartClimbing);
+DEFINE_STAT(STAT_Climb_CanClimbDownLedge);
+DEFINE_STAT(STAT_Climb_CanStartVaulting);
+DEFINE_STAT(STAT_Climb_CanHopUp);
+DEFINE_STAT(STAT_Climb_CanHopDown);
+DEFINE_STAT(STAT_Climb_HasReachFloor);
+DEFINE_STAT(STAT_Climb_HasReachLedge);
+DEFINE_STAT(STAT_Climb_FindClimbLedge);
+DEFINE_STAT(STAT_Climb_FindClimbPath);
+DEFINE_STAT(STAT_Climb_PlayClimbMontage);
+DEFINE_STAT(STAT_Climb_OnClimbMontageBlendingOut);
@@ -0,0 +1,124 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Commandlets/ClimbBenchmarkCommandlet.h"
+#include "PeakPursuit/PeakPursuit.h"
+#include "Climb/ClimbSettings.h"
+#include "Climb/ClimbBenchmark.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+
+UClimbBenchmarkCommandlet::UClimbBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+
+int32 UClimbBenchmarkCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+    FString CharacterClassPath = GetDefault<UClimbSettings>()->ClimbCharacterClass.ToString();
+    FString OutputPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks/Climb.json");
+    FString BaselinePath;
+    FString Label;
+    int32 Iterations = 2000;
+    int32 WarmupIterations = 100;
+    float TolerancePercent = 10.0f;
+
+    FParse::Value(*Params, TEXT("Character="), CharacterClassPath);
+    FParse::Value(*Params, TEXT("Output="), OutputPath);
+    FParse::Value(*Params, TEXT("Baseline="), BaselinePath);
+    FParse::Value(*Params, TEXT("Label="), Label);
+    FParse::Value(*Params, TEXT("Iterations="), Iterations);
+    FParse::Value(*Params, TEXT("Warmup="), WarmupIterations);
+    FParse::Value(*Params, TEXT("Tolerance="), TolerancePercent);
+
+    TSharedRef<FJsonObject> Functions = MakeShared<FJsonObject>();
+
+    {
+        FClimbBenchmarkWorld BenchmarkWorld;
+        FString Error;
+
+        if (!BenchmarkWorld.Initialize(CharacterClassPath, Error))
+        {
+            UE_LOG(LogClimb, Error, TEXT("%s"), *Error);
+            return 1;
+        }
+
+        TArray<FString> ScenarioNames;
+        FClimbBenchmarkWorld::GetScenarioNames(ScenarioNames);
+
+        for (const FString& ScenarioName : ScenarioNames)
+        {
+            FClimbBenchmarkSamples Samples;
+            if (!BenchmarkWorld.RunScenario(ScenarioName, WarmupIterations, Iterations, Samples, Error))
+            {
+                UE_LOG(LogClimb, Error, TEXT("%s"), *Error);
+                continue;
+            }
+
+            TSharedRef<FJsonObject> Summary = Samples.Summarize();
+            UE_LOG(LogClimb, Display, TEXT("%s"), *FClimbBenchmarkWorld::Describe(ScenarioName, *Summary));
+            Functions->SetObjectField(ScenarioName, Summary);
+        }
+    }
+
+    TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+    Report->SetStringField(TEXT("Label"), Label);
+    Report->SetStringField(TEXT("Engine"), FEngineVersion::Current().ToString());
+    Report->SetStringField(TEXT("Platform"), FPlatformProperties::IniPlatformName());
+    Report->SetNumberField(TEXT("Iterations"), Iterations);
+    Report->SetNumberField(TEXT("DeltaTime"), FClimbBenchmarkWorld::DeltaTime);
+    Report->SetObjectField(TEXT("Functions"), Functions);
+
+    FString ReportString;
+    FJsonSerializer::Serialize(Report, TJsonWriterFactory<>::Create(&ReportString));
+
+    if (!FFileHelper::SaveStringToFile(ReportString, *OutputPath))
+    {
+        UE_LOG(LogClimb, Error, TEXT("Failed to write %s"), *OutputPath);
+        return 1;
+    }
+
+    UE_LOG(LogClimb, Display, TEXT("Wrote %s"), *OutputPath);
+
+    if (BaselinePath.IsEmpty()) { return 0; }
+
+    const TSharedPtr<FJsonObject> BaselineFunctions = FClimbBenchmarkWorld::LoadBaselineFunctions(BaselinePath);
+    if (!BaselineFunctions.IsValid())
+    {
+        UE_LOG(LogClimb, Error, TEXT("Could not read baseline %s"), *BaselinePath);
+        return 1;
+    }
+
+    int32 NumRegressions = 0;
+
+    for (const TPair<FString, TSharedPtr<FJsonValue>>& Function : Functions->Values)
+    {
+        const TSharedPtr<FJsonObject>* Baseline = nullptr;
+        if (!BaselineFunctions->TryGetObjectField(Function.Key, Baseline)) { continue; }
+
+        FString Description;
+        const bool bRegression = FClimbBenchmarkWorld::IsRegression(*Function.Value->AsObject(), **Baseline, TolerancePercent, Description);
+        UE_LOG(LogClimb, Display, TEXT("%-24s %s%s"), *Function.Key, *Description, bRegression ? TEXT("  REGRESSION") : TEXT(""));
+
+        if (bRegression)
+        {
+            NumRegressions++;
+        }
+    }
+
+    UE_LOG(LogClimb, Display, TEXT("%d regressions against %s"), NumRegressions, *BaselinePath);
+
+    return NumRegressions > 0 ? 1 : 0;
+#else
+    return 1;
+#endif
+}
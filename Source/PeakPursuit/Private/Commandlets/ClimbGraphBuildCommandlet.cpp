@@ -0,0 +1,625 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Commandlets/ClimbGraphBuildCommandlet.h"
+#include "PeakPursuit/PeakPursuit.h"
+#include "Climb/ClimbSettings.h"
+#include "PeakPursuitCharacter.h"
+#include "Components/ClimbMovementComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Data/ClimbGraphData.h"
+#include "Data/ClimbLedgeData.h"
+#include "Subsystems/ClimbGraphSubsystem.h"
+#include "Climb/ClimbGraphPathfinder.h"
+#include "Climb/ClimbMeshUtils.h"
+#include "Animation/AnimMontage.h"
+#include "Engine/Engine.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Misc/PackageName.h"
+#include "UObject/SavePackage.h"
+
+#if WITH_EDITOR
+
+namespace ClimbGraphBuild
+{
+    //Seconds assumed for an action whose montage cannot be loaded
+    static constexpr float DefaultActionCost = 1.0f;
+
+    /** Nodes with a grid to find them by location, links are kept per node until the graph is written */
+    struct FGraphBuilder
+    {
+        TArray<FClimbGraphNode> Nodes;
+        TArray<TArray<FClimbGraphLink>> NodeLinks;
+        TMap<FIntVector, TArray<int32>> Cells;
+        float InvCellSize = 0.01f;
+
+        FIntVector GetCell(const FVector& Location) const
+        {
+            return FIntVector(
+                FMath::FloorToInt(Location.X * InvCellSize),
+                FMath::FloorToInt(Location.Y * InvCellSize),
+                FMath::FloorToInt(Location.Z * InvCellSize)
+            );
+        }
+
+        void ForEachNode(const FVector& Location, float MaxDistance, TFunctionRef<void(int32 NodeIndex, float DistSquared)> Visit) const
+        {
+            const FIntVector MinCell = GetCell(Location - FVector(MaxDistance));
+            const FIntVector MaxCell = GetCell(Location + FVector(MaxDistance));
+            const float MaxDistSquared = FMath::Square(MaxDistance);
+
+            for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+            {
+                for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+                {
+                    for (int32 Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+                    {
+                        const TArray<int32>* CellNodes = Cells.Find(FIntVector(X, Y, Z));
+                        if (!CellNodes) { continue; }
+
+                        for (const int32 NodeIndex : *CellNodes)
+                        {
+                            const float DistSquared = FVector::DistSquared(Nodes[NodeIndex].Location, Location);
+                            if (DistSquared <= MaxDistSquared) { Visit(NodeIndex, DistSquared); }
+                        }
+                    }
+                }
+            }
+        }
+
+        int32 FindNearestNode(const FVector& Location, float MaxDistance, TFunctionRef<bool(const FClimbGraphNode&)> Accept) const
+        {
+            int32 NearestNode = INDEX_NONE;
+            float NearestDistSquared = MAX_flt;
+
+            ForEachNode(Location, MaxDistance, [&](int32 NodeIndex, float DistSquared)
+            {
+                if (DistSquared < NearestDistSquared && Accept(Nodes[NodeIndex]))
+                {
+                    NearestNode = NodeIndex;
+                    NearestDistSquared = DistSquared;
+                }
+            });
+
+            return NearestNode;
+        }
+
+        int32 AddNode(const FVector& Location, const FVector& Normal, EClimbGraphNodeType Type)
+        {
+            const int32 NodeIndex = Nodes.AddDefaulted();
+            Nodes[NodeIndex].Location = Location;
+            Nodes[NodeIndex].Normal = Normal;
+            Nodes[NodeIndex].Type = Type;
+            NodeLinks.AddDefaulted();
+            Cells.FindOrAdd(GetCell(Location)).Add(NodeIndex);
+            return NodeIndex;
+        }
+
+        /** Ground nodes closer than MergeDistance are the same spot */
+        int32 FindOrAddGroundNode(const FVector& Location, float MergeDistance, bool& bOutAdded)
+        {
+            const int32 Existing = FindNearestNode(Location, MergeDistance, [](const FClimbGraphNode& Node) { return Node.Type == EClimbGraphNodeType::Ground; });
+            bOutAdded = Existing == INDEX_NONE;
+            return bOutAdded ? AddNode(Location, FVector::UpVector, EClimbGraphNodeType::Ground) : Existing;
+        }
+
+        void AddLink(int32 From, int32 To, EClimbGraphLinkType Type, float Cost)
+        {
+            if (From == To || From == INDEX_NONE || To == INDEX_NONE) { return; }
+
+            //Keep the cheapest of the same kind of link between two nodes
+            for (FClimbGraphLink& Link : NodeLinks[From])
+            {
+                if (Link.To == To && Link.Type == Type)
+                {
+                    Link.Cost = FMath::Min(Link.Cost, Cost);
+                    return;
+                }
+            }
+
+            FClimbGraphLink& Link = NodeLinks[From].AddDefaulted_GetRef();
+            Link.To = To;
+            Link.Type = Type;
+            Link.Cost = Cost;
+        }
+    };
+
+    /** Points on a lattice of Spacing over the plane of a wall triangle, aligned so coplanar neighbours share it */
+    static void SampleWallTriangle(const FVector& A, const FVector& B, const FVector& C, const FVector& Normal, float Spacing, TArray<FVector>& OutSamples)
+    {
+        const FVector Horizontal = FVector::CrossProduct(FVector::UpVector, Normal).GetSafeNormal();
+        if (Horizontal.IsZero()) { return; }
+
+        const FVector Vertical = FVector::CrossProduct(Normal, Horizontal);
+
+        const FVector2D UVA(FVector::DotProduct(A, Horizontal), FVector::DotProduct(A, Vertical));
+        const FVector2D UVB(FVector::DotProduct(B, Horizontal), FVector::DotProduct(B, Vertical));
+        const FVector2D UVC(FVector::DotProduct(C, Horizontal), FVector::DotProduct(C, Vertical));
+
+        const float Area = FVector2D::CrossProduct(UVB - UVA, UVC - UVA);
+        if (FMath::Abs(Area) < KINDA_SMALL_NUMBER) { return; }
+
+        const FVector2D Min = FVector2D::Min(UVA, FVector2D::Min(UVB, UVC));
+        const FVector2D Max = FVector2D::Max(UVA, FVector2D::Max(UVB, UVC));
+
+        for (float U = FMath::CeilToFloat(Min.X / Spacing) * Spacing; U <= Max.X; U += Spacing)
+        {
+            for (float V = FMath::CeilToFloat(Min.Y / Spacing) * Spacing; V <= Max.Y; V += Spacing)
+            {
+                const FVector2D UV(U, V);
+                const float WeightB = FVector2D::CrossProduct(UV - UVA, UVC - UVA) / Area;
+                const float WeightC = FVector2D::CrossProduct(UVB - UVA, UV - UVA) / Area;
+
+                if (WeightB < 0.0f || WeightC < 0.0f || WeightB + WeightC > 1.0f) { continue; }
+
+                OutSamples.Add(A + Horizontal * (U - UVA.X) + Vertical * (V - UVA.Y));
+            }
+        }
+    }
+
+    static EClimbAction GetLinkAction(EClimbGraphLinkType Type)
+    {
+        switch (Type)
+        {
+        case EClimbGraphLinkType::ClimbStart: return EClimbAction::IdleToClimb;
+        case EClimbGraphLinkType::HopUp: return EClimbAction::HopUp;
+        case EClimbGraphLinkType::HopDown: return EClimbAction::HopDown;
+        case EClimbGraphLinkType::Mantle: return EClimbAction::ClimbToTop;
+        case EClimbGraphLinkType::ClimbDownLedge: return EClimbAction::ClimbDownLedge;
+        case EClimbGraphLinkType::Vault: return EClimbAction::Vault;
+        default: return EClimbAction::Num;
+        }
+    }
+}
+
+#endif
+
+
+UClimbGraphBuildCommandlet::UClimbGraphBuildCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+
+int32 UClimbGraphBuildCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+    using namespace ClimbGraphBuild;
+
+    FString MapPath = TEXT("/Game/ThirdPerson/Maps/ThirdPersonMap");
+    FString CharacterClassPath = GetDefault<UClimbSettings>()->ClimbCharacterClass.ToString();
+    float Spacing = 100.0f;
+    float CellSize = 200.0f;
+    float RouteCellSize = 300.0f;
+
+    FParse::Value(*Params, TEXT("Map="), MapPath);
+    FParse::Value(*Params, TEXT("Character="), CharacterClassPath);
+    FParse::Value(*Params, TEXT("Spacing="), Spacing);
+    FParse::Value(*Params, TEXT("CellSize="), CellSize);
+    FParse::Value(*Params, TEXT("RouteCellSize="), RouteCellSize);
+
+    Spacing = FMath::Max(Spacing, 10.0f);
+
+    UClass* CharacterClass = LoadClass<APeakPursuitCharacter>(nullptr, *CharacterClassPath);
+    if (!CharacterClass)
+    {
+        UE_LOG(LogClimb, Error, TEXT("Could not load %s"), *CharacterClassPath);
+        return 1;
+    }
+
+    UPackage* MapPackage = LoadPackage(nullptr, *MapPath, LOAD_None);
+    UWorld* World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+
+    if (!World || !World->PersistentLevel)
+    {
+        UE_LOG(LogClimb, Error, TEXT("Failed to load map %s"), *MapPath);
+        return 1;
+    }
+
+    //The character's own checks run against the level, so it needs collision and a game to begin play in
+    World->AddToRoot();
+    World->WorldType = EWorldType::Game;
+    FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+    WorldContext.SetCurrentWorld(World);
+
+    World->InitWorld(UWorld::InitializationValues()
+        .AllowAudioPlayback(false)
+        .RequiresHitProxies(false)
+        .CreateNavigation(false)
+        .CreateAISystem(false)
+        .CreateFXSystem(false)
+        .ShouldSimulatePhysics(false)
+        .EnableTraceCollision(true)
+        .SetTransactional(false));
+    World->UpdateWorldComponents(true, false);
+
+    const FURL URL;
+    World->SetGameMode(URL);
+    World->InitializeActorsForPlay(URL);
+    World->BeginPlay();
+
+    FActorSpawnParameters SpawnParameters;
+    SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    APeakPursuitCharacter* Character = World->SpawnActor<APeakPursuitCharacter>(CharacterClass, FVector::ZeroVector, FRotator::ZeroRotator, SpawnParameters);
+    UClimbMovementComponent* Movement = Character ? Character->GetClimbMovementComponent() : nullptr;
+
+    if (!Movement || Movement->GetClimbableSurfaceTypes().IsEmpty())
+    {
+        UE_LOG(LogClimb, Error, TEXT("No ClimbableSurfaceTypes found on %s"), *CharacterClassPath);
+        return 1;
+    }
+
+    const float CapsuleRadius = Character->GetCapsuleComponent()->GetScaledCapsuleRadius();
+    const float StandingHalfHeight = Character->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+
+    FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ClimbGraphBuild), false, Character);
+
+    //Walkable floor the character could stand on below Location, within MaxDistance
+    auto FindFloor = [&](const FVector& Location, float MaxDistance, FVector& OutStandLocation)
+    {
+        FHitResult FloorHit;
+        const bool bHit = World->LineTraceSingleByChannel(FloorHit, Location, Location - FVector::UpVector * MaxDistance, ECC_Pawn, QueryParams);
+        if (!bHit || !Movement->IsWalkable(FloorHit)) { return false; }
+
+        OutStandLocation = FloorHit.ImpactPoint + FVector::UpVector * StandingHalfHeight;
+        return true;
+    };
+
+    auto PlaceStanding = [&](const FVector& Location, const FVector& Facing)
+    {
+        Movement->SetMovementMode(MOVE_Walking);
+        Character->SetActorLocationAndRotation(Location, FRotator(0.0f, Facing.Rotation().Yaw, 0.0f), false, nullptr, ETeleportType::TeleportPhysics);
+        Movement->InvalidateClimbProbeCaches();
+    };
+
+    //Same acceptance as a climb tick: the surface sweep finds the wall and it is not too flat to hang on
+    auto PlaceClimbing = [&](const FVector& Location, const FVector& Normal)
+    {
+        if (!Movement->IsClimbing())
+        {
+            Movement->StartClimbingOnSurface(Location - Normal * CapsuleRadius, Normal);
+        }
+
+        Character->SetActorLocationAndRotation(Location, FRotationMatrix::MakeFromXZ(-Normal, FVector::UpVector).ToQuat(), false, nullptr, ETeleportType::TeleportPhysics);
+        Movement->InvalidateClimbProbeCaches();
+
+        if (!Movement->GetClimbableSurfaces()) { return false; }
+
+        Movement->ProcessClimbableSurfaceInfo();
+        return !Movement->ShouldStopClimbing();
+    };
+
+    //Action links cost their montage length
+    float ActionCosts[(int32)EClimbAction::Num];
+    for (int32 ActionIndex = 0; ActionIndex < (int32)EClimbAction::Num; ActionIndex++)
+    {
+        const FClimbAction* Action = Movement->GetClimbActionTable()->FindAction((EClimbAction)ActionIndex);
+        const UAnimMontage* Montage = Action ? Action->Montage.LoadSynchronous() : nullptr;
+        ActionCosts[ActionIndex] = Montage ? FMath::Max(Montage->GetPlayLength(), KINDA_SMALL_NUMBER) : DefaultActionCost;
+    }
+
+    auto GetActionCost = [&ActionCosts](EClimbGraphLinkType Type) { return ActionCosts[(int32)GetLinkAction(Type)]; };
+
+    //Climbable geometry, gathered the way the ledge extraction does
+    const TArray<TEnumAsByte<EObjectTypeQuery>>& ClimbableSurfaceTypes = Movement->GetClimbableSurfaceTypes();
+    TArray<FVector> WallSamples;
+    TArray<FVector> WallSampleNormals;
+    TArray<FClimbLedgeSegment> LedgeSegments;
+    TArray<FVector> Positions;
+    TArray<int32> Indices;
+
+    for (const AActor* Actor : World->PersistentLevel->Actors)
+    {
+        if (!Actor) { continue; }
+
+        TArray<UStaticMeshComponent*> MeshComponents;
+        Actor->GetComponents(MeshComponents);
+
+        for (const UStaticMeshComponent* MeshComponent : MeshComponents)
+        {
+            if (MeshComponent->GetCollisionEnabled() == ECollisionEnabled::NoCollision) { continue; }
+
+            const EObjectTypeQuery ObjectType = UEngineTypes::ConvertToObjectType(MeshComponent->GetCollisionObjectType());
+            if (!ClimbableSurfaceTypes.Contains(ObjectType)) { continue; }
+
+            if (!ClimbMeshUtils::GatherTriangles(MeshComponent->GetStaticMesh(), Positions, Indices)) { continue; }
+
+            const FTransform& Transform = MeshComponent->GetComponentTransform();
+            ClimbMeshUtils::ExtractLedgeSegments(Positions, Indices, Transform, Movement->GetWalkableFloorZ(), Movement->StopClimbingMinDot, Spacing * 0.5f, LedgeSegments);
+
+            const float WindingSign = Transform.GetDeterminant() < 0.0f ? -1.0f : 1.0f;
+
+            for (int32 Triangle = 0; Triangle < Indices.Num() / 3; Triangle++)
+            {
+                const FVector A = Transform.TransformPosition(Positions[Indices[Triangle * 3 + 0]]);
+                const FVector B = Transform.TransformPosition(Positions[Indices[Triangle * 3 + 1]]);
+                const FVector C = Transform.TransformPosition(Positions[Indices[Triangle * 3 + 2]]);
+                const FVector Normal = (FVector::CrossProduct(C - A, B - A) * WindingSign).GetSafeNormal();
+
+                //Flatter than DegreesSurfaceClimbingThreshold stops the climb, ceilings cannot be hung from
+                if (Normal.Z >= Movement->StopClimbingMinDot || Normal.Z <= -Movement->StopClimbingMinDot) { continue; }
+
+                SampleWallTriangle(A, B, C, Normal, Spacing, WallSamples);
+                while (WallSampleNormals.Num() < WallSamples.Num())
+                {
+                    WallSampleNormals.Add(Normal);
+                }
+            }
+        }
+    }
+
+    FGraphBuilder Builder;
+    Builder.InvCellSize = 1.0f / Spacing;
+
+    const float MergeDistance = Spacing * 0.5f;
+    const float LinkSearchDistance = Spacing * 2.0f;
+
+    auto IsWallNode = [](const FClimbGraphNode& Node) { return Node.Type == EClimbGraphNodeType::Wall; };
+
+    //Wall nodes: every sample the climber can hang at, samples of both sides of a thin wall stay apart
+    for (int32 SampleIndex = 0; SampleIndex < WallSamples.Num(); SampleIndex++)
+    {
+        const FVector& Normal = WallSampleNormals[SampleIndex];
+        const FVector Location = WallSamples[SampleIndex] + Normal * CapsuleRadius;
+
+        const int32 Existing = Builder.FindNearestNode(Location, MergeDistance, [&Normal](const FClimbGraphNode& Node)
+        {
+            return Node.Type == EClimbGraphNodeType::Wall && FVector::DotProduct(Node.Normal, Normal) > 0.9f;
+        });
+
+        if (Existing != INDEX_NONE || !PlaceClimbing(Location, Normal)) { continue; }
+
+        Builder.AddNode(Location, Movement->CurrentClimbableSurfaceNormal, EClimbGraphNodeType::Wall);
+    }
+
+    const int32 NumWallNodes = Builder.Nodes.Num();
+
+    //Climb links between neighbouring wall nodes the capsule can move between
+    for (int32 NodeIndex = 0; NodeIndex < NumWallNodes; NodeIndex++)
+    {
+        const FClimbGraphNode Node = Builder.Nodes[NodeIndex];
+
+        Builder.ForEachNode(Node.Location, Spacing * 1.5f, [&](int32 OtherIndex, float DistSquared)
+        {
+            const FClimbGraphNode& Other = Builder.Nodes[OtherIndex];
+            if (OtherIndex == NodeIndex || Other.Type != EClimbGraphNodeType::Wall) { return; }
+
+            //Climbing turns at most 60 degrees between neighbours
+            if (FVector::DotProduct(Node.Normal, Other.Normal) < 0.5f) { return; }
+
+            FHitResult BlockingHit;
+            if (World->LineTraceSingleByChannel(BlockingHit, Node.Location, Other.Location, ECC_Pawn, QueryParams)) { return; }
+
+            Builder.AddLink(NodeIndex, OtherIndex, EClimbGraphLinkType::Climb, FMath::Sqrt(DistSquared) / FMath::Max(Movement->MaxClimbSpeed, 1.0f));
+        });
+    }
+
+    //Hops, mantles and drops from each wall node, with the checks the climber runs there
+    for (int32 NodeIndex = 0; NodeIndex < NumWallNodes; NodeIndex++)
+    {
+        const FClimbGraphNode Node = Builder.Nodes[NodeIndex];
+        if (!PlaceClimbing(Node.Location, Node.Normal)) { continue; }
+
+        FVector HopTarget;
+        if (Movement->CanHopUp(HopTarget))
+        {
+            const int32 Target = Builder.FindNearestNode(HopTarget + Node.Normal * CapsuleRadius, LinkSearchDistance,
+                [&Node](const FClimbGraphNode& Other) { return Other.Type == EClimbGraphNodeType::Wall && Other.Location.Z > Node.Location.Z; });
+            Builder.AddLink(NodeIndex, Target, EClimbGraphLinkType::HopUp, GetActionCost(EClimbGraphLinkType::HopUp));
+        }
+
+        if (Movement->CanHopDown(HopTarget))
+        {
+            const int32 Target = Builder.FindNearestNode(HopTarget + Node.Normal * CapsuleRadius, LinkSearchDistance,
+                [&Node](const FClimbGraphNode& Other) { return Other.Type == EClimbGraphNodeType::Wall && Other.Location.Z < Node.Location.Z; });
+            Builder.AddLink(NodeIndex, Target, EClimbGraphLinkType::HopDown, GetActionCost(EClimbGraphLinkType::HopDown));
+        }
+
+        const FVector Up = Character->GetActorUpVector();
+        const FVector Forward = Character->GetActorForwardVector();
+        bool bAdded = false;
+
+        //The climber lands on the walkable top the ledge check found past the edge
+        if (Movement->TraceLedgeAbove())
+        {
+            const FVector LedgeTraceEnd = Node.Location + Up * (Character->BaseEyeHeight + Movement->LedgeTraceStartOffset) + Forward * Movement->EyesTraceDist;
+
+            FVector LandLocation;
+            if (FindFloor(LedgeTraceEnd, 100.0f, LandLocation))
+            {
+                const int32 Target = Builder.FindOrAddGroundNode(LandLocation, MergeDistance, bAdded);
+                Builder.AddLink(NodeIndex, Target, EClimbGraphLinkType::Mantle, GetActionCost(EClimbGraphLinkType::Mantle));
+            }
+        }
+
+        //Same probe as HasReachFloor, the climber lets go and stands below where it hung
+        FHitResult FloorHit;
+        const FVector FloorTraceStart = Node.Location - Up * 50.0f;
+        if (Movement->GetClimbLineTraces(FloorTraceStart, FloorTraceStart - FVector::UpVector * Movement->FloorReachedDetector, FloorHit)
+            && FVector::Parallel(-FloorHit.ImpactNormal, FVector::UpVector))
+        {
+            FVector StandLocation;
+            if (FindFloor(FloorTraceStart, Movement->FloorReachedDetector + 1.0f, StandLocation))
+            {
+                const int32 Target = Builder.FindOrAddGroundNode(StandLocation, MergeDistance, bAdded);
+                Builder.AddLink(NodeIndex, Target, EClimbGraphLinkType::Drop, FVector::Dist(Node.Location, StandLocation) / FMath::Max(Movement->MaxClimbSpeed, 1.0f));
+            }
+        }
+    }
+
+    //Ground in front of the wall nodes within reach: climb start and vault, facing the wall
+    for (int32 NodeIndex = 0; NodeIndex < NumWallNodes; NodeIndex++)
+    {
+        const FClimbGraphNode Node = Builder.Nodes[NodeIndex];
+        const FVector Facing = FVector(-Node.Normal.X, -Node.Normal.Y, 0.0f).GetSafeNormal();
+        if (Facing.IsZero()) { continue; }
+
+        FVector StandLocation;
+        if (!FindFloor(Node.Location - Facing * 10.0f, StandingHalfHeight + Character->BaseEyeHeight, StandLocation)) { continue; }
+
+        //Ground nodes are shared by the wall nodes around them, each one tests its own facing
+        bool bAdded = false;
+        const int32 GroundNode = Builder.FindOrAddGroundNode(StandLocation, MergeDistance, bAdded);
+
+        PlaceStanding(StandLocation, Facing);
+
+        if (Movement->CanStartClimbing())
+        {
+            const FHitResult& EyesHit = Movement->EyesTraceResult;
+            const int32 Target = Builder.FindNearestNode(EyesHit.ImpactPoint + EyesHit.ImpactNormal * CapsuleRadius, LinkSearchDistance, IsWallNode);
+            Builder.AddLink(GroundNode, Target, EClimbGraphLinkType::ClimbStart, GetActionCost(EClimbGraphLinkType::ClimbStart));
+        }
+
+        FVector VaultStart, VaultLand;
+        if (Movement->CanStartVaulting(VaultStart, VaultLand))
+        {
+            const int32 Target = Builder.FindOrAddGroundNode(VaultLand + FVector::UpVector * StandingHalfHeight, MergeDistance, bAdded);
+            Builder.AddLink(GroundNode, Target, EClimbGraphLinkType::Vault, GetActionCost(EClimbGraphLinkType::Vault));
+        }
+    }
+
+    //Ground behind each ledge, facing out: climb down onto the wall below the edge
+    for (const FClimbLedgeSegment& Segment : LedgeSegments)
+    {
+        const float Length = FVector::Dist(Segment.Start, Segment.End);
+        const int32 NumSamples = FMath::Max(1, FMath::FloorToInt(Length / Spacing));
+
+        for (int32 SampleIndex = 0; SampleIndex < NumSamples; SampleIndex++)
+        {
+            const FVector Edge = FMath::Lerp(Segment.Start, Segment.End, (SampleIndex + 0.5f) / NumSamples);
+
+            //CanClimbDownLedge wants the edge between its walkable surface ray and its ledge ray
+            const FVector Behind = Edge - Segment.OutwardNormal * (Movement->ClimbDownWalkableSurfaceTraceOffset + Movement->ClimbDownLedgeTraceOffset * 0.5f);
+
+            FVector StandLocation;
+            if (!FindFloor(Behind + FVector::UpVector * StandingHalfHeight, StandingHalfHeight * 2.0f, StandLocation)) { continue; }
+
+            PlaceStanding(StandLocation, Segment.OutwardNormal);
+            if (!Movement->CanClimbDownLedge()) { continue; }
+
+            const FVector BelowEdge = Edge + Segment.OutwardNormal * CapsuleRadius - FVector::UpVector * Movement->ClimbCapsuleTraceHeight;
+            const int32 Target = Builder.FindNearestNode(BelowEdge, LinkSearchDistance,
+                [&Edge](const FClimbGraphNode& Other) { return Other.Type == EClimbGraphNodeType::Wall && Other.Location.Z < Edge.Z; });
+            if (Target == INDEX_NONE) { continue; }
+
+            bool bAdded = false;
+            const int32 GroundNode = Builder.FindOrAddGroundNode(StandLocation, MergeDistance, bAdded);
+            Builder.AddLink(GroundNode, Target, EClimbGraphLinkType::ClimbDownLedge, GetActionCost(EClimbGraphLinkType::ClimbDownLedge));
+        }
+    }
+
+    const FString ObjectPath = UClimbGraphSubsystem::GetGraphDataPath(MapPackage->GetName());
+    const FString PackageName = FPackageName::ObjectPathToPackageName(ObjectPath);
+    const FString AssetName = FPackageName::ObjectPathToObjectName(ObjectPath);
+
+    //Overwrite in place so references to the asset survive a rebuild
+    UClimbGraphData* GraphData = LoadObject<UClimbGraphData>(nullptr, *ObjectPath, nullptr, LOAD_NoWarn | LOAD_Quiet);
+    const bool bCreated = GraphData == nullptr;
+
+    if (bCreated)
+    {
+        GraphData = NewObject<UClimbGraphData>(CreatePackage(*PackageName), *AssetName, RF_Public | RF_Standalone);
+    }
+
+    GraphData->SourceMap = MapPackage->GetName();
+    GraphData->CellSize = CellSize;
+    GraphData->StandingHalfHeight = StandingHalfHeight;
+    GraphData->Nodes = MoveTemp(Builder.Nodes);
+    GraphData->Links.Reset();
+    GraphData->Routes.Reset();
+
+    //Links grouped by their node, and the fastest link for the A* heuristic
+    float HeuristicSpeed = 1.0f;
+    for (int32 NodeIndex = 0; NodeIndex < GraphData->Nodes.Num(); NodeIndex++)
+    {
+        FClimbGraphNode& Node = GraphData->Nodes[NodeIndex];
+        Node.FirstLink = GraphData->Links.Num();
+        Node.NumLinks = Builder.NodeLinks[NodeIndex].Num();
+        GraphData->Links.Append(Builder.NodeLinks[NodeIndex]);
+
+        for (const FClimbGraphLink& Link : Builder.NodeLinks[NodeIndex])
+        {
+            const float Distance = FVector::Dist(Node.Location, GraphData->Nodes[Link.To].Location);
+            HeuristicSpeed = FMath::Max(HeuristicSpeed, Distance / FMath::Max(Link.Cost, KINDA_SMALL_NUMBER));
+        }
+    }
+    GraphData->HeuristicSpeed = HeuristicSpeed;
+
+    //Nav link routes, the cheapest one between each pair of route cells is enough for the nav mesh
+    FClimbGraphPathfinder Pathfinder;
+    TArray<FClimbGraphRoute> Routes;
+    TMap<TPair<FIntVector, FIntVector>, int32> RouteByCells;
+    const float InvRouteCellSize = 1.0f / FMath::Max(RouteCellSize, 1.0f);
+
+    auto GetRouteCell = [InvRouteCellSize](const FVector& Location)
+    {
+        return FIntVector(FMath::FloorToInt(Location.X * InvRouteCellSize), FMath::FloorToInt(Location.Y * InvRouteCellSize), FMath::FloorToInt(Location.Z * InvRouteCellSize));
+    };
+
+    for (int32 NodeIndex = 0; NodeIndex < GraphData->Nodes.Num(); NodeIndex++)
+    {
+        if (GraphData->Nodes[NodeIndex].Type != EClimbGraphNodeType::Ground || GraphData->Nodes[NodeIndex].NumLinks == 0) { continue; }
+
+        Routes.Reset();
+        Pathfinder.FindGroundRoutes(*GraphData, NodeIndex, Routes);
+
+        for (const FClimbGraphRoute& Route : Routes)
+        {
+            const FVector& From = GraphData->Nodes[Route.From].Location;
+            const FVector& To = GraphData->Nodes[Route.To].Location;
+            if (FVector::Dist(From, To) < Spacing) { continue; }
+
+            const TPair<FIntVector, FIntVector> Cells(GetRouteCell(From), GetRouteCell(To));
+            if (const int32* Existing = RouteByCells.Find(Cells))
+            {
+                if (GraphData->Routes[*Existing].Cost > Route.Cost) { GraphData->Routes[*Existing] = Route; }
+                continue;
+            }
+
+            RouteByCells.Add(Cells, GraphData->Routes.Add(Route));
+        }
+    }
+
+    if (bCreated)
+    {
+        FAssetRegistryModule::AssetCreated(GraphData);
+    }
+
+    UPackage* Package = GraphData->GetPackage();
+    Package->MarkPackageDirty();
+
+    FSavePackageArgs SaveArgs;
+    SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+    const FString PackageFileName = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetAssetPackageExtension());
+
+    if (!UPackage::SavePackage(Package, GraphData, *PackageFileName, SaveArgs))
+    {
+        UE_LOG(LogClimb, Error, TEXT("Failed to save %s"), *PackageFileName);
+        return 1;
+    }
+
+    int32 LinkCounts[(int32)EClimbGraphLinkType::Num] = {};
+    for (const FClimbGraphLink& Link : GraphData->Links)
+    {
+        LinkCounts[(int32)Link.Type]++;
+    }
+
+    UE_LOG(LogClimb, Display, TEXT("Built climb graph of %s into %s: %d wall and %d ground nodes from %d wall samples, %d routes"),
+        *MapPath, *PackageName, NumWallNodes, GraphData->Nodes.Num() - NumWallNodes, WallSamples.Num(), GraphData->Routes.Num());
+
+    for (int32 LinkType = 0; LinkType < (int32)EClimbGraphLinkType::Num; LinkType++)
+    {
+        UE_LOG(LogClimb, Display, TEXT("    %-16s %d links"), *StaticEnum<EClimbGraphLinkType>()->GetNameStringByValue(LinkType), LinkCounts[LinkType]);
+    }
+
+    return 0;
+#else
+    return 1;
+#endif
+}
@@ -0,0 +1,128 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Commandlets/ClimbLedgeExtractCommandlet.h"
+#include "PeakPursuit/PeakPursuit.h"
+#include "Climb/ClimbSettings.h"
+#include "Data/ClimbLedgeData.h"
+#include "Subsystems/ClimbLedgeSubsystem.h"
+#include "Climb/ClimbMeshUtils.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Misc/PackageName.h"
+#include "UObject/SavePackage.h"
+
+
+UClimbLedgeExtractCommandlet::UClimbLedgeExtractCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+
+int32 UClimbLedgeExtractCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+    FString MapPath = TEXT("/Game/ThirdPerson/Maps/ThirdPersonMap");
+    FString CharacterClassPath = GetDefault<UClimbSettings>()->ClimbCharacterClass.ToString();
+    float CellSize = 200.0f;
+    float MinLength = 20.0f;
+
+    FParse::Value(*Params, TEXT("Map="), MapPath);
+    FParse::Value(*Params, TEXT("Character="), CharacterClassPath);
+    FParse::Value(*Params, TEXT("CellSize="), CellSize);
+    FParse::Value(*Params, TEXT("MinLength="), MinLength);
+
+    TArray<TEnumAsByte<EObjectTypeQuery>> ClimbableSurfaceTypes;
+    if (!ClimbMeshUtils::GetClimbableSurfaceTypes(CharacterClassPath, ClimbableSurfaceTypes))
+    {
+        UE_LOG(LogClimb, Error, TEXT("No ClimbableSurfaceTypes found on %s"), *CharacterClassPath);
+        return 1;
+    }
+
+    UPackage* MapPackage = LoadPackage(nullptr, *MapPath, LOAD_None);
+    UWorld* World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+
+    if (!World || !World->PersistentLevel)
+    {
+        UE_LOG(LogClimb, Error, TEXT("Failed to load map %s"), *MapPath);
+        return 1;
+    }
+
+    //Same thresholds as the walkable floor and the climbable wall checks at runtime
+    const float WalkableFloorZ = 0.71f;
+    const float MaxWallNormalZ = 0.5f;
+
+    TArray<FClimbLedgeSegment> Segments;
+    TArray<FVector> Positions;
+    TArray<int32> Indices;
+    int32 NumComponents = 0;
+
+    for (const AActor* Actor : World->PersistentLevel->Actors)
+    {
+        if (!Actor) { continue; }
+
+        TArray<UStaticMeshComponent*> MeshComponents;
+        Actor->GetComponents(MeshComponents);
+
+        for (const UStaticMeshComponent* MeshComponent : MeshComponents)
+        {
+            if (MeshComponent->GetCollisionEnabled() == ECollisionEnabled::NoCollision) { continue; }
+
+            const EObjectTypeQuery ObjectType = UEngineTypes::ConvertToObjectType(MeshComponent->GetCollisionObjectType());
+            if (!ClimbableSurfaceTypes.Contains(ObjectType)) { continue; }
+
+            if (!ClimbMeshUtils::GatherTriangles(MeshComponent->GetStaticMesh(), Positions, Indices)) { continue; }
+
+            ClimbMeshUtils::ExtractLedgeSegments(Positions, Indices, MeshComponent->GetComponentTransform(), WalkableFloorZ, MaxWallNormalZ, MinLength, Segments);
+            NumComponents++;
+        }
+    }
+
+    const FString ObjectPath = UClimbLedgeSubsystem::GetLedgeDataPath(MapPackage->GetName());
+    const FString PackageName = FPackageName::ObjectPathToPackageName(ObjectPath);
+    const FString AssetName = FPackageName::ObjectPathToObjectName(ObjectPath);
+
+    //Overwrite in place so references to the asset survive a re-extract
+    UClimbLedgeData* LedgeData = LoadObject<UClimbLedgeData>(nullptr, *ObjectPath, nullptr, LOAD_NoWarn | LOAD_Quiet);
+    const bool bCreated = LedgeData == nullptr;
+
+    if (bCreated)
+    {
+        LedgeData = NewObject<UClimbLedgeData>(CreatePackage(*PackageName), *AssetName, RF_Public | RF_Standalone);
+    }
+
+    UPackage* Package = LedgeData->GetPackage();
+
+    LedgeData->SourceMap = MapPackage->GetName();
+    LedgeData->CellSize = CellSize;
+    LedgeData->Segments = MoveTemp(Segments);
+
+    if (bCreated)
+    {
+        FAssetRegistryModule::AssetCreated(LedgeData);
+    }
+
+    Package->MarkPackageDirty();
+
+    FSavePackageArgs SaveArgs;
+    SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+    const FString PackageFileName = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetAssetPackageExtension());
+
+    if (!UPackage::SavePackage(Package, LedgeData, *PackageFileName, SaveArgs))
+    {
+        UE_LOG(LogClimb, Error, TEXT("Failed to save %s"), *PackageFileName);
+        return 1;
+    }
+
+    UE_LOG(LogClimb, Display, TEXT("Extracted %d ledges from %d climbable meshes of %s into %s"), LedgeData->Segments.Num(), NumComponents, *MapPath, *PackageName);
+    return 0;
+#else
+    return 1;
+#endif
+}
@@ -0,0 +1,254 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Commandlets/ClimbProxyBuildCommandlet.h"
+#include "PeakPursuit/PeakPursuit.h"
+#include "Climb/ClimbSettings.h"
+#include "Data/ClimbProxyData.h"
+#include "Climb/ClimbMeshUtils.h"
+#include "Engine/StaticMesh.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Misc/PackageName.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/SavePackage.h"
+
+#if WITH_EDITOR
+#include "MeshDescription.h"
+#include "StaticMeshAttributes.h"
+#include "StaticMeshOperations.h"
+#include "OverlappingCorners.h"
+#include "Engine/MeshMerging.h"
+#include "IMeshReductionInterfaces.h"
+#include "IMeshReductionManagerModule.h"
+
+
+namespace ClimbProxyBuild
+{
+    static bool SaveAsset(UObject* Asset)
+    {
+        UPackage* Package = Asset->GetPackage();
+        Package->MarkPackageDirty();
+
+        FSavePackageArgs SaveArgs;
+        SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+        const FString PackageFileName = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension());
+
+        if (!UPackage::SavePackage(Package, Asset, *PackageFileName, SaveArgs))
+        {
+            UE_LOG(LogClimb, Error, TEXT("Failed to save %s"), *PackageFileName);
+            return false;
+        }
+        return true;
+    }
+
+    //Overwrite in place so components and proxy data pointing at the proxy survive a rebuild
+    static UStaticMesh* WriteProxyMesh(const FString& PackageName, const FString& AssetName, FMeshDescription&& MeshDescription)
+    {
+        const FString ObjectPath = PackageName + TEXT(".") + AssetName;
+        UStaticMesh* ProxyMesh = LoadObject<UStaticMesh>(nullptr, *ObjectPath, nullptr, LOAD_NoWarn | LOAD_Quiet);
+        const bool bCreated = ProxyMesh == nullptr;
+
+        if (bCreated)
+        {
+            ProxyMesh = NewObject<UStaticMesh>(CreatePackage(*PackageName), *AssetName, RF_Public | RF_Standalone);
+        }
+
+        ProxyMesh->PreEditChange(nullptr);
+        ProxyMesh->SetNumSourceModels(1);
+
+        //Collision only, nothing here is ever rendered or lightmapped
+        FStaticMeshSourceModel& SourceModel = ProxyMesh->GetSourceModel(0);
+        SourceModel.BuildSettings.bRecomputeNormals = false;
+        SourceModel.BuildSettings.bRecomputeTangents = false;
+        SourceModel.BuildSettings.bGenerateLightmapUVs = false;
+        ProxyMesh->SetStaticMaterials({ FStaticMaterial(nullptr, UClimbProxyData::GetCollisionProfileName()) });
+
+        ProxyMesh->CreateMeshDescription(0, MoveTemp(MeshDescription));
+        ProxyMesh->CommitMeshDescription(0);
+
+        //The shell is the collision, no simple shapes to fall back on
+        ProxyMesh->CreateBodySetup();
+        UBodySetup* BodySetup = ProxyMesh->GetBodySetup();
+        BodySetup->CollisionTraceFlag = CTF_UseComplexAsSimple;
+        BodySetup->DefaultInstance.SetCollisionProfileName(UClimbProxyData::GetCollisionProfileName());
+
+        ProxyMesh->Build(true);
+        ProxyMesh->PostEditChange();
+
+        if (bCreated)
+        {
+            FAssetRegistryModule::AssetCreated(ProxyMesh);
+        }
+
+        return SaveAsset(ProxyMesh) ? ProxyMesh : nullptr;
+    }
+}
+#endif
+
+
+UClimbProxyBuildCommandlet::UClimbProxyBuildCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+
+int32 UClimbProxyBuildCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+    FString ContentPath = TEXT("/Game/ModularLostRuinKit");
+    FString NameFilters = TEXT("SM_Wall_Rock_Set_,SM_Plate_Rock_,SM_Relic_Rock_");
+    FString CharacterClassPath = GetDefault<UClimbSettings>()->ClimbCharacterClass.ToString();
+    FString ExcludedSlotNames = TEXT("Foliage,Leaf,Grass,Ivy,Vine");
+    FString OutPath = TEXT("/Game/ClimbData/Proxies");
+    float PercentTriangles = 0.1f;
+    int32 MaxTriangles = 512;
+    int32 SmoothIterations = 1;
+    float SampleSpacing = 10.0f;
+
+    FParse::Value(*Params, TEXT("Path="), ContentPath);
+    FParse::Value(*Params, TEXT("Filter="), NameFilters);
+    FParse::Value(*Params, TEXT("Character="), CharacterClassPath);
+    FParse::Value(*Params, TEXT("ExcludeSlots="), ExcludedSlotNames);
+    FParse::Value(*Params, TEXT("OutPath="), OutPath);
+    FParse::Value(*Params, TEXT("PercentTriangles="), PercentTriangles);
+    FParse::Value(*Params, TEXT("MaxTriangles="), MaxTriangles);
+    FParse::Value(*Params, TEXT("SmoothIterations="), SmoothIterations);
+    FParse::Value(*Params, TEXT("SampleSpacing="), SampleSpacing);
+
+    TArray<FString> NamePrefixes;
+    NameFilters.ParseIntoArray(NamePrefixes, TEXT(","));
+
+    TArray<FString> ExcludedSlots;
+    ExcludedSlotNames.ParseIntoArray(ExcludedSlots, TEXT(","));
+
+    TArray<TEnumAsByte<EObjectTypeQuery>> ClimbableSurfaceTypes;
+    if (!ClimbMeshUtils::GetClimbableSurfaceTypes(CharacterClassPath, ClimbableSurfaceTypes))
+    {
+        UE_LOG(LogClimb, Error, TEXT("No ClimbableSurfaceTypes found on %s"), *CharacterClassPath);
+        return 1;
+    }
+
+    IMeshReduction* MeshReduction = FModuleManager::LoadModuleChecked<IMeshReductionManagerModule>(TEXT("MeshReductionInterface")).GetStaticMeshReductionInterface();
+    if (!MeshReduction)
+    {
+        UE_LOG(LogClimb, Error, TEXT("No static mesh reduction interface available"));
+        return 1;
+    }
+
+    FMeshReductionSettings ReductionSettings;
+    ReductionSettings.PercentTriangles = FMath::Clamp(PercentTriangles, 0.0f, 1.0f);
+    ReductionSettings.MaxNumOfTriangles = FMath::Max(MaxTriangles, 4);
+    ReductionSettings.TerminationCriterion = EStaticMeshReductionTerimationCriterion::Triangles;
+    ReductionSettings.bRecalculateNormals = true;
+
+    IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+    AssetRegistry.SearchAllAssets(true);
+
+    FARFilter Filter;
+    Filter.ClassPaths.Add(UStaticMesh::StaticClass()->GetClassPathName());
+    Filter.PackagePaths.Add(FName(*ContentPath));
+    Filter.bRecursivePaths = true;
+
+    TArray<FAssetData> MeshAssets;
+    AssetRegistry.GetAssets(Filter, MeshAssets);
+
+    //Foliage is matched on the material slot name, everything else is kept as climbable rock
+    auto IsKeptSection = [&ExcludedSlots](FName MaterialSlotName)
+    {
+        const FString SlotName = MaterialSlotName.ToString();
+        return !ExcludedSlots.ContainsByPredicate([&SlotName](const FString& Excluded) { return SlotName.Contains(Excluded); });
+    };
+
+    FString Report = TEXT("Mesh,SourceTriangles,ExcludedTriangles,ProxyTriangles,MeanDeviation,MaxDeviation\n");
+    int32 NumBuilt = 0;
+    int64 TotalSourceTriangles = 0;
+    int64 TotalProxyTriangles = 0;
+    float WorstDeviation = 0.0f;
+
+    for (const FAssetData& MeshAsset : MeshAssets)
+    {
+        const FString AssetName = MeshAsset.AssetName.ToString();
+        const bool bNameMatches = NamePrefixes.IsEmpty() || NamePrefixes.ContainsByPredicate([&AssetName](const FString& Prefix) { return AssetName.StartsWith(Prefix); });
+
+        if (!bNameMatches) { continue; }
+
+        UStaticMesh* Mesh = Cast<UStaticMesh>(MeshAsset.GetAsset());
+        if (!ClimbMeshUtils::IsClimbableMesh(Mesh, ClimbableSurfaceTypes)) { continue; }
+
+        TArray<FVector> SourcePositions;
+        TArray<int32> SourceIndices;
+        if (!ClimbMeshUtils::GatherTriangles(Mesh, SourcePositions, SourceIndices, IsKeptSection))
+        {
+            UE_LOG(LogClimb, Warning, TEXT("%s has no climbable sections left after excluding foliage"), *AssetName);
+            continue;
+        }
+
+        FMeshDescription SourceDescription;
+        ClimbMeshUtils::BuildMeshDescription(SourcePositions, SourceIndices, NAME_None, SourceDescription);
+
+        FOverlappingCorners OverlappingCorners;
+        FStaticMeshOperations::FindOverlappingCorners(OverlappingCorners, SourceDescription, THRESH_POINTS_ARE_SAME);
+
+        FMeshDescription ReducedDescription;
+        FStaticMeshAttributes(ReducedDescription).Register();
+        float ReducerDeviation = 0.0f;
+        MeshReduction->ReduceMeshDescription(ReducedDescription, ReducerDeviation, SourceDescription, OverlappingCorners, ReductionSettings);
+
+        TArray<FVector> ProxyPositions;
+        TArray<int32> ProxyIndices;
+        if (!ClimbMeshUtils::GatherTriangles(ReducedDescription, ProxyPositions, ProxyIndices, [](FName) { return true; }))
+        {
+            UE_LOG(LogClimb, Warning, TEXT("Reducing %s left no triangles"), *AssetName);
+            continue;
+        }
+
+        //Relaxing takes the reduction's spikes off the shell, the deviation below shows what it cost
+        ClimbMeshUtils::SmoothTriangles(ProxyPositions, ProxyIndices, SmoothIterations);
+
+        UClimbProxyData* ProxyData = NewObject<UClimbProxyData>(Mesh, NAME_None, RF_Public);
+        ProxyData->SourceTriangles = Mesh->GetMeshDescription(0)->Triangles().Num();
+        ProxyData->ExcludedTriangles = ProxyData->SourceTriangles - SourceIndices.Num() / 3;
+        ProxyData->ProxyTriangles = ProxyIndices.Num() / 3;
+        ClimbMeshUtils::MeasureDeviation(SourcePositions, SourceIndices, ProxyPositions, ProxyIndices, SampleSpacing, ProxyData->MeanDeviation, ProxyData->MaxDeviation);
+
+        FMeshDescription ProxyDescription;
+        ClimbMeshUtils::BuildMeshDescription(ProxyPositions, ProxyIndices, UClimbProxyData::GetCollisionProfileName(), ProxyDescription);
+
+        ProxyData->ProxyMesh = ClimbProxyBuild::WriteProxyMesh(OutPath / AssetName + TEXT("_ClimbProxy"), AssetName + TEXT("_ClimbProxy"), MoveTemp(ProxyDescription));
+        if (!ProxyData->ProxyMesh) { continue; }
+
+        Mesh->RemoveUserDataOfClass(UClimbProxyData::StaticClass());
+        Mesh->AddAssetUserData(ProxyData);
+
+        if (!ClimbProxyBuild::SaveAsset(Mesh)) { continue; }
+
+        UE_LOG(LogClimb, Display, TEXT("%s: %d -> %d triangles (%d foliage excluded), deviation mean %.2f max %.2f"),
+            *AssetName, ProxyData->SourceTriangles, ProxyData->ProxyTriangles, ProxyData->ExcludedTriangles, ProxyData->MeanDeviation, ProxyData->MaxDeviation);
+
+        Report += FString::Printf(TEXT("%s,%d,%d,%d,%.3f,%.3f\n"), *AssetName, ProxyData->SourceTriangles, ProxyData->ExcludedTriangles,
+            ProxyData->ProxyTriangles, ProxyData->MeanDeviation, ProxyData->MaxDeviation);
+
+        NumBuilt++;
+        TotalSourceTriangles += ProxyData->SourceTriangles;
+        TotalProxyTriangles += ProxyData->ProxyTriangles;
+        WorstDeviation = FMath::Max(WorstDeviation, ProxyData->MaxDeviation);
+    }
+
+    const FString ReportPath = FPaths::ProjectSavedDir() / TEXT("ClimbProxies/Report.csv");
+    if (!FFileHelper::SaveStringToFile(Report, *ReportPath))
+    {
+        UE_LOG(LogClimb, Error, TEXT("Failed to write %s"), *ReportPath);
+    }
+
+    UE_LOG(LogClimb, Display, TEXT("Built %d climb proxies, %lld -> %lld triangles, worst deviation %.2f, report in %s"),
+        NumBuilt, TotalSourceTriangles, TotalProxyTriangles, WorstDeviation, *ReportPath);
+    return 0;
+#else
+    return 1;
+#endif
+}
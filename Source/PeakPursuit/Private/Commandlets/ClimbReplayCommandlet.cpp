@@ -0,0 +1,166 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Commandlets/ClimbReplayCommandlet.h"
+#include "PeakPursuit/PeakPursuit.h"
+#include "Climb/ClimbSettings.h"
+#include "PeakPursuitCharacter.h"
+#include "Components/ClimbMovementComponent.h"
+#include "Climb/ClimbInputRecording.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+
+UClimbReplayCommandlet::UClimbReplayCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+
+int32 UClimbReplayCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+    FString RecordingPath;
+    FString MapPath;
+    FString OutputPath;
+    FString CharacterClassPath;
+    float Tolerance = 1.0f;
+
+    FParse::Value(*Params, TEXT("Recording="), RecordingPath);
+    FParse::Value(*Params, TEXT("Map="), MapPath);
+    FParse::Value(*Params, TEXT("Output="), OutputPath);
+    FParse::Value(*Params, TEXT("Character="), CharacterClassPath);
+    FParse::Value(*Params, TEXT("Tolerance="), Tolerance);
+
+    FClimbInputRecording Recording;
+    if (RecordingPath.IsEmpty() || !Recording.LoadFromFile(RecordingPath))
+    {
+        UE_LOG(LogClimb, Error, TEXT("Could not read climb input recording '%s'"), *RecordingPath);
+        return 1;
+    }
+
+    if (MapPath.IsEmpty()) { MapPath = Recording.MapName; }
+    if (CharacterClassPath.IsEmpty()) { CharacterClassPath = Recording.CharacterClassPath; }
+    //Recordings made before the pawn class was stored
+    if (CharacterClassPath.IsEmpty()) { CharacterClassPath = GetDefault<UClimbSettings>()->ClimbCharacterClass.ToString(); }
+    if (OutputPath.IsEmpty()) { OutputPath = FPaths::ChangeExtension(RecordingPath, TEXT("csv")); }
+
+    UClass* CharacterClass = LoadClass<APeakPursuitCharacter>(nullptr, *CharacterClassPath);
+    UPackage* MapPackage = LoadPackage(nullptr, *MapPath, LOAD_None);
+    UWorld* World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+
+    if (!CharacterClass || !World)
+    {
+        UE_LOG(LogClimb, Error, TEXT("Could not load %s or %s"), *CharacterClassPath, *MapPath);
+        return 1;
+    }
+
+    World->AddToRoot();
+    World->WorldType = EWorldType::Game;
+    World->InitWorld(UWorld::InitializationValues().AllowAudioPlayback(false).CreatePhysicsScene(true).ShouldSimulatePhysics(true));
+    World->UpdateWorldComponents(true, false);
+
+    FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+    WorldContext.SetCurrentWorld(World);
+
+    const FURL URL;
+    World->SetGameMode(URL);
+    World->InitializeActorsForPlay(URL);
+    World->BeginPlay();
+
+    FActorSpawnParameters SpawnParameters;
+    SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    APeakPursuitCharacter* Character = World->SpawnActor<APeakPursuitCharacter>(CharacterClass, Recording.StartTransform, SpawnParameters);
+    APlayerController* PlayerController = World->SpawnActor<APlayerController>();
+    PlayerController->Possess(Character);
+    PlayerController->SetControlRotation(Recording.StartControlRotation);
+
+    UClimbMovementComponent* ClimbMovement = Character->GetClimbMovementComponent();
+    if (Recording.bStartClimbing)
+    {
+        ClimbMovement->StartClimbingOnSurface(Recording.StartSurfaceLocation, Recording.StartSurfaceNormal);
+    }
+
+    FMath::RandInit(Recording.RandomSeed);
+    FApp::SetUseFixedTimeStep(true);
+
+    FString Report = TEXT("Frame,DeltaTime,TickMs,ClimbQueries,Climbing,Drift\n");
+    int32 FirstDivergentFrame = INDEX_NONE;
+    double TotalTickMs = 0.0;
+    double MaxTickMs = 0.0;
+    int64 TotalQueries = 0;
+
+    for (int32 FrameIndex = 0; FrameIndex < Recording.Frames.Num(); FrameIndex++)
+    {
+        const FClimbInputFrame& Frame = Recording.Frames[FrameIndex];
+
+        //Recorded location was taken at the same point of the frame, before movement
+        const float Drift = FVector::Dist(Character->GetActorLocation(), FVector(Frame.Location));
+        if (Drift > Tolerance && FirstDivergentFrame == INDEX_NONE)
+        {
+            FirstDivergentFrame = FrameIndex;
+        }
+
+        Character->ApplyRecordedInput(Frame);
+
+        FApp::SetFixedDeltaTime(Frame.DeltaTime);
+        FApp::SetDeltaTime(Frame.DeltaTime);
+        FApp::SetCurrentTime(FApp::GetCurrentTime() + Frame.DeltaTime);
+
+        const int32 QueriesBefore = ClimbMovement->GetClimbQuery().GetNumQueries();
+        const double StartSeconds = FPlatformTime::Seconds();
+
+        World->Tick(LEVELTICK_All, Frame.DeltaTime);
+
+        const double TickMs = (FPlatformTime::Seconds() - StartSeconds) * 1000.0;
+        const int32 FrameQueries = ClimbMovement->GetClimbQuery().GetNumQueries() - QueriesBefore;
+
+        TotalTickMs += TickMs;
+        MaxTickMs = FMath::Max(MaxTickMs, TickMs);
+        TotalQueries += FrameQueries;
+
+        Report += FString::Printf(TEXT("%d,%f,%.3f,%d,%d,%.3f\n"), FrameIndex, Frame.DeltaTime, TickMs, FrameQueries, ClimbMovement->IsClimbing() ? 1 : 0, Drift);
+    }
+
+    const FTransform FinalTransform = Character->GetActorTransform();
+    const float FinalDrift = FVector::Dist(FinalTransform.GetLocation(), Recording.FinalTransform.GetLocation());
+    const float FinalAngle = FMath::RadiansToDegrees(FinalTransform.GetRotation().AngularDistance(Recording.FinalTransform.GetRotation()));
+    const bool bDiverged = FinalDrift > Tolerance || FinalAngle > Tolerance;
+
+    GEngine->DestroyWorldContext(World);
+    World->DestroyWorld(false);
+    World->RemoveFromRoot();
+
+    if (!FFileHelper::SaveStringToFile(Report, *OutputPath))
+    {
+        UE_LOG(LogClimb, Error, TEXT("Failed to write %s"), *OutputPath);
+        return 1;
+    }
+
+    const int32 NumFrames = FMath::Max(Recording.Frames.Num(), 1);
+    UE_LOG(LogClimb, Display, TEXT("Replayed %d frames: tick %.3fms mean, %.3fms max, %.2f climb queries per frame. Report in %s"),
+        Recording.Frames.Num(), TotalTickMs / NumFrames, MaxTickMs, (double)TotalQueries / NumFrames, *OutputPath);
+
+    if (FirstDivergentFrame != INDEX_NONE)
+    {
+        UE_LOG(LogClimb, Warning, TEXT("Playback drifted more than %.2f from the recording at frame %d"), Tolerance, FirstDivergentFrame);
+    }
+
+    if (bDiverged)
+    {
+        UE_LOG(LogClimb, Error, TEXT("Final transform diverged: %.2f units, %.2f degrees"), FinalDrift, FinalAngle);
+        return 1;
+    }
+
+    return 0;
+#else
+    return 1;
+#endif
+}
@@ -0,0 +1,109 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Commandlets/ClimbSurfaceFieldBakeCommandlet.h"
+#include "PeakPursuit/PeakPursuit.h"
+#include "Climb/ClimbSettings.h"
+#include "Data/ClimbSurfaceField.h"
+#include "Climb/ClimbMeshUtils.h"
+#include "Engine/StaticMesh.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Misc/PackageName.h"
+#include "UObject/SavePackage.h"
+
+
+UClimbSurfaceFieldBakeCommandlet::UClimbSurfaceFieldBakeCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+
+int32 UClimbSurfaceFieldBakeCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+    FString ContentPath = TEXT("/Game/ModularLostRuinKit");
+    FString NameFilters = TEXT("SM_Wall_Rock_Set_,SM_Relic_Rock_");
+    FString CharacterClassPath = GetDefault<UClimbSettings>()->ClimbCharacterClass.ToString();
+    float VoxelSize = 10.0f;
+    float MaxDistance = 100.0f;
+
+    FParse::Value(*Params, TEXT("Path="), ContentPath);
+    FParse::Value(*Params, TEXT("Filter="), NameFilters);
+    FParse::Value(*Params, TEXT("Character="), CharacterClassPath);
+    FParse::Value(*Params, TEXT("VoxelSize="), VoxelSize);
+    FParse::Value(*Params, TEXT("MaxDistance="), MaxDistance);
+
+    TArray<FString> NamePrefixes;
+    NameFilters.ParseIntoArray(NamePrefixes, TEXT(","));
+
+    TArray<TEnumAsByte<EObjectTypeQuery>> ClimbableSurfaceTypes;
+    if (!ClimbMeshUtils::GetClimbableSurfaceTypes(CharacterClassPath, ClimbableSurfaceTypes))
+    {
+        UE_LOG(LogClimb, Error, TEXT("No ClimbableSurfaceTypes found on %s"), *CharacterClassPath);
+        return 1;
+    }
+
+    IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+    AssetRegistry.SearchAllAssets(true);
+
+    FARFilter Filter;
+    Filter.ClassPaths.Add(UStaticMesh::StaticClass()->GetClassPathName());
+    Filter.PackagePaths.Add(FName(*ContentPath));
+    Filter.bRecursivePaths = true;
+
+    TArray<FAssetData> MeshAssets;
+    AssetRegistry.GetAssets(Filter, MeshAssets);
+
+    int32 NumBaked = 0;
+    int64 TotalBytes = 0;
+
+    for (const FAssetData& MeshAsset : MeshAssets)
+    {
+        const FString AssetName = MeshAsset.AssetName.ToString();
+        const bool bNameMatches = NamePrefixes.IsEmpty() || NamePrefixes.ContainsByPredicate([&AssetName](const FString& Prefix) { return AssetName.StartsWith(Prefix); });
+
+        if (!bNameMatches) { continue; }
+
+        UStaticMesh* Mesh = Cast<UStaticMesh>(MeshAsset.GetAsset());
+        if (!ClimbMeshUtils::IsClimbableMesh(Mesh, ClimbableSurfaceTypes)) { continue; }
+
+        Mesh->RemoveUserDataOfClass(UClimbSurfaceField::StaticClass());
+
+        UClimbSurfaceField* Field = NewObject<UClimbSurfaceField>(Mesh, NAME_None, RF_Public);
+        if (!Field->Bake(Mesh, VoxelSize, MaxDistance))
+        {
+            UE_LOG(LogClimb, Warning, TEXT("Failed to bake climb surface field for %s"), *AssetName);
+            continue;
+        }
+
+        Mesh->AddAssetUserData(Field);
+
+        UPackage* Package = Mesh->GetPackage();
+        Package->MarkPackageDirty();
+
+        FSavePackageArgs SaveArgs;
+        SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+        const FString PackageFileName = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension());
+
+        if (!UPackage::SavePackage(Package, Mesh, *PackageFileName, SaveArgs))
+        {
+            UE_LOG(LogClimb, Error, TEXT("Failed to save %s"), *PackageFileName);
+            continue;
+        }
+
+        const int64 FieldBytes = (int64)Field->Resolution.X * Field->Resolution.Y * Field->Resolution.Z * 4;
+        UE_LOG(LogClimb, Display, TEXT("%s: %dx%dx%d voxels, %lld KB"), *AssetName, Field->Resolution.X, Field->Resolution.Y, Field->Resolution.Z, FieldBytes / 1024);
+
+        NumBaked++;
+        TotalBytes += FieldBytes;
+    }
+
+    UE_LOG(LogClimb, Display, TEXT("Baked %d climb surface fields, %lld KB total"), NumBaked, TotalBytes / 1024);
+    return 0;
+#else
+    return 1;
+#endif
+}
@@ -2,7 +2,7 @@
 
 
 #include "Components/ClimbMovementComponent.h"
-#include "Kismet/KismetSystemLibrary.h"
+#include "PeakPursuit/PeakPursuit.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "PeakPursuit/DebugHelper.h"
 #include "PeakPursuit/PeakPursuitCharacter.h"
@@ -11,11 +11,57 @@
 #include "Animation/AnimInstance.h"
 #include "PeakPursuit/PeakPursuitCharacter.h"
 #include "MotionWarpingComponent.h"
+#include "Engine/World.h"
+#include "WorldCollision.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Data/ClimbSurfaceField.h"
+#include "DrawDebugHelpers.h"
+#include "HAL/IConsoleManager.h"
+#include "Climb/ClimbDiagnostics.h"
+#include "Climb/ClimbMathKernels.h"
+#include "Climb/ClimbStats.h"
+#include "Subsystems/ClimbLODSubsystem.h"
+#include "Subsystems/ClimbLedgeSubsystem.h"
+#include "Subsystems/ClimbProbeSubsystem.h"
+#include "Subsystems/ClimbablePrimitiveSubsystem.h"
+#include "Data/ClimbLedgeData.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+
+
+#if !UE_BUILD_SHIPPING
+static TAutoConsoleVariable<bool> CVarClimbCheckTickAllocations(
+    TEXT("climb.CheckTickAllocations"),
+    false,
+    TEXT("Warn when a climb tick that reused its probe buffers still hit the allocator. The counter is process wide, so run with few threads busy."));
+
+static TAutoConsoleVariable<float> CVarClimbNetStatsInterval(
+    TEXT("climb.NetStatsInterval"),
+    0.0f,
+    TEXT("Seconds between logs of corrections per minute and ServerMove bytes per second while climbing, per climber. 0 disables."));
+#endif
 
 
 void UClimbMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
     Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    UpdateClimbNetStats(DeltaTime);
+    UpdateClimbActionMontages(DeltaTime);
+    PublishAnimSnapshot();
+}
+
+
+void UClimbMovementComponent::PublishAnimSnapshot()
+{
+    AnimSnapshot.GroundSpeed = Velocity.Size2D();
+    AnimSnapshot.AirSpeed = Velocity.Z;
+    AnimSnapshot.ClimbVelocity = GetUnrotatedClimbVelocity();
+    AnimSnapshot.SurfaceNormal = CurrentClimbableSurfaceNormal;
+    AnimSnapshot.bIsAccelerating = !GetCurrentAcceleration().IsNearlyZero(0.0f);
+    AnimSnapshot.bIsFalling = IsFalling();
+    AnimSnapshot.bIsClimbing = IsClimbing();
 }
 
 
@@ -23,22 +69,58 @@ void UClimbMovementComponent::BeginPlay()
 {
     Super::BeginPlay();
 
+    UpdateClimbQueryTypes();
+
+#if WITH_CLIMB_PROBE_RECORDER
+    ClimbQuery.SetProbeRecorder(&ProbeRecorder);
+#endif
+
+    if (UClimbablePrimitiveSubsystem* ClimbablePrimitiveSubsystem = GetWorld()->GetSubsystem<UClimbablePrimitiveSubsystem>())
+    {
+        ClimbablePrimitiveSubsystem->RegisterObjectTypes(ClimbQuery.GetObjectQueryParams());
+        ClimbQuery.SetPrimitiveRegistry(ClimbablePrimitiveSubsystem);
+    }
+    StopClimbingMinDot = ClimbMathKernels::GetMinDotForAngle(DegreesSurfaceClimbingThreshold);
+
+    if (UClimbLODSubsystem* ClimbLODSubsystem = GetWorld()->GetSubsystem<UClimbLODSubsystem>())
+    {
+        ClimbLODSubsystem->RegisterClimber(this);
+    }
+
+    ClimbLedgeSubsystem = GetWorld()->GetSubsystem<UClimbLedgeSubsystem>();
+    ClimbProbeSubsystem = GetWorld()->GetSubsystem<UClimbProbeSubsystem>();
+
     OwningPlayerAnimInstance = CharacterOwner->GetMesh()->GetAnimInstance();
 
     if (OwningPlayerAnimInstance)
     {
         //DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnMontageEndedMCDelegate, UAnimMontage*, Montage, bool, bInterrupted);
+        OwningPlayerAnimInstance->OnMontageBlendingOut.AddDynamic(this, &UClimbMovementComponent::OnClimbMontageBlendingOut);
         OwningPlayerAnimInstance->OnMontageEnded.AddDynamic(this, &UClimbMovementComponent::OnClimbMontageEnded);
-        OwningPlayerAnimInstance->OnMontageBlendingOut.AddDynamic(this, &UClimbMovementComponent::OnClimbMontageEnded);
     }
 }
 
+void UClimbMovementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (UClimbLODSubsystem* ClimbLODSubsystem = GetWorld()->GetSubsystem<UClimbLODSubsystem>())
+    {
+        ClimbLODSubsystem->UnregisterClimber(this);
+    }
+
+    ReleaseClimbActionMontages();
+
+    Super::EndPlay(EndPlayReason);
+}
+
+
 void UClimbMovementComponent::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
 {
     Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
 
     float CapsuleHalfHeight = CharacterOwner->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight();
 
+    InvalidateClimbProbeCaches();
+
     if (IsClimbing())
     {
         bOrientRotationToMovement = false;
@@ -49,6 +131,10 @@ void UClimbMovementComponent::OnMovementModeChanged(EMovementMode PreviousMoveme
 
     if (PreviousMovementMode == MOVE_Custom && PreviousCustomMode == ECustomMovementMode::MOVE_Climb)
     {
+        //Any sweep still in flight belongs to the climb we just left
+        PendingClimbSweepHandle = FTraceHandle();
+        ClimbBaseContacts.Reset();
+
         bOrientRotationToMovement = true;
         CharacterOwner->GetCapsuleComponent()->SetCapsuleHalfHeight(CapsuleHalfHeight * 2.0f);
 
@@ -59,6 +145,16 @@ void UClimbMovementComponent::OnMovementModeChanged(EMovementMode PreviousMoveme
         StopMovementImmediately();
 
         OnExitClimbState.ExecuteIfBound();
+        DispatchClimbEvent(EClimbEvent::ClimbStopped);
+    }
+
+    if (IsClimbing())
+    {
+        DispatchClimbEvent(EClimbEvent::ClimbStarted);
+    }
+    else if (IsMovingOnGround())
+    {
+        DispatchClimbEvent(EClimbEvent::Landed);
     }
 
 }
@@ -111,56 +207,233 @@ float UClimbMovementComponent::GetMaxAcceleration() const
 
 void UClimbMovementComponent::PhysClimb(float deltaTime, int32 Iterations)
 {
+    CLIMB_SCOPE(PhysClimb);
+
     if (deltaTime < MIN_TICK_TIME)
     {
         return;
     }
 
-    //Process climbable surfaces
-    GetClimbableSurfaces();
-    ProcessClimbableSurfaceInfo();
+#if !UE_BUILD_SHIPPING
+    const uint64 AllocationsBeforeTick = ClimbDiagnostics::GetAllocationCount();
+#endif
+
+    FollowClimbBase();
 
-    //Check if character should stop climbing
-    if (ShouldStopClimbing() || HasReachFloor())
+    //Kinematic climbers follow the last surface they found and run a full climb tick every few ticks, which
+    //refreshes the surface and checks for the floor, the ledge and a surface that can no longer be climbed
+    if (ClimbLODTier == EClimbLODTier::Kinematic && !CurrentClimbableSurfaceNormal.IsZero())
     {
-        StopClimbing();
+        if (++TicksSinceSurfaceProbe < GetDefault<UClimbSettings>()->KinematicProbeInterval)
+        {
+            PhysClimbKinematic(deltaTime);
+            return;
+        }
+
+        TicksSinceSurfaceProbe = 0;
+    }
+
+    //Reduced climbers only refresh the surface every few ticks
+    const bool bSurfaceProbeDue = ClimbLODTier != EClimbLODTier::Reduced || ++TicksSinceSurfaceProbe >= GetDefault<UClimbSettings>()->ReducedProbeInterval;
+
+    ClimbQueryPlan.Begin(ClimbProbeReuseDistance, ClimbProbeReuseDegrees, !bSurfaceProbeDue);
+
+    //Probes that would hit the world need a slot of the frame's budget, denied climbers keep their cached probes
+    const double ProbeStartTime = FPlatformTime::Seconds();
+    const bool bProbeBudgeted = ClimbProbeSubsystem && GetDefault<UClimbSettings>()->bEnableProbeBudget
+        && bSurfaceProbeDue && SurfaceProbeCache.bValid && !ClimbQueryPlan.CanReuse(SurfaceProbeCache, UpdatedComponent->GetComponentTransform());
+    const EClimbProbePriority ProbePriority = ClimbProbeSubsystem ? UClimbProbeSubsystem::GetProbePriority(this) : EClimbProbePriority::Player;
+
+    if (bProbeBudgeted && !ClimbProbeSubsystem->AcquireProbeSlot(this, ProbePriority, ProbeFramesDeferred))
+    {
+        ProbeFramesDeferred++;
+        ClimbQueryPlan.bAllowStaleReuse = true;
+    }
+    else
+    {
+        ProbeFramesDeferred = 0;
+    }
+
+    //Sub-step so a 20-30 Hz server snaps and turns like a 60 Hz client. Only the first sub-step probes with the
+    //regular reuse distance, the following ones keep its hits until the capsule moved ClimbSubstepProbeReuseDistance
+    float RemainingTime = deltaTime;
+    bool bIssueSurfaceProbe = false;
+    bool bSampledSurfaceField = false;
+    const int32 FirstIteration = Iterations;
+
+    //Each sub-step is a single swept move, overlaps and attached components update once when the scope ends.
+    //PerformMovement already opens one when bEnableScopedMovementUpdates is set, this covers direct callers too
+    FScopedMovementUpdate ScopedClimbUpdate(UpdatedComponent, EScopedUpdate::DeferredUpdates);
+
+    while (RemainingTime >= MIN_TICK_TIME && Iterations < GetMaxClimbSimulationIterations() && IsClimbing())
+    {
+        Iterations++;
+        const float TimeTick = GetClimbSimulationTimeStep(RemainingTime, Iterations);
+        RemainingTime -= TimeTick;
+
+        if (Iterations > FirstIteration + 1)
+        {
+            ClimbQueryPlan.ReuseDistance = FMath::Max(ClimbProbeReuseDistance, ClimbSubstepProbeReuseDistance);
+        }
+
+        //Process climbable surfaces, from the baked field or last frame's async sweep when there is one
+        if (ClimbQueryPlan.ShouldIssue(SurfaceProbeCache, UpdatedComponent->GetComponentTransform()))
+        {
+            bIssueSurfaceProbe = true;
+            TicksSinceSurfaceProbe = 0;
+            bSampledSurfaceField = bUseClimbSurfaceFields && SampleClimbableSurfaceField();
+
+            if (bSampledSurfaceField)
+            {
+                if (bValidateClimbSurfaceFields) { ValidateClimbableSurfaceField(); }
+            }
+            else if (!bUseAsyncClimbSweep || !ConsumeAsyncClimbableSurfaces())
+            {
+                GetClimbableSurfaces();
+            }
+            ClimbBaseContacts.Store(ClimbTraceResults);
+            SurfaceProbeCache.Store(UpdatedComponent->GetComponentTransform(), !ClimbTraceResults.IsEmpty(), ClimbBaseContacts.GetBase());
+            ProcessClimbableSurfaceInfo();
+        }
+
+        //Check if character should stop climbing, the floor only in the states that can reach it
+        if (ShouldStopClimbing() || (ClimbStateMachine.NeedsProbe(EClimbProbe::Floor) && HasReachFloor()))
+        {
+            StopClimbing();
+        }
+
+        RestorePreAdditiveRootMotionVelocity();
+
+        if (!HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity())
+        {
+            //Define max climb speed and acceleration
+            CalcVelocity(TimeTick, 0.0f, true, MaxBrakingDeceleration);
+        }
+
+        ApplyRootMotionToVelocity(TimeTick);
+
+        MoveAlongClimbableSurface(TimeTick);
+    }
+
+    if (ClimbStateMachine.NeedsProbe(EClimbProbe::Ledge) && HasReachLedge())
+    {
+        PlayClimbAction(EClimbAction::ClimbToTop);
+    }
+
+    //Kick off next frame's surface sweep, a capsule at rest will keep reusing its hits instead
+    if (bUseAsyncClimbSweep && bIssueSurfaceProbe && !bSampledSurfaceField && IsClimbing())
+    {
+        RequestAsyncClimbableSurfaces(deltaTime);
+    }
+
+#if !UE_BUILD_SHIPPING
+    //Steady state means still climbing with no montage being started
+    if (CVarClimbCheckTickAllocations.GetValueOnGameThread() && IsClimbing() && !OwningPlayerAnimInstance->IsAnyMontagePlaying())
+    {
+        const uint64 TickAllocations = ClimbDiagnostics::GetAllocationCount() - AllocationsBeforeTick;
+        if (TickAllocations > 0)
+        {
+            UE_LOG(LogClimb, Warning, TEXT("%s climb tick allocated %llu times"), *GetNameSafe(CharacterOwner), TickAllocations);
+        }
+    }
+#endif
+
+    //Every probe counts against the frame, including the player's and those of climbers with nothing cached
+    if (ClimbProbeSubsystem && ClimbQueryPlan.NumIssued > 0)
+    {
+        ClimbProbeSubsystem->ReportProbeCost(ProbePriority, ClimbQueryPlan.NumIssued, FPlatformTime::Seconds() - ProbeStartTime);
+    }
+
+    CLIMB_COUNTER_ADD(ClimbProbesIssued, ClimbQueryPlan.NumIssued);
+    CLIMB_COUNTER_ADD(ClimbProbesSaved, ClimbQueryPlan.GetNumSaved());
+
+    UE_LOG(LogClimb, VeryVerbose, TEXT("%s climb probes: %d requested, %d issued, %d saved over %d sub-steps"),
+        *GetNameSafe(CharacterOwner), ClimbQueryPlan.NumRequested, ClimbQueryPlan.NumIssued, ClimbQueryPlan.GetNumSaved(), Iterations - FirstIteration);
+
+    //Hand the time left after letting go to the falling mode
+    if (!IsClimbing() && RemainingTime >= MIN_TICK_TIME)
+    {
+        StartNewPhysics(RemainingTime, Iterations);
+    }
+}
+
+
+float UClimbMovementComponent::GetClimbSimulationTimeStep(float RemainingTime, int32 Iterations) const
+{
+    //Same split as GetSimulationTimeStep, the last allowed iteration takes whatever time is left
+    const float MaxTimeStep = FMath::Min(MaxClimbSimulationTimeStep, MaxSimulationTimeStep);
+
+    if (RemainingTime > MaxTimeStep && Iterations < GetMaxClimbSimulationIterations())
+    {
+        RemainingTime = FMath::Min(MaxTimeStep, RemainingTime * 0.5f);
     }
 
+    return FMath::Max(MIN_TICK_TIME, RemainingTime);
+}
+
+
+void UClimbMovementComponent::PhysClimbKinematic(float deltaTime)
+{
+    CLIMB_SCOPE(PhysClimbKinematic);
+
     RestorePreAdditiveRootMotionVelocity();
 
     if (!HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity())
     {
-        //Define max climb speed and acceleration
         CalcVelocity(deltaTime, 0.0f, true, MaxBrakingDeceleration);
+
+        //Stay on the plane of the last known surface
+        Velocity = FVector::VectorPlaneProject(Velocity, CurrentClimbableSurfaceNormal);
     }
 
     ApplyRootMotionToVelocity(deltaTime);
 
-    FVector OldLocation = UpdatedComponent->GetComponentLocation();
-    const FVector Adjusted = Velocity * deltaTime;
+    const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+    const FVector Delta = Velocity * deltaTime;
     FHitResult Hit(1.f);
 
-    //Handle Climb rotation
-    SafeMoveUpdatedComponent(Adjusted, GetClimbRotation(deltaTime), true, Hit);
+    SafeMoveUpdatedComponent(Delta, GetClimbRotation(deltaTime), true, Hit);
+    NumClimbMoveSweeps++;
+    CLIMB_COUNTER_ADD(ClimbMoveSweeps, 1);
 
-    if (Hit.Time < 1.f)
-    {      
-        HandleImpact(Hit, deltaTime, Adjusted);
-        SlideAlongSurface(Adjusted, (1.f - Hit.Time), Hit.Normal, Hit, true);
-    }
+    CurrentClimbableSurfaceLocation += FVector::VectorPlaneProject(UpdatedComponent->GetComponentLocation() - OldLocation, CurrentClimbableSurfaceNormal);
 
-    if (!HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity())
+    //Blocked, the last surface no longer describes where the capsule is, probe on the next tick
+    if (Hit.IsValidBlockingHit())
     {
-        Velocity = (UpdatedComponent->GetComponentLocation() - OldLocation) / deltaTime;
+        HandleImpact(Hit, deltaTime, Delta);
+        TicksSinceSurfaceProbe = GetDefault<UClimbSettings>()->KinematicProbeInterval;
     }
+}
 
-    //Snap movement to climbable surfaces
-    SnapMovementToClimbableSurfaces(deltaTime);
 
-    if (HasReachLedge())
-    {
-        PlayClimbMontage(ClimbToTopMontage);
-    }
+void UClimbMovementComponent::FollowClimbBase()
+{
+    FTransform BaseDelta;
+    if (!ClimbBaseContacts.Follow(ClimbTraceResults, BaseDelta)) { return; }
+
+    //Carry the capsule and the surface it snaps to like a based character, the base relative caches stay valid
+    const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+    const FVector NewLocation = BaseDelta.TransformPosition(OldLocation);
+    const FQuat NewRotation = BaseDelta.GetRotation() * UpdatedComponent->GetComponentQuat();
+
+    CurrentClimbableSurfaceLocation = BaseDelta.TransformPosition(CurrentClimbableSurfaceLocation);
+    CurrentClimbableSurfaceNormal = BaseDelta.TransformVectorNoScale(CurrentClimbableSurfaceNormal);
+
+    FHitResult Hit;
+    SafeMoveUpdatedComponent(NewLocation - OldLocation, NewRotation, true, Hit);
+}
+
+
+void UClimbMovementComponent::SetClimbLODTier(EClimbLODTier InClimbLODTier)
+{
+    if (ClimbLODTier == InClimbLODTier) { return; }
+
+    ClimbLODTier = InClimbLODTier;
+    TicksSinceSurfaceProbe = 0;
+
+    //Caches taken under a coarser tier may be far behind the capsule
+    InvalidateClimbProbeCaches();
 }
 
 
@@ -171,16 +444,33 @@ void UClimbMovementComponent::ProcessClimbableSurfaceInfo()
 
     if (ClimbTraceResults.IsEmpty()) { return; }
 
-    for (const FHitResult& HitResult : ClimbTraceResults)
+    //Contacts relative to the first one, the kernels work on floats
+    const int32 NumContacts = ClimbTraceResults.Num();
+    const FVector Origin = ClimbTraceResults[0].ImpactPoint;
+    ClimbMathKernels::TVectorArray<TInlineAllocator<8>> ContactPoints;
+    ClimbMathKernels::TVectorArray<TInlineAllocator<8>> ContactNormals;
+    ContactPoints.SetNum(NumContacts);
+    ContactNormals.SetNum(NumContacts);
+
+    for (int32 ContactIndex = 0; ContactIndex < NumContacts; ContactIndex++)
     {
-        CurrentClimbableSurfaceLocation += HitResult.ImpactPoint;
-        CurrentClimbableSurfaceNormal += HitResult.ImpactNormal;
+        const FHitResult& HitResult = ClimbTraceResults[ContactIndex];
+        ContactPoints.Set(ContactIndex, FVector3f(HitResult.ImpactPoint - Origin));
+        ContactNormals.Set(ContactIndex, FVector3f(HitResult.ImpactNormal));
     }
 
-    CurrentClimbableSurfaceLocation /= ClimbTraceResults.Num();
-    CurrentClimbableSurfaceNormal = CurrentClimbableSurfaceNormal.GetSafeNormal();
+    CurrentClimbableSurfaceLocation = Origin + FVector(ClimbMathKernels::Sum(ContactPoints)) / NumContacts;
+    CurrentClimbableSurfaceNormal = FVector(ClimbMathKernels::Sum(ContactNormals)).GetSafeNormal();
+}
+
+void UClimbMovementComponent::InvalidateClimbProbeCaches()
+{
+    SurfaceProbeCache.Invalidate();
+    FloorProbeCache.Invalidate();
+    LedgeProbeCache.Invalidate();
 }
 
+
 bool UClimbMovementComponent::ShouldStopClimbing()
 {
     if (ClimbTraceResults.IsEmpty())
@@ -188,56 +478,131 @@ bool UClimbMovementComponent::ShouldStopClimbing()
         return true;
     }
 
-    const float DotResult = FVector::DotProduct(CurrentClimbableSurfaceNormal, FVector::UpVector);
-    const float DegreeDiff = FMath::RadiansToDegrees(FMath::Acos(DotResult));
+    //Within DegreesSurfaceClimbingThreshold of flat, compared as a dot product against its cached cosine
+    return FVector::DotProduct(CurrentClimbableSurfaceNormal, FVector::UpVector) >= StopClimbingMinDot;
+}
+
+
+bool UClimbMovementComponent::HasReachFloor()
+{
+    CLIMB_SCOPE(HasReachFloor);
+
+    //Floor can only be reached while climbing down, reduced LOD climbers skip the check and kinematic ones only get
+    //here on their probing ticks
+    const bool bMovingDown = GetUnrotatedClimbVelocity().Z < -10.0f && ClimbLODTier != EClimbLODTier::Reduced;
+    const FTransform& ComponentTransform = UpdatedComponent->GetComponentTransform();
 
-    if (DegreeDiff <= DegreesSurfaceClimbingThreshold)
+    if (ClimbQueryPlan.ShouldIssue(FloorProbeCache, ComponentTransform, bMovingDown))
     {
-        return true;
+        const FVector DownVector = -UpdatedComponent->GetUpVector();
+        const FVector StartOffset = DownVector * 50.0f;
+
+        const FVector Start = UpdatedComponent->GetComponentLocation() + StartOffset;
+        const FVector End = Start - FVector(0.0f, 0.0f, FloorReachedDetector);
+
+        //GetClimbCapsuleTraces(Start, End);
+        FHitResult HitResult;
+        GetClimbLineTraces(Start, End, HitResult);
+
+        FloorProbeCache.Store(ComponentTransform, HitResult.bBlockingHit && FVector::Parallel(-HitResult.ImpactNormal, FVector::UpVector));
     }
 
-    return false;
+    return bMovingDown && FloorProbeCache.bValid && FloorProbeCache.bHit;
 }
 
 
-bool UClimbMovementComponent::HasReachFloor()
+bool UClimbMovementComponent::HasReachLedge()
 {
-    const FVector DownVector = -UpdatedComponent->GetUpVector();
-    const FVector StartOffset = DownVector * 50.0f;
-
-    const FVector Start = UpdatedComponent->GetComponentLocation() + StartOffset;
-    const FVector End = Start - FVector(0.0f, 0.0f, FloorReachedDetector);
-    
-    //GetClimbCapsuleTraces(Start, End);
-    FHitResult HitResult = GetClimbLineTraces(Start, End);
+    CLIMB_SCOPE(HasReachLedge);
 
-    if (!HitResult.bBlockingHit) { return false; }
+    //Ledge can only be reached while climbing up, reduced LOD climbers skip the check and kinematic ones only get
+    //here on their probing ticks
+    const bool bMovingUp = GetUnrotatedClimbVelocity().Z > 10.0f && ClimbLODTier != EClimbLODTier::Reduced;
+    const FTransform& ComponentTransform = UpdatedComponent->GetComponentTransform();
 
-    const bool bFloorReached = FVector::Parallel(-HitResult.ImpactNormal, FVector::UpVector) && GetUnrotatedClimbVelocity().Z < -10.0f;
+    if (ClimbQueryPlan.ShouldIssue(LedgeProbeCache, ComponentTransform, bMovingUp))
+    {
+        //Same volume as the traces: a walkable top within 100 below the ledge trace, in reach ahead
+        const float LedgeHeight = CharacterOwner->BaseEyeHeight + LedgeTraceStartOffset;
+        const bool bLedgeFound = ResolveClimbLedge(TEXT("HasReachLedge"),
+            [this, LedgeHeight]() { return FindClimbLedge(0.0f, EyesTraceDist, LedgeHeight - 100.0f, LedgeHeight, -1.0f); },
+            [this]() { return TraceLedgeAbove(); });
 
-    if (!bFloorReached) { return false; }
+        LedgeProbeCache.Store(ComponentTransform, bLedgeFound, ClimbBaseContacts.GetBase());
+    }
 
-    return true;    
+    return bMovingUp && LedgeProbeCache.bValid && LedgeProbeCache.bHit;
 }
 
 
-bool UClimbMovementComponent::HasReachLedge()
+bool UClimbMovementComponent::TraceLedgeAbove()
 {
     FHitResult LedgeHitResult;
     TraceFromLedgeHeight(LedgeHitResult);
 
-    if (!LedgeHitResult.bBlockingHit)
+    if (LedgeHitResult.bBlockingHit) { return false; }
+
+    const FVector WalkableSurfaceTraceStart = LedgeHitResult.TraceEnd;
+    const FVector DownVector = -UpdatedComponent->GetUpVector();
+    const FVector WalkableSurfaceTraceEnd = WalkableSurfaceTraceStart + DownVector * 100.0f;
+
+    FHitResult FloorHitResult;
+    return GetClimbLineTraces(WalkableSurfaceTraceStart, WalkableSurfaceTraceEnd, FloorHitResult);
+}
+
+
+bool UClimbMovementComponent::FindClimbLedge(float MinForward, float MaxForward, float MinHeight, float MaxHeight, float FacingSign) const
+{
+    CLIMB_SCOPE(FindClimbLedge);
+
+    const FVector Location = UpdatedComponent->GetComponentLocation();
+    const FVector Forward = UpdatedComponent->GetForwardVector();
+    const FVector Up = UpdatedComponent->GetUpVector();
+
+    FBox Bounds(ForceInit);
+    Bounds += Location + Forward * MinForward + Up * MinHeight;
+    Bounds += Location + Forward * MinForward + Up * MaxHeight;
+    Bounds += Location + Forward * MaxForward + Up * MinHeight;
+    Bounds += Location + Forward * MaxForward + Up * MaxHeight;
+    Bounds = Bounds.ExpandBy(ClimbCapsuleTraceRadius);
+
+    const FVector ProbeCenter = Location + Up * (MinHeight + MaxHeight) * 0.5f;
+
+    return ClimbLedgeSubsystem->FindLedge(Bounds, [&](const FClimbLedgeSegment& Segment)
     {
-        const FVector WalkableSurfaceTraceStart = LedgeHitResult.TraceEnd;
-        const FVector DownVector = -UpdatedComponent->GetUpVector();
-        const FVector WalkableSurfaceTraceEnd = WalkableSurfaceTraceStart + DownVector * 100.0f;
+        //Ledges above face the climber, ledges to climb down face away from the walker
+        if (FVector::DotProduct(Segment.OutwardNormal, Forward) * FacingSign < 0.5f) { return false; }
+
+        const FVector Offset = Segment.GetClosestPoint(ProbeCenter) - Location;
+        const float ForwardDistance = FVector::DotProduct(Offset, Forward);
+        const float Height = FVector::DotProduct(Offset, Up);
+        const float LateralDistance = (Offset - Forward * ForwardDistance - Up * Height).Size();
+
+        return ForwardDistance >= MinForward && ForwardDistance <= MaxForward
+            && Height >= MinHeight && Height <= MaxHeight
+            && LateralDistance <= ClimbCapsuleTraceRadius;
+    });
+}
+
+
+bool UClimbMovementComponent::ResolveClimbLedge(const TCHAR* CheckName, TFunctionRef<bool()> FindLedge, TFunctionRef<bool()> TraceLedge)
+{
+    if (!bUseClimbLedgeData || !ClimbLedgeSubsystem || !ClimbLedgeSubsystem->HasLedgeData())
+    {
+        return TraceLedge();
+    }
 
-        FHitResult FloorHitResult = GetClimbLineTraces(WalkableSurfaceTraceStart, WalkableSurfaceTraceEnd);
-                
-        if (FloorHitResult.bBlockingHit && GetUnrotatedClimbVelocity().Z > 10.0f) { return true; }
+    const bool bFound = FindLedge();
+    if (!bValidateClimbLedgeData) { return bFound; }
+
+    const bool bTraced = TraceLedge();
+    if (bFound != bTraced)
+    {
+        UE_LOG(LogClimb, Warning, TEXT("%s %s: ledge data %s, traces %s at %s"), *GetNameSafe(CharacterOwner), CheckName,
+            bFound ? TEXT("found") : TEXT("missed"), bTraced ? TEXT("found") : TEXT("missed"), *UpdatedComponent->GetComponentLocation().ToCompactString());
     }
 
-    return false;
+    return bTraced;
 }
 
 
@@ -250,180 +615,393 @@ FQuat UClimbMovementComponent::GetClimbRotation(float DeltaTime)
         return CurrentQuat;
     }
 
-    const FQuat TargetQuat = FRotationMatrix::MakeFromX(-CurrentClimbableSurfaceNormal).ToQuat();
-    return FMath::QInterpTo(CurrentQuat, TargetQuat, DeltaTime, ClimbRotInterpSpeed);
+    return ClimbMath::InterpClimbRotation(CurrentQuat, CurrentClimbableSurfaceNormal, DeltaTime, ClimbRotInterpSpeed);
 
 }
 
 
-void UClimbMovementComponent::SnapMovementToClimbableSurfaces(float DeltaTime)
+void UClimbMovementComponent::MoveAlongClimbableSurface(float DeltaTime)
 {
-    const FVector ComponentForward = UpdatedComponent->GetForwardVector();
-    const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
-    
-    const FVector ProjectedCharacterToSurface = (CurrentClimbableSurfaceLocation - ComponentLocation).ProjectOnTo(ComponentForward);
+    CLIMB_SCOPE(MoveAlongClimbableSurface);
+
+    const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+    const FVector Adjusted = Velocity * DeltaTime;
+
+    //Handle Climb rotation
+    const FQuat ClimbRotation = GetClimbRotation(DeltaTime);
+
+    //Snap from where the climb displacement ends, so the same sweep carries both
+    const FVector Delta = Adjusted + GetClimbSnapDelta(OldLocation + Adjusted, ClimbRotation.GetForwardVector(), DeltaTime);
+    FHitResult Hit(1.f);
+
+    SafeMoveUpdatedComponent(Delta, ClimbRotation, true, Hit);
+    int32 NumSweeps = 1;
+
+    if (Hit.Time < 1.f)
+    {
+        HandleImpact(Hit, DeltaTime, Delta);
+        SlideAlongSurface(Delta, (1.f - Hit.Time), Hit.Normal, Hit, true);
+        NumSweeps++;
+    }
+
+    NumClimbMoveSweeps += NumSweeps;
+    CLIMB_COUNTER_ADD(ClimbMoveSweeps, NumSweeps);
+
+    if (!HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity())
+    {
+        //The snap runs along the surface normal and is not part of the climb velocity
+        Velocity = FVector::VectorPlaneProject(UpdatedComponent->GetComponentLocation() - OldLocation, CurrentClimbableSurfaceNormal) / DeltaTime;
+    }
+}
 
-    const FVector SnapVector = -CurrentClimbableSurfaceNormal * ProjectedCharacterToSurface.Length();
 
-    UpdatedComponent->MoveComponent(
-        SnapVector * DeltaTime * MaxClimbSpeed,
-        UpdatedComponent->GetComponentQuat(),
-        true
+FVector UClimbMovementComponent::GetClimbSnapDelta(const FVector& Location, const FVector& Forward, float DeltaTime) const
+{
+    const FVector SnapVector = ClimbMath::GetSnapVector(
+        Location,
+        Forward,
+        CurrentClimbableSurfaceLocation,
+        CurrentClimbableSurfaceNormal
     );
+
+    //Reduced LOD interpolates towards the sparse surface probes instead of snapping
+    const float SnapScale = ClimbLODTier == EClimbLODTier::Reduced
+        ? FMath::Min(DeltaTime * GetDefault<UClimbSettings>()->ReducedSnapInterpSpeed, 1.0f)
+        : DeltaTime * MaxClimbSpeed;
+
+    return SnapVector * SnapScale;
 }
 
 
-TArray<FHitResult> UClimbMovementComponent::GetClimbCapsuleTraces(const FVector& Start, const FVector& End)
+bool UClimbMovementComponent::GetClimbCapsuleTraces(const FVector& Start, const FVector& End, FClimbHitResults& OutHitResults)
 {
-    TArray<FHitResult> OutHitResults;
+    const bool bHit = ClimbQuery.SweepCapsule(GetWorld(), Start, End, ClimbCapsuleTraceRadius, ClimbCapsuleTraceHeight, OutHitResults);
 
-    UKismetSystemLibrary::CapsuleTraceMultiForObjects(
-        this,
-        Start,
-        End,
-        ClimbCapsuleTraceRadius,
-        ClimbCapsuleTraceHeight,
-        ClimbableSurfaceTypes,
-        false,
-        TArray<AActor*>(),
-        bShowDebugShape ? EDrawDebugTrace::ForDuration : EDrawDebugTrace::None,
-        OutHitResults,
-        false,
-        FLinearColor::Red,
-        FLinearColor::Green,
-        ShowDebugDuration
-    );
+    if (bShowDebugShape)
+    {
+        DrawDebugClimbCapsuleTrace(Start, End, OutHitResults);
+    }
 
-    return OutHitResults;
+    return bHit;
 }
 
 
 bool UClimbMovementComponent::GetClimbableSurfaces()
 {
+    CLIMB_SCOPE(GetClimbableSurfaces);
+
     //UpdatedComponent es el Capsule Component del Character, que es la raiz
     const FVector StartOffset = UpdatedComponent->GetForwardVector() * (ClimbCapsuleTraceRadius * 0.5f);
     const FVector Start = UpdatedComponent->GetComponentLocation() + StartOffset;
     const FVector End = Start + UpdatedComponent->GetForwardVector();
 
-    ClimbTraceResults = GetClimbCapsuleTraces(Start, End);
-
     // If not empty return true, if empty return false
-    return !ClimbTraceResults.IsEmpty();
+    return GetClimbCapsuleTraces(Start, End, ClimbTraceResults);
 }
 
 
-FHitResult UClimbMovementComponent::GetClimbLineTraces(const FVector& Start, const FVector& End)
+void UClimbMovementComponent::RequestAsyncClimbableSurfaces(float DeltaTime)
 {
-    FHitResult OutHitResult;
+    CLIMB_SCOPE(RequestAsyncClimbableSurfaces);
+
+    //Sweep from where the capsule is expected to be next frame, so the result is not one frame behind
+    PendingClimbSweepLocation = UpdatedComponent->GetComponentLocation() + Velocity * DeltaTime;
+
+    const FVector StartOffset = UpdatedComponent->GetForwardVector() * (ClimbCapsuleTraceRadius * 0.5f);
+    const FVector Start = PendingClimbSweepLocation + StartOffset;
+    const FVector End = Start + UpdatedComponent->GetForwardVector();
 
-    UKismetSystemLibrary::LineTraceSingleForObjects(
-        this,
+    PendingClimbSweepHandle = GetWorld()->AsyncSweepByObjectType(
+        EAsyncTraceType::Multi,
         Start,
         End,
-        ClimbableSurfaceTypes,
-        false,
-        TArray<AActor*>(),
-        bShowDebugShape ? EDrawDebugTrace::ForDuration : EDrawDebugTrace::None,
-        OutHitResult,
-        false,
-        FLinearColor::Blue,
-        FLinearColor::Green, 
-        ShowDebugDuration
+        FQuat::Identity,
+        ClimbQuery.GetObjectQueryParams(),
+        FCollisionShape::MakeCapsule(ClimbCapsuleTraceRadius, ClimbCapsuleTraceHeight),
+        ClimbQuery.GetSweepQueryParams()
     );
-
-    return OutHitResult;
 }
 
 
-bool UClimbMovementComponent::TraceFromEyeHeight()
+bool UClimbMovementComponent::SampleClimbableSurfaceField()
 {
-    const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
-    const FVector EyesHeightOffset = UpdatedComponent->GetUpVector() * (CharacterOwner->BaseEyeHeight + EyesTraceStartOffset);
-    const FVector Start = ComponentLocation + EyesHeightOffset;
-    const FVector End = Start + UpdatedComponent->GetForwardVector() * EyesTraceDist;
+    CLIMB_SCOPE(SampleClimbableSurfaceField);
 
-    EyesTraceResult = GetClimbLineTraces(Start, End);
+    //Only while the last hits all came from one mesh that has a baked field
+    if (ClimbTraceResults.IsEmpty()) { return false; }
 
-    // If blocking hit return true, if not return false
-    return EyesTraceResult.bBlockingHit;
-}
+    UStaticMeshComponent* SurfaceComponent = Cast<UStaticMeshComponent>(ClimbTraceResults[0].GetComponent());
+    UStaticMesh* SurfaceMesh = SurfaceComponent ? SurfaceComponent->GetStaticMesh() : nullptr;
+    const UClimbSurfaceField* SurfaceField = SurfaceMesh ? SurfaceMesh->GetAssetUserData<UClimbSurfaceField>() : nullptr;
 
+    if (!SurfaceField || !SurfaceField->IsValidField()) { return false; }
 
-FHitResult UClimbMovementComponent::TraceFromHeight(float TraceDistance, float StartOffset)
-{
-    const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
-    const FVector EyesHeightOffset = UpdatedComponent->GetUpVector() * (CharacterOwner->BaseEyeHeight + StartOffset);
-    const FVector Start = ComponentLocation + EyesHeightOffset;
-    const FVector End = Start + UpdatedComponent->GetForwardVector() * TraceDistance;
-
-    return GetClimbLineTraces(Start, End);
-}
+    for (const FHitResult& HitResult : ClimbTraceResults)
+    {
+        if (HitResult.GetComponent() != SurfaceComponent) { return false; }
+    }
 
+    const FTransform& SurfaceTransform = SurfaceComponent->GetComponentTransform();
+    if (!SurfaceTransform.GetScale3D().IsUniform()) { return false; }
 
-void UClimbMovementComponent::TraceFromLedgeHeight(FHitResult& OutHitResult)
-{
-    const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
-    const FVector LedgeHeightOffset = UpdatedComponent->GetUpVector() * (CharacterOwner->BaseEyeHeight + LedgeTraceStartOffset);
+    const float SurfaceScale = SurfaceTransform.GetScale3D().X;
+    const FVector StartOffset = UpdatedComponent->GetForwardVector() * (ClimbCapsuleTraceRadius * 0.5f);
+    const FVector CapsuleCenter = UpdatedComponent->GetComponentLocation() + StartOffset;
+    const FVector CapsuleUp = UpdatedComponent->GetUpVector();
 
-    const FVector Start = ComponentLocation + LedgeHeightOffset;
-    const FVector End = Start + UpdatedComponent->GetForwardVector() * EyesTraceDist;
+    //Sample along the sweep capsule axis, keeping what the capsule would have touched
+    TArray<FHitResult, TInlineAllocator<3>> FieldHits;
+    for (const float AxisOffset : { -0.5f, 0.0f, 0.5f })
+    {
+        const FVector SamplePoint = CapsuleCenter + CapsuleUp * (ClimbCapsuleTraceHeight * AxisOffset);
+        const FVector LocalPoint = SurfaceTransform.InverseTransformPosition(SamplePoint);
 
-    OutHitResult = GetClimbLineTraces(Start, End);
-}
+        float LocalDistance;
+        FVector LocalNormal;
+        if (!SurfaceField->Sample(LocalPoint, LocalDistance, LocalNormal)) { return false; }
 
+        if (LocalDistance * SurfaceScale > ClimbCapsuleTraceRadius) { continue; }
 
-void UClimbMovementComponent::TryStartVaulting()
-{
-    FVector VaultStartPosition;
-    FVector VaultLandPosition;
+        FHitResult& FieldHit = FieldHits.AddDefaulted_GetRef();
+        FieldHit.bBlockingHit = true;
+        FieldHit.Component = SurfaceComponent;
+        FieldHit.HitObjectHandle = FActorInstanceHandle(SurfaceComponent->GetOwner());
+        FieldHit.ImpactPoint = FieldHit.Location = SurfaceTransform.TransformPosition(LocalPoint - LocalNormal * LocalDistance);
+        FieldHit.ImpactNormal = FieldHit.Normal = SurfaceTransform.TransformVectorNoScale(LocalNormal);
+    }
 
-    if (CanStartVaulting(VaultStartPosition, VaultLandPosition))
-    {
-        //Start Vaulting
-        SetMotionWarpTarget(FName("VaultStartPoint"), VaultStartPosition);
-        SetMotionWarpTarget(FName("VaultLandPoint"), VaultLandPosition);
+    if (FieldHits.IsEmpty()) { return false; }
 
-        StartClimbing();
-        PlayClimbMontage(VaultMontage);
-    }
+    ClimbTraceResults.Reset();
+    ClimbTraceResults.Append(FieldHits);
+    return true;
 }
 
 
-void UClimbMovementComponent::SetMotionWarpTarget(const FName& InWarpTargetName, const FVector& InTargetPosition)
+void UClimbMovementComponent::ValidateClimbableSurfaceField()
 {
-    APeakPursuitCharacter* MyOwner = CastChecked<APeakPursuitCharacter>(GetOwner());
-    
-    MyOwner->GetMotionWarpingComponent()->AddOrUpdateWarpTargetFromLocation(
-        InWarpTargetName, InTargetPosition
-    );
-}
+    const FClimbHitResults FieldResults = ClimbTraceResults;
+    ProcessClimbableSurfaceInfo();
+    const FVector FieldLocation = CurrentClimbableSurfaceLocation;
+    const FVector FieldNormal = CurrentClimbableSurfaceNormal;
 
+    GetClimbableSurfaces();
+    ProcessClimbableSurfaceInfo();
 
-void UClimbMovementComponent::HandleHopUp()
-{
-    FVector HopUpTargetPoint;
-    if (CanHopUp(HopUpTargetPoint))
+    const float LocationError = FVector::Dist(FieldLocation, CurrentClimbableSurfaceLocation);
+    const float NormalErrorDegrees = FMath::RadiansToDegrees(FMath::Acos(FMath::Clamp(FVector::DotProduct(FieldNormal, CurrentClimbableSurfaceNormal), -1.0f, 1.0f)));
+
+    if (ClimbTraceResults.IsEmpty() || LocationError > ClimbSurfaceFieldTolerance || NormalErrorDegrees > ClimbSurfaceFieldTolerance)
     {
-        SetMotionWarpTarget(FName("HopUpTargetPoint"), HopUpTargetPoint);
-        PlayClimbMontage(HopUpMontage);
+        UE_LOG(LogClimb, Warning, TEXT("%s surface field differs from sweep on %s: %.1f cm, %.1f deg"),
+            *GetNameSafe(CharacterOwner), *GetNameSafe(FieldResults[0].GetComponent()), LocationError, NormalErrorDegrees);
     }
 
+    ClimbTraceResults = FieldResults;
 }
 
 
-bool UClimbMovementComponent::CanHopUp(FVector& OutHopUpTargetPos)
+bool UClimbMovementComponent::ConsumeAsyncClimbableSurfaces()
 {
-    FHitResult HopUpHit = TraceFromHeight(100.0f, -20.0f);
-    FHitResult LedgeHit = TraceFromHeight(100.0f, 150.0f);
+    CLIMB_SCOPE(ConsumeAsyncClimbableSurfaces);
 
-    if (HopUpHit.bBlockingHit && LedgeHit.bBlockingHit)
-    {
-        OutHopUpTargetPos = HopUpHit.ImpactPoint;
-        return true;
-    }
+    if (!PendingClimbSweepHandle.IsValid()) { return false; }
 
-    return false;
-}
+    FTraceDatum SweepData;
+    const bool bHasResult = GetWorld()->QueryTraceData(PendingClimbSweepHandle, SweepData);
+    PendingClimbSweepHandle = FTraceHandle();
+
+    if (!bHasResult) { return false; }
+
+#if WITH_CLIMB_PROBE_RECORDER
+    if (ProbeRecorder.IsRecording())
+    {
+        ProbeRecorder.RecordCapsule(SweepData.Start, SweepData.End, ClimbCapsuleTraceRadius, ClimbCapsuleTraceHeight, SweepData.OutHits);
+    }
+#endif
+
+    //Copy into the persistent buffer rather than adopting the datum's allocation
+    ClimbTraceResults.Reset();
+    ClimbTraceResults.Append(SweepData.OutHits);
+
+    //Correct the prediction error along each surface, moving off the plane does not move the wall
+    const FVector PredictionError = UpdatedComponent->GetComponentLocation() - PendingClimbSweepLocation;
+    for (FHitResult& HitResult : ClimbTraceResults)
+    {
+        HitResult.ImpactPoint += FVector::VectorPlaneProject(PredictionError, HitResult.ImpactNormal);
+    }
+
+    return true;
+}
+
+
+bool UClimbMovementComponent::GetClimbLineTraces(const FVector& Start, const FVector& End, FHitResult& OutHitResult)
+{
+    const bool bHit = ClimbQuery.LineTrace(GetWorld(), Start, End, OutHitResult);
+
+    if (bShowDebugShape)
+    {
+        DrawDebugClimbLineTrace(OutHitResult);
+    }
+
+    return bHit;
+}
+
+
+void UClimbMovementComponent::DrawDebugClimbCapsuleTrace(const FVector& Start, const FVector& End, TConstArrayView<FHitResult> HitResults) const
+{
+#if ENABLE_DRAW_DEBUG
+    const UWorld* World = GetWorld();
+    const FColor TraceColor = HitResults.IsEmpty() ? FColor::Red : FColor::Green;
+
+    DrawDebugCapsule(World, Start, ClimbCapsuleTraceHeight, ClimbCapsuleTraceRadius, FQuat::Identity, TraceColor, false, ShowDebugDuration);
+    DrawDebugCapsule(World, End, ClimbCapsuleTraceHeight, ClimbCapsuleTraceRadius, FQuat::Identity, TraceColor, false, ShowDebugDuration);
+    DrawDebugLine(World, Start, End, TraceColor, false, ShowDebugDuration);
+
+    for (const FHitResult& HitResult : HitResults)
+    {
+        DrawDebugPoint(World, HitResult.ImpactPoint, 16.0f, FColor::Green, false, ShowDebugDuration);
+    }
+#endif
+}
+
+
+void UClimbMovementComponent::DrawDebugClimbRayFan(const FClimbRayFan& Fan) const
+{
+#if ENABLE_DRAW_DEBUG
+    const UWorld* World = GetWorld();
+
+    for (int32 RayIndex = 0; RayIndex < Fan.Num(); RayIndex++)
+    {
+        if (!Fan.WasTraced(RayIndex)) { continue; }
+
+        if (Fan.IsHit(RayIndex))
+        {
+            DrawDebugLine(World, Fan.Starts[RayIndex], Fan.HitPoints[RayIndex], FColor::Blue, false, ShowDebugDuration);
+            DrawDebugLine(World, Fan.HitPoints[RayIndex], Fan.Ends[RayIndex], FColor::Green, false, ShowDebugDuration);
+            DrawDebugPoint(World, Fan.HitPoints[RayIndex], 16.0f, FColor::Blue, false, ShowDebugDuration);
+        }
+        else
+        {
+            DrawDebugLine(World, Fan.Starts[RayIndex], Fan.Ends[RayIndex], FColor::Blue, false, ShowDebugDuration);
+        }
+    }
+#endif
+}
+
+
+void UClimbMovementComponent::DrawDebugClimbLineTrace(const FHitResult& HitResult) const
+{
+#if ENABLE_DRAW_DEBUG
+    const UWorld* World = GetWorld();
+
+    if (HitResult.bBlockingHit)
+    {
+        DrawDebugLine(World, HitResult.TraceStart, HitResult.ImpactPoint, FColor::Blue, false, ShowDebugDuration);
+        DrawDebugLine(World, HitResult.ImpactPoint, HitResult.TraceEnd, FColor::Green, false, ShowDebugDuration);
+        DrawDebugPoint(World, HitResult.ImpactPoint, 16.0f, FColor::Blue, false, ShowDebugDuration);
+    }
+    else
+    {
+        DrawDebugLine(World, HitResult.TraceStart, HitResult.TraceEnd, FColor::Blue, false, ShowDebugDuration);
+    }
+#endif
+}
+
+
+bool UClimbMovementComponent::TraceFromEyeHeight()
+{
+    CLIMB_SCOPE(TraceFromEyeHeight);
+
+    const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+    const FVector EyesHeightOffset = UpdatedComponent->GetUpVector() * (CharacterOwner->BaseEyeHeight + EyesTraceStartOffset);
+    const FVector Start = ComponentLocation + EyesHeightOffset;
+    const FVector End = Start + UpdatedComponent->GetForwardVector() * EyesTraceDist;
+
+    // If blocking hit return true, if not return false
+    return GetClimbLineTraces(Start, End, EyesTraceResult);
+}
+
+
+void UClimbMovementComponent::AddRayFromHeight(FClimbRayFan& Fan, float TraceDistance, float StartOffset) const
+{
+    const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+    const FVector EyesHeightOffset = UpdatedComponent->GetUpVector() * (CharacterOwner->BaseEyeHeight + StartOffset);
+    const FVector Start = ComponentLocation + EyesHeightOffset;
+    const FVector End = Start + UpdatedComponent->GetForwardVector() * TraceDistance;
+
+    Fan.AddRay(Start, End);
+}
+
+
+void UClimbMovementComponent::TraceFromLedgeHeight(FHitResult& OutHitResult)
+{
+    CLIMB_SCOPE(TraceFromLedgeHeight);
+
+    const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+    const FVector LedgeHeightOffset = UpdatedComponent->GetUpVector() * (CharacterOwner->BaseEyeHeight + LedgeTraceStartOffset);
+
+    const FVector Start = ComponentLocation + LedgeHeightOffset;
+    const FVector End = Start + UpdatedComponent->GetForwardVector() * EyesTraceDist;
+
+    GetClimbLineTraces(Start, End, OutHitResult);
+}
+
+
+void UClimbMovementComponent::TryStartVaulting()
+{
+    FVector VaultStartPosition;
+    FVector VaultLandPosition;
+
+    //The vault enters climbing before its montage starts, it must not be left climbing without one
+    if (IsClimbActionReady(EClimbAction::Vault) && CanStartVaulting(VaultStartPosition, VaultLandPosition))
+    {
+        //Start Vaulting
+        StartClimbing();
+        PlayClimbAction(EClimbAction::Vault, { VaultStartPosition, VaultLandPosition });
+    }
+}
+
+
+void UClimbMovementComponent::SetMotionWarpTarget(const FName& InWarpTargetName, const FVector& InTargetPosition)
+{
+    APeakPursuitCharacter* MyOwner = CastChecked<APeakPursuitCharacter>(GetOwner());
+    
+    MyOwner->GetMotionWarpingComponent()->AddOrUpdateWarpTargetFromLocation(
+        InWarpTargetName, InTargetPosition
+    );
+}
+
+
+void UClimbMovementComponent::HandleHopUp()
+{
+    FVector HopUpTargetPoint;
+    if (CanHopUp(HopUpTargetPoint))
+    {
+        PlayClimbAction(EClimbAction::HopUp, { HopUpTargetPoint });
+    }
+
+}
+
+
+bool UClimbMovementComponent::CanHopUp(FVector& OutHopUpTargetPos)
+{
+    CLIMB_SCOPE(CanHopUp);
+
+    FClimbRayFan HopUpFan;
+    BuildHopUpRayFan(HopUpFan);
+
+    //Both the hop target and the ledge above it need a hit
+    TraceClimbRayFan(HopUpFan, HopUpFan.GetAllRaysMask(), [](const FClimbRayFan& Fan) { return Fan.HasMiss(); });
+
+    if (HopUpFan.IsHit(0) && HopUpFan.IsHit(1))
+    {
+        OutHopUpTargetPos = HopUpFan.HitPoints[0];
+        return true;
+    }
+
+    return false;
+}
 
 
 void UClimbMovementComponent::HandleHopDown()
@@ -431,19 +1009,22 @@ void UClimbMovementComponent::HandleHopDown()
     FVector HopDownTargetPoint;
     if (CanHopDown(HopDownTargetPoint))
     {
-        SetMotionWarpTarget(FName("HopDownTargetPoint"), HopDownTargetPoint);
-        PlayClimbMontage(HopDownMontage);
+        PlayClimbAction(EClimbAction::HopDown, { HopDownTargetPoint });
     }
 }
 
 
 bool UClimbMovementComponent::CanHopDown(FVector& OutHopDownTargetPos)
 {
-    FHitResult HopDownHit = TraceFromHeight(100.0f, -300.0f);
+    CLIMB_SCOPE(CanHopDown);
+
+    FClimbRayFan HopDownFan;
+    BuildHopDownRayFan(HopDownFan);
+    TraceClimbRayFan(HopDownFan);
 
-    if (HopDownHit.bBlockingHit)
+    if (HopDownFan.IsHit(0))
     {
-        OutHopDownTargetPos = HopDownHit.ImpactPoint;
+        OutHopDownTargetPos = HopDownFan.HitPoints[0];
         return true;
     }
 
@@ -451,9 +1032,12 @@ bool UClimbMovementComponent::CanHopDown(FVector& OutHopDownTargetPos)
 }
 
 
-void UClimbMovementComponent::RequestHoping()
-{    
-    const FVector UnrotatedLastInputVector = UKismetMathLibrary::Quat_UnrotateVector(UpdatedComponent->GetComponentQuat(), GetLastInputVector());
+void UClimbMovementComponent::ProcessHopRequest()
+{
+    if (!IsClimbing()) { return; }
+
+    //Acceleration is the input the move carries, LastInputVector only exists on the owning client
+    const FVector UnrotatedLastInputVector = UKismetMathLibrary::Quat_UnrotateVector(UpdatedComponent->GetComponentQuat(), GetCurrentAcceleration());
 
     const float DotResult = FVector::DotProduct(UnrotatedLastInputVector.GetSafeNormal(), FVector::UpVector);
 
@@ -470,34 +1054,27 @@ void UClimbMovementComponent::RequestHoping()
 
 bool UClimbMovementComponent::CanStartVaulting(FVector& OutVaultStartPosition, FVector& OutVaultLandPosition)
 {
+    CLIMB_SCOPE(CanStartVaulting);
+
     if (IsFalling()) { return false; }
 
     OutVaultStartPosition = FVector::ZeroVector;
     OutVaultLandPosition = FVector::ZeroVector;
 
-    const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
-    const FVector ComponentForward = UpdatedComponent->GetForwardVector();
-    const FVector UpVector = UpdatedComponent->GetUpVector();
-    const FVector DownVector = -UpdatedComponent->GetUpVector();
+    FClimbRayFan VaultFan;
+    BuildVaultRayFan(VaultFan);
 
-    int32 lines = 5;
-    for (int32 i = 0; i < lines; i++)
-    {
-        float lenghtLine = 80.0f * (i + 1);
-        const FVector Start = ComponentLocation + UpVector * 100.0f + (ComponentForward * lenghtLine);
-        const FVector End = Start + DownVector * lenghtLine;
+    //Only the start line and the landing line decide the vault, stop as soon as the start line misses
+    TraceClimbRayFan(VaultFan, GetVaultRayMask(), [](const FClimbRayFan& Fan) { return Fan.HasMiss(); });
 
-        FHitResult VaultTracehit = GetClimbLineTraces(Start, End);
-
-        if (i == 0 && VaultTracehit.bBlockingHit)
-        {
-            OutVaultStartPosition = VaultTracehit.ImpactPoint;
-        }
+    if (VaultFan.IsHit(0))
+    {
+        OutVaultStartPosition = VaultFan.HitPoints[0];
+    }
 
-        if (i == (lines - 2) && VaultTracehit.bBlockingHit)
-        {
-            OutVaultLandPosition = VaultTracehit.ImpactPoint;
-        }
+    if (VaultFan.IsHit(VaultLandRayIndex))
+    {
+        OutVaultLandPosition = VaultFan.HitPoints[VaultLandRayIndex];
     }
 
     if (OutVaultStartPosition != FVector::ZeroVector && OutVaultLandPosition != FVector::ZeroVector)
@@ -509,6 +1086,39 @@ bool UClimbMovementComponent::CanStartVaulting(FVector& OutVaultStartPosition, F
 }
 
 void UClimbMovementComponent::ToggleClimbing()
+{
+    bWantsToToggleClimb = true;
+}
+
+
+void UClimbMovementComponent::RequestHoping()
+{
+    bWantsToHop = true;
+}
+
+
+void UClimbMovementComponent::UpdateCharacterStateBeforeMovement(float DeltaSeconds)
+{
+    Super::UpdateCharacterStateBeforeMovement(DeltaSeconds);
+
+    //The toggle changes movement mode like the server does, PlayClimbAction leaves the montages to the first run of the move
+    if (bWantsToToggleClimb)
+    {
+        ProcessClimbToggle();
+    }
+
+    //A hop is nothing but its montage, a replayed move has nothing to redo
+    if (bWantsToHop && !IsReplayingMove())
+    {
+        ProcessHopRequest();
+    }
+
+    bWantsToToggleClimb = false;
+    bWantsToHop = false;
+}
+
+
+void UClimbMovementComponent::ProcessClimbToggle()
 {
     if (IsClimbing())
     {
@@ -520,11 +1130,11 @@ void UClimbMovementComponent::ToggleClimbing()
         if (CanStartClimbing())
         {
             //StartClimbing();
-            PlayClimbMontage(IdleToClimbMontage);
+            PlayClimbAction(EClimbAction::IdleToClimb);
         }
         else if(CanClimbDownLedge())
         {
-            PlayClimbMontage(ClimbDownLedgeMontage);
+            PlayClimbAction(EClimbAction::ClimbDownLedge);
         }
         else
         {
@@ -541,6 +1151,8 @@ bool UClimbMovementComponent::IsClimbing() const
 
 bool UClimbMovementComponent::CanStartClimbing()
 {
+    CLIMB_SCOPE(CanStartClimbing);
+
     if (IsFalling() || !TraceFromEyeHeight() || !GetClimbableSurfaces())
     {
         // Si esta cayendo o el trace desde la vista no esta hiteando o no encuentra superficies para escalar no puede escalar
@@ -558,6 +1170,14 @@ void UClimbMovementComponent::StartClimbing()
 }
 
 
+void UClimbMovementComponent::StartClimbingOnSurface(const FVector& SurfaceLocation, const FVector& SurfaceNormal)
+{
+    CurrentClimbableSurfaceLocation = SurfaceLocation;
+    CurrentClimbableSurfaceNormal = SurfaceNormal;
+    StartClimbing();
+}
+
+
 void UClimbMovementComponent::StopClimbing()
 {
     SetMovementMode(MOVE_Falling);
@@ -567,59 +1187,546 @@ void UClimbMovementComponent::StopClimbing()
 
 bool UClimbMovementComponent::CanClimbDownLedge()
 {
+    CLIMB_SCOPE(CanClimbDownLedge);
+
     if (IsFalling()) { return false; }
 
+    //Walkable surface at the first ray, ledge edge before the second, facing away from the character
+    return ResolveClimbLedge(TEXT("CanClimbDownLedge"),
+        [this]() { return FindClimbLedge(ClimbDownWalkableSurfaceTraceOffset, ClimbDownWalkableSurfaceTraceOffset + ClimbDownLedgeTraceOffset, -100.0f, 0.0f, 1.0f); },
+        [this]() { return TraceLedgeBelow(); });
+}
+
+
+bool UClimbMovementComponent::TraceLedgeBelow()
+{
+    FClimbRayFan ClimbDownFan;
+    BuildClimbDownLedgeRayFan(ClimbDownFan);
+
+    //Walkable surface in front must hit, the ledge trace past it must not
+    TraceClimbRayFan(ClimbDownFan, ClimbDownFan.GetAllRaysMask(), [](const FClimbRayFan& Fan) { return Fan.HasMiss(); });
+
+    if (!ClimbDownFan.IsHit(0)) { return false; }
+
+    if (ClimbDownFan.IsHit(1)) { return false; }
+
+    return true;
+}
+
+
+void UClimbMovementComponent::BuildVaultRayFan(FClimbRayFan& OutFan) const
+{
+    OutFan.Reset();
+
     const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
     const FVector ComponentForward = UpdatedComponent->GetForwardVector();
-    const FVector DownVector = -(UpdatedComponent->GetUpVector());
+    const FVector UpVector = UpdatedComponent->GetUpVector();
+    const FVector DownVector = -UpdatedComponent->GetUpVector();
+
+    for (int32 i = 0; i < VaultRayCount; i++)
+    {
+        float lenghtLine = 80.0f * (i + 1);
+        const FVector Start = ComponentLocation + UpVector * 100.0f + (ComponentForward * lenghtLine);
+        const FVector End = Start + DownVector * lenghtLine;
+
+        OutFan.AddRay(Start, End);
+    }
+}
+
+
+void UClimbMovementComponent::BuildHopUpRayFan(FClimbRayFan& OutFan) const
+{
+    OutFan.Reset();
+    AddRayFromHeight(OutFan, 100.0f, -20.0f);
+    AddRayFromHeight(OutFan, 100.0f, 150.0f);
+}
+
+
+void UClimbMovementComponent::BuildHopDownRayFan(FClimbRayFan& OutFan) const
+{
+    OutFan.Reset();
+    AddRayFromHeight(OutFan, 100.0f, -300.0f);
+}
 
 
+void UClimbMovementComponent::BuildClimbDownLedgeRayFan(FClimbRayFan& OutFan) const
+{
+    OutFan.Reset();
+
+    const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+    const FVector ComponentForward = UpdatedComponent->GetForwardVector();
+    const FVector DownVector = -(UpdatedComponent->GetUpVector());
+
     const FVector WalkableSurfaceTraceStart = ComponentLocation + ComponentForward * ClimbDownWalkableSurfaceTraceOffset;
     const FVector WalkableSurfaceTraceEnd = WalkableSurfaceTraceStart + DownVector * 100.0f;
+    OutFan.AddRay(WalkableSurfaceTraceStart, WalkableSurfaceTraceEnd);
 
-    FHitResult WalkableSurfaceHit = GetClimbLineTraces(WalkableSurfaceTraceStart, WalkableSurfaceTraceEnd);
+    const FVector LedgeTraceStart = WalkableSurfaceTraceStart + ComponentForward * ClimbDownLedgeTraceOffset;
+    const FVector LedgeTraceEnd = LedgeTraceStart + DownVector * ClimbDownWalkableSurfaceTraceDistance;
+    OutFan.AddRay(LedgeTraceStart, LedgeTraceEnd);
+}
 
-    if (!WalkableSurfaceHit.bBlockingHit) { return false; }
 
-    const FVector LedgeTraceStart = WalkableSurfaceHit.TraceStart + ComponentForward * ClimbDownLedgeTraceOffset;
-    const FVector LedgeTraceEnd = LedgeTraceStart + DownVector * ClimbDownWalkableSurfaceTraceDistance;
+void UClimbMovementComponent::TraceClimbRayFan(FClimbRayFan& Fan, uint32 RayMask, TFunctionRef<bool(const FClimbRayFan&)> IsDecided)
+{
+    ClimbQuery.TraceRayFan(GetWorld(), Fan, RayMask, IsDecided);
 
-    FHitResult LedgeTraceHit = GetClimbLineTraces(LedgeTraceStart, LedgeTraceEnd);
+    if (bShowDebugShape)
+    {
+        DrawDebugClimbRayFan(Fan);
+    }
+}
 
-    if (LedgeTraceHit.bBlockingHit) { return false; }
 
+void UClimbMovementComponent::TraceClimbRayFan(FClimbRayFan& Fan)
+{
+    TraceClimbRayFan(Fan, Fan.GetAllRaysMask(), [](const FClimbRayFan&) { return false; });
+}
+
+
+bool UClimbMovementComponent::PlayClimbMontage(UAnimMontage* MontageToPlay)
+{
+    CLIMB_SCOPE(PlayClimbMontage);
+
+    if (!MontageToPlay)
+    {
+        NumClimbActionFailures++;
+        return false;
+    }
+
+    //Another montage still playing is a normal refusal, not a failure
+    if (OwningPlayerAnimInstance->IsAnyMontagePlaying()) { return false; }
+
+    if (OwningPlayerAnimInstance->Montage_Play(MontageToPlay) <= 0.0f)
+    {
+        UE_LOG(LogClimb, Warning, TEXT("%s could not play %s"), *GetNameSafe(CharacterOwner), *GetNameSafe(MontageToPlay));
+        NumClimbActionFailures++;
+        return false;
+    }
+
+    ActiveClimbMontage = MontageToPlay;
+    OnClimbMontageChanged.ExecuteIfBound();
     return true;
 }
 
 
-void UClimbMovementComponent::PlayClimbMontage(UAnimMontage* MontageToPlay)
+bool UClimbMovementComponent::PlayClimbAction(EClimbAction Action, TConstArrayView<FVector> WarpTargetLocations)
 {
-    if (!MontageToPlay) { return; }
+    //Event each action raises once its montage is playing, indexed by EClimbAction
+    static constexpr EClimbEvent ActionEvents[] =
+    {
+        EClimbEvent::EnterStarted,
+        EClimbEvent::LedgeReached,
+        EClimbEvent::EnterStarted,
+        EClimbEvent::VaultStarted,
+        EClimbEvent::HopStarted,
+        EClimbEvent::HopStarted,
+    };
+    static_assert(UE_ARRAY_COUNT(ActionEvents) == (int32)EClimbAction::Num, "Missing climb action event");
+
+    //Replayed moves already started their montage the first time around, the mode changes around it still replay
+    if (IsReplayingMove()) { return true; }
+
+    const FClimbAction* ActionEntry = GetClimbActionTable()->FindAction(Action);
+    if (!ActionEntry)
+    {
+        NumClimbActionFailures++;
+        return false;
+    }
+
+    //Still streaming in, refused like a busy montage slot rather than stalling the game thread. The request can be repeated
+    UAnimMontage* Montage = GetClimbActionMontage(*ActionEntry);
+    if (!Montage && !ActionEntry->Montage.IsNull()) { return false; }
+
+    const int32 NumWarpTargets = FMath::Min(ActionEntry->WarpTargetNames.Num(), WarpTargetLocations.Num());
+    for (int32 WarpTargetIndex = 0; WarpTargetIndex < NumWarpTargets; WarpTargetIndex++)
+    {
+        SetMotionWarpTarget(ActionEntry->WarpTargetNames[WarpTargetIndex], WarpTargetLocations[WarpTargetIndex]);
+    }
 
-    if (OwningPlayerAnimInstance->IsAnyMontagePlaying()) { return; }
+    if (!PlayClimbMontage(Montage)) { return false; }
 
-    OwningPlayerAnimInstance->Montage_Play(MontageToPlay);
+    DispatchClimbEvent(ActionEvents[(int32)Action]);
+    return true;
 }
 
 
-void UClimbMovementComponent::OnClimbMontageEnded(UAnimMontage* Montage, bool bInterrupted)
+void UClimbMovementComponent::DispatchClimbEvent(EClimbEvent Event)
+{
+    const EClimbState From = ClimbStateMachine.GetState();
+    const double Time = GetWorld()->GetTimeSeconds();
+
+    if (ClimbStateMachine.Dispatch(Event, Time))
+    {
+        UE_LOG(LogClimb, Verbose, TEXT("%s %.3f: %s -> %s on %s"), *GetNameSafe(CharacterOwner), Time,
+            ClimbStateMachine::GetStateName(From), ClimbStateMachine::GetStateName(ClimbStateMachine.GetState()), ClimbStateMachine::GetEventName(Event));
+    }
+}
+
+
+const UClimbActionTable* UClimbMovementComponent::GetClimbActionTable() const
+{
+    return ClimbActionTable ? ClimbActionTable : GetDefault<UClimbActionTable>();
+}
+
+
+UAnimMontage* UClimbMovementComponent::GetClimbActionMontage(const FClimbAction& Action)
+{
+    if (UAnimMontage* Montage = Action.Montage.Get()) { return Montage; }
+
+    if (Action.Montage.IsNull()) { return nullptr; }
+
+    //Action wanted before the preload finished, e.g. spawned against a wall
+    UE_LOG(LogClimb, Verbose, TEXT("%s wants %s before it streamed in"), *GetNameSafe(CharacterOwner), *Action.Montage.ToString());
+
+    RequestClimbActionMontages();
+    return nullptr;
+}
+
+
+bool UClimbMovementComponent::IsClimbActionReady(EClimbAction Action)
+{
+    const FClimbAction* ActionEntry = GetClimbActionTable()->FindAction(Action);
+    return ActionEntry && GetClimbActionMontage(*ActionEntry);
+}
+
+
+bool UClimbMovementComponent::AreClimbActionMontagesLoaded() const
+{
+    return ClimbActionMontagesHandle.IsValid() && ClimbActionMontagesHandle->HasLoadCompleted();
+}
+
+
+void UClimbMovementComponent::UpdateClimbActionMontages(float DeltaTime)
+{
+    //Everything stays resident while climbing or in the middle of an action
+    if (IsClimbing() || IsPlayingClimbMontage())
+    {
+        TimeAwayFromClimbableSurfaces = 0.0f;
+        return;
+    }
+
+    //Simulated proxies load a montage when it is replicated to them, only climbers that start actions look ahead
+    if (!CharacterOwner->IsLocallyControlled() && !CharacterOwner->HasAuthority()) { return; }
+
+    ClimbActionPreloadCountdown -= DeltaTime;
+    if (ClimbActionPreloadCountdown > 0.0f) { return; }
+
+    const float CheckInterval = ClimbActionPreloadInterval - ClimbActionPreloadCountdown;
+    ClimbActionPreloadCountdown = ClimbActionPreloadInterval;
+
+    //Plain overlap outside ClimbQuery, streaming is not a climb probe and stays out of its counts and recordings
+    static const FCollisionQueryParams PreloadQueryParams(SCENE_QUERY_STAT(ClimbActionPreload), false);
+    const float HalfHeight = CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() + ClimbActionPreloadRadius;
+    const bool bNearClimbableSurface = GetWorld()->OverlapAnyTestByObjectType(
+        UpdatedComponent->GetComponentLocation(),
+        FQuat::Identity,
+        ClimbQuery.GetObjectQueryParams(),
+        FCollisionShape::MakeCapsule(ClimbActionPreloadRadius, HalfHeight),
+        PreloadQueryParams
+    );
+
+    if (bNearClimbableSurface)
+    {
+        TimeAwayFromClimbableSurfaces = 0.0f;
+        RequestClimbActionMontages();
+        return;
+    }
+
+    TimeAwayFromClimbableSurfaces += CheckInterval;
+    if (TimeAwayFromClimbableSurfaces >= ClimbActionReleaseDelay)
+    {
+        ReleaseClimbActionMontages();
+    }
+}
+
+
+void UClimbMovementComponent::RequestClimbActionMontages()
+{
+    if (ClimbActionMontagesHandle.IsValid()) { return; }
+
+    TArray<FSoftObjectPath> MontagePaths;
+    GetClimbActionTable()->GetMontagePaths(MontagePaths);
+    if (MontagePaths.IsEmpty()) { return; }
+
+    ClimbActionMontagesHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(MoveTemp(MontagePaths), FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
+}
+
+
+void UClimbMovementComponent::ReleaseClimbActionMontages()
 {
-    if (Montage == IdleToClimbMontage || Montage == ClimbDownLedgeMontage)
+    if (!ClimbActionMontagesHandle.IsValid()) { return; }
+
+    ClimbActionMontagesHandle->ReleaseHandle();
+    ClimbActionMontagesHandle.Reset();
+}
+
+
+bool UClimbMovementComponent::IsPlayingClimbMontage() const
+{
+    return ActiveClimbMontage && OwningPlayerAnimInstance && OwningPlayerAnimInstance->Montage_IsActive(ActiveClimbMontage);
+}
+
+
+void UClimbMovementComponent::OnClimbMontageBlendingOut(UAnimMontage* Montage, bool bInterrupted)
+{
+    CLIMB_SCOPE(OnClimbMontageBlendingOut);
+
+    const UClimbActionTable* ActionTable = GetClimbActionTable();
+    const FClimbAction* Action = ActionTable->FindAction(ActionTable->FindActionByMontage(Montage));
+
+    switch (Action ? Action->Result : EClimbActionResult::Unchanged)
     {
+    case EClimbActionResult::Climbing:
         StartClimbing();
         StopMovementImmediately();
+        break;
+    case EClimbActionResult::Walking:
+        SetMovementMode(MOVE_Walking);
+        break;
+    default:
+        break;
     }
 
-    if (Montage == ClimbToTopMontage || Montage == VaultMontage)
+    if (Action)
     {
-        SetMovementMode(MOVE_Walking);
+        DispatchClimbEvent(EClimbEvent::ActionFinished);
     }
 
     //Debug::Print(*Montage->GetName());
 }
 
 
+void UClimbMovementComponent::OnClimbMontageEnded(UAnimMontage* Montage, bool bInterrupted)
+{
+    //Results were applied on blend out, only the animation budget still cares about the montage being gone
+    if (Montage == ActiveClimbMontage)
+    {
+        OnClimbMontageChanged.ExecuteIfBound();
+    }
+}
+
+
+void UClimbMovementComponent::SetClimbableSurfaceTypes(const TArray<TEnumAsByte<EObjectTypeQuery>>& InClimbableSurfaceTypes)
+{
+    ClimbableSurfaceTypes = InClimbableSurfaceTypes;
+    UpdateClimbQueryTypes();
+    InvalidateClimbProbeCaches();
+
+    if (UClimbablePrimitiveSubsystem* ClimbablePrimitiveSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UClimbablePrimitiveSubsystem>() : nullptr)
+    {
+        ClimbablePrimitiveSubsystem->RegisterObjectTypes(ClimbQuery.GetObjectQueryParams());
+    }
+}
+
+
+void UClimbMovementComponent::UpdateClimbQueryTypes()
+{
+    //Proxies stand in for every climbable surface, the source meshes keep their dense collision for everything else
+    if (GetDefault<UClimbSettings>()->bUseClimbProxies)
+    {
+        ClimbQuery.SetClimbableSurfaceTypes({ UEngineTypes::ConvertToObjectType(ECC_ClimbProxy) });
+    }
+    else
+    {
+        ClimbQuery.SetClimbableSurfaceTypes(ClimbableSurfaceTypes);
+    }
+}
+
+
 FVector UClimbMovementComponent::GetUnrotatedClimbVelocity() const
 {
     return UKismetMathLibrary::Quat_UnrotateVector(UpdatedComponent->GetComponentQuat(), Velocity);
 }
+
+
+#pragma region Network Prediction
+void UClimbMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
+{
+    Super::UpdateFromCompressedFlags(Flags);
+
+    bWantsToToggleClimb = (Flags & FSavedMove_Character::FLAG_Custom_0) != 0;
+    bWantsToHop = (Flags & FSavedMove_Character::FLAG_Custom_1) != 0;
+}
+
+
+FNetworkPredictionData_Client* UClimbMovementComponent::GetPredictionData_Client() const
+{
+    if (ClientPredictionData == nullptr)
+    {
+        UClimbMovementComponent* MutableThis = const_cast<UClimbMovementComponent*>(this);
+        MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_Climb(*this);
+    }
+
+    return ClientPredictionData;
+}
+
+
+float UClimbMovementComponent::GetClientNetSendDeltaTime(const APlayerController* PC, const FNetworkPredictionData_Client_Character* ClientData, const FSavedMovePtr& NewMove) const
+{
+    const float NetSendDeltaTime = Super::GetClientNetSendDeltaTime(PC, ClientData, NewMove);
+
+    if (IsClimbing() && !HasAnimRootMotion())
+    {
+        return FMath::Max(NetSendDeltaTime, ClimbNetSendDeltaTime);
+    }
+
+    return NetSendDeltaTime;
+}
+
+
+void UClimbMovementComponent::OnClientCorrectionReceived(FNetworkPredictionData_Client_Character& ClientData, float TimeStamp, FVector NewLocation, FVector NewVelocity, UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase, bool bBaseRelativePosition, uint8 ServerMovementMode)
+{
+    Super::OnClientCorrectionReceived(ClientData, TimeStamp, NewLocation, NewVelocity, NewBase, NewBaseBoneName, bHasBase, bBaseRelativePosition, ServerMovementMode);
+
+    if (IsClimbing())
+    {
+        ClimbNetStats.Corrections++;
+    }
+
+    //Cached probes were taken from the mispredicted transform
+    InvalidateClimbProbeCaches();
+}
+
+
+void UClimbMovementComponent::ServerMovePacked_ClientSend(const FCharacterServerMovePackedBits& PackedBits)
+{
+    if (IsClimbing())
+    {
+        ClimbNetStats.ServerMoves++;
+        ClimbNetStats.ServerMoveBits += PackedBits.DataBits.Num();
+    }
+
+    Super::ServerMovePacked_ClientSend(PackedBits);
+}
+
+
+void UClimbMovementComponent::UpdateClimbNetStats(float DeltaTime)
+{
+#if !UE_BUILD_SHIPPING
+    const float StatsInterval = CVarClimbNetStatsInterval.GetValueOnGameThread();
+    if (StatsInterval <= 0.0f || !CharacterOwner || CharacterOwner->GetLocalRole() != ROLE_AutonomousProxy) { return; }
+
+    ClimbNetStats.ElapsedTime += DeltaTime;
+    if (IsClimbing())
+    {
+        ClimbNetStats.ClimbTime += DeltaTime;
+    }
+
+    if (ClimbNetStats.ElapsedTime < StatsInterval) { return; }
+
+    if (ClimbNetStats.ClimbTime > 0.0f)
+    {
+        UE_LOG(LogClimb, Display, TEXT("%s climb net: %.1f corrections/min, %.1f bytes/s, %.1f ServerMoves/s over %.1fs climbing"),
+            *GetNameSafe(CharacterOwner),
+            ClimbNetStats.Corrections * 60.0f / ClimbNetStats.ClimbTime,
+            ClimbNetStats.ServerMoveBits / 8.0f / ClimbNetStats.ClimbTime,
+            ClimbNetStats.ServerMoves / ClimbNetStats.ClimbTime,
+            ClimbNetStats.ClimbTime);
+    }
+
+    ClimbNetStats = FClimbNetStats();
+#endif
+}
+
+
+void FSavedMove_Climb::Clear()
+{
+    Super::Clear();
+
+    bSavedWantsToToggleClimb = false;
+    bSavedWantsToHop = false;
+    SavedClimbableSurfaceLocation = FVector::ZeroVector;
+    SavedClimbableSurfaceNormal = FVector::ZeroVector;
+}
+
+
+uint8 FSavedMove_Climb::GetCompressedFlags() const
+{
+    uint8 Result = Super::GetCompressedFlags();
+
+    if (bSavedWantsToToggleClimb)
+    {
+        Result |= FLAG_Custom_0;
+    }
+
+    if (bSavedWantsToHop)
+    {
+        Result |= FLAG_Custom_1;
+    }
+
+    return Result;
+}
+
+
+bool FSavedMove_Climb::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+    const FSavedMove_Climb* NewClimbMove = static_cast<const FSavedMove_Climb*>(NewMove.Get());
+
+    //Requests must reach the server on their own move
+    if (bSavedWantsToToggleClimb || bSavedWantsToHop || NewClimbMove->bSavedWantsToToggleClimb || NewClimbMove->bSavedWantsToHop)
+    {
+        return false;
+    }
+
+    //Climb moves only combine while they stay on the same surface
+    if (!SavedClimbableSurfaceNormal.IsZero() || !NewClimbMove->SavedClimbableSurfaceNormal.IsZero())
+    {
+        if (FVector::DotProduct(SavedClimbableSurfaceNormal, NewClimbMove->SavedClimbableSurfaceNormal) < 0.996f)
+        {
+            return false;
+        }
+    }
+
+    return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+
+void FSavedMove_Climb::SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
+{
+    Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+    if (const UClimbMovementComponent* ClimbMovement = Cast<UClimbMovementComponent>(C->GetCharacterMovement()))
+    {
+        bSavedWantsToToggleClimb = ClimbMovement->bWantsToToggleClimb;
+        bSavedWantsToHop = ClimbMovement->bWantsToHop;
+
+        if (ClimbMovement->IsClimbing())
+        {
+            SavedClimbableSurfaceLocation = ClimbMovement->CurrentClimbableSurfaceLocation;
+            SavedClimbableSurfaceNormal = ClimbMovement->CurrentClimbableSurfaceNormal;
+        }
+    }
+}
+
+
+void FSavedMove_Climb::PrepMoveFor(ACharacter* C)
+{
+    Super::PrepMoveFor(C);
+
+    if (UClimbMovementComponent* ClimbMovement = Cast<UClimbMovementComponent>(C->GetCharacterMovement()))
+    {
+        ClimbMovement->bWantsToToggleClimb = bSavedWantsToToggleClimb;
+        ClimbMovement->bWantsToHop = bSavedWantsToHop;
+
+        //Replay from the surface the move was predicted on
+        if (!SavedClimbableSurfaceNormal.IsZero())
+        {
+            ClimbMovement->CurrentClimbableSurfaceLocation = SavedClimbableSurfaceLocation;
+            ClimbMovement->CurrentClimbableSurfaceNormal = SavedClimbableSurfaceNormal;
+        }
+    }
+}
+
+
+FNetworkPredictionData_Client_Climb::FNetworkPredictionData_Client_Climb(const UCharacterMovementComponent& ClientMovement)
+    : Super(ClientMovement)
+{
+}
+
+
+FSavedMovePtr FNetworkPredictionData_Client_Climb::AllocateNewMove()
+{
+    return FSavedMovePtr(new FSavedMove_Climb());
+}
+#pragma endregion
@@ -0,0 +1,49 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Data/ClimbActionTable.h"
+#include "Animation/AnimMontage.h"
+
+
+UClimbActionTable::UClimbActionTable()
+{
+    auto AddAction = [this](EClimbAction Action, const TCHAR* MontagePath, EClimbActionResult Result, std::initializer_list<FName> WarpTargetNames)
+    {
+        FClimbAction& Entry = Actions.Add(Action);
+        Entry.Montage = TSoftObjectPtr<UAnimMontage>(FSoftObjectPath(MontagePath));
+        Entry.WarpTargetNames = WarpTargetNames;
+        Entry.Result = Result;
+    };
+
+    AddAction(EClimbAction::IdleToClimb, TEXT("/Game/PeakPursuit/Pawns/Animations/Montages/AM_IdleToClimb.AM_IdleToClimb"), EClimbActionResult::Climbing, {});
+    AddAction(EClimbAction::ClimbToTop, TEXT("/Game/PeakPursuit/Pawns/Animations/Montages/AM_ClimbToTop.AM_ClimbToTop"), EClimbActionResult::Walking, {});
+    AddAction(EClimbAction::ClimbDownLedge, TEXT("/Game/PeakPursuit/Pawns/Animations/Montages/AM_ClimbDownLedge2.AM_ClimbDownLedge2"), EClimbActionResult::Climbing, {});
+    AddAction(EClimbAction::Vault, TEXT("/Game/PeakPursuit/Pawns/Animations/Montages/AM_Vaulting.AM_Vaulting"), EClimbActionResult::Walking, { FName("VaultStartPoint"), FName("VaultLandPoint") });
+    AddAction(EClimbAction::HopUp, TEXT("/Game/PeakPursuit/Pawns/Animations/Montages/AM_HopUp.AM_HopUp"), EClimbActionResult::Unchanged, { FName("HopUpTargetPoint") });
+    AddAction(EClimbAction::HopDown, TEXT("/Game/PeakPursuit/Pawns/Animations/Montages/AM_HopDown.AM_HopDown"), EClimbActionResult::Unchanged, { FName("HopDownTargetPoint") });
+}
+
+
+EClimbAction UClimbActionTable::FindActionByMontage(const UAnimMontage* Montage) const
+{
+    if (!Montage) { return EClimbAction::Num; }
+
+    for (const TPair<EClimbAction, FClimbAction>& Action : Actions)
+    {
+        if (Action.Value.Montage.Get() == Montage) { return Action.Key; }
+    }
+
+    return EClimbAction::Num;
+}
+
+
+void UClimbActionTable::GetMontagePaths(TArray<FSoftObjectPath>& OutPaths) const
+{
+    for (const TPair<EClimbAction, FClimbAction>& Action : Actions)
+    {
+        if (!Action.Value.Montage.IsNull())
+        {
+            OutPaths.AddUnique(Action.Value.Montage.ToSoftObjectPath());
+        }
+    }
+}
@@ -0,0 +1,258 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Data/ClimbSurfaceField.h"
+#include "PeakPursuit/PeakPursuit.h"
+#include "Climb/ClimbMeshUtils.h"
+
+#if WITH_EDITOR
+#include "Engine/StaticMesh.h"
+#endif
+
+
+namespace ClimbSurfaceField
+{
+    //64 MB of voxels, a bigger field means a wrong voxel size rather than a bigger rock
+    static constexpr int64 MaxVoxels = 16 * 1024 * 1024;
+
+    //Octahedral normal encoding, two signed bytes per normal
+    static FVector2D OctWrap(const FVector2D& V)
+    {
+        return FVector2D(
+            (1.0f - FMath::Abs(V.Y)) * (V.X >= 0.0f ? 1.0f : -1.0f),
+            (1.0f - FMath::Abs(V.X)) * (V.Y >= 0.0f ? 1.0f : -1.0f)
+        );
+    }
+
+    static void EncodeNormal(const FVector& Normal, int8& OutX, int8& OutY)
+    {
+        const FVector N = Normal / (FMath::Abs(Normal.X) + FMath::Abs(Normal.Y) + FMath::Abs(Normal.Z));
+        const FVector2D Encoded = N.Z >= 0.0f ? FVector2D(N.X, N.Y) : OctWrap(FVector2D(N.X, N.Y));
+
+        OutX = (int8)FMath::RoundToInt(FMath::Clamp(Encoded.X, -1.0f, 1.0f) * 127.0f);
+        OutY = (int8)FMath::RoundToInt(FMath::Clamp(Encoded.Y, -1.0f, 1.0f) * 127.0f);
+    }
+
+    static FVector DecodeNormal(int8 X, int8 Y)
+    {
+        const FVector2D Encoded(X / 127.0f, Y / 127.0f);
+        const float Z = 1.0f - FMath::Abs(Encoded.X) - FMath::Abs(Encoded.Y);
+        const FVector2D XY = Z >= 0.0f ? Encoded : OctWrap(Encoded);
+
+        return FVector(XY.X, XY.Y, Z).GetSafeNormal();
+    }
+}
+
+
+void UClimbSurfaceField::Serialize(FArchive& Ar)
+{
+    Super::Serialize(Ar);
+
+    VoxelData.Serialize(Ar, this);
+}
+
+
+void UClimbSurfaceField::PostLoad()
+{
+    Super::PostLoad();
+
+    LockVoxels();
+}
+
+
+void UClimbSurfaceField::BeginDestroy()
+{
+    UnlockVoxels();
+
+    Super::BeginDestroy();
+}
+
+
+void UClimbSurfaceField::LockVoxels()
+{
+    UnlockVoxels();
+
+    const int64 ExpectedSize = (int64)Resolution.X * Resolution.Y * Resolution.Z * sizeof(FVoxel);
+    if (ExpectedSize <= 0 || VoxelData.GetBulkDataSize() != ExpectedSize) { return; }
+
+    //Kept locked for the lifetime of the asset, the payload is mapped instead of copied where the platform allows it
+    Voxels = static_cast<const FVoxel*>(VoxelData.LockReadOnly());
+}
+
+
+void UClimbSurfaceField::UnlockVoxels()
+{
+    if (Voxels)
+    {
+        VoxelData.Unlock();
+        Voxels = nullptr;
+    }
+}
+
+
+const UClimbSurfaceField::FVoxel& UClimbSurfaceField::GetVoxel(int32 X, int32 Y, int32 Z) const
+{
+    return Voxels[(Z * Resolution.Y + Y) * Resolution.X + X];
+}
+
+
+bool UClimbSurfaceField::Sample(const FVector& LocalPoint, float& OutDistance, FVector& OutNormal) const
+{
+    if (!Voxels) { return false; }
+
+    //Voxel centers sit at LocalBounds.Min + (Index + 0.5) * VoxelSize
+    const FVector GridPoint = (LocalPoint - LocalBounds.Min) / VoxelSize - FVector(0.5f);
+
+    const int32 X0 = FMath::FloorToInt(GridPoint.X);
+    const int32 Y0 = FMath::FloorToInt(GridPoint.Y);
+    const int32 Z0 = FMath::FloorToInt(GridPoint.Z);
+
+    if (X0 < 0 || Y0 < 0 || Z0 < 0 || X0 + 1 >= Resolution.X || Y0 + 1 >= Resolution.Y || Z0 + 1 >= Resolution.Z)
+    {
+        return false;
+    }
+
+    const FVector Alpha = GridPoint - FVector(X0, Y0, Z0);
+    const float DistanceScale = MaxDistance / MAX_int16;
+
+    float Distance = 0.0f;
+    FVector Normal = FVector::ZeroVector;
+
+    for (int32 Corner = 0; Corner < 8; Corner++)
+    {
+        const int32 DX = Corner & 1;
+        const int32 DY = (Corner >> 1) & 1;
+        const int32 DZ = (Corner >> 2) & 1;
+
+        const float Weight =
+            (DX ? Alpha.X : 1.0f - Alpha.X) *
+            (DY ? Alpha.Y : 1.0f - Alpha.Y) *
+            (DZ ? Alpha.Z : 1.0f - Alpha.Z);
+
+        const FVoxel& Voxel = GetVoxel(X0 + DX, Y0 + DY, Z0 + DZ);
+        Distance += Voxel.Distance * DistanceScale * Weight;
+        Normal += ClimbSurfaceField::DecodeNormal(Voxel.NormalX, Voxel.NormalY) * Weight;
+    }
+
+    //Outside the band the distance is clamped and means nothing
+    if (FMath::Abs(Distance) >= MaxDistance - VoxelSize) { return false; }
+
+    OutDistance = Distance;
+    OutNormal = Normal.GetSafeNormal();
+    return !OutNormal.IsZero();
+}
+
+
+#if WITH_EDITOR
+bool UClimbSurfaceField::Bake(const UStaticMesh* Mesh, float InVoxelSize, float InMaxDistance)
+{
+    TArray<FVector> Positions;
+    TArray<int32> Indices;
+
+    if (!ClimbMeshUtils::GatherTriangles(Mesh, Positions, Indices) || InVoxelSize <= 0.0f) { return false; }
+
+    //Sized in 64 bits before anything is touched, so an oversized field is rejected instead of wrapping around
+    const FBox BakeBounds = FBox(Positions).ExpandBy(InMaxDistance);
+    const FVector GridSize = BakeBounds.GetSize() / InVoxelSize;
+    const int64 ResolutionX = FMath::CeilToInt64(GridSize.X);
+    const int64 ResolutionY = FMath::CeilToInt64(GridSize.Y);
+    const int64 ResolutionZ = FMath::CeilToInt64(GridSize.Z);
+    const int64 MaxResolution = FMath::Max3(ResolutionX, ResolutionY, ResolutionZ);
+
+    if (MaxResolution > ClimbSurfaceField::MaxVoxels || ResolutionX * ResolutionY * ResolutionZ > ClimbSurfaceField::MaxVoxels)
+    {
+        UE_LOG(LogClimb, Warning, TEXT("%s needs a %lldx%lldx%lld field, more than %lld voxels, use a bigger voxel size"),
+            *GetNameSafe(Mesh), ResolutionX, ResolutionY, ResolutionZ, ClimbSurfaceField::MaxVoxels);
+        return false;
+    }
+
+    UnlockVoxels();
+
+    VoxelSize = InVoxelSize;
+    MaxDistance = InMaxDistance;
+    LocalBounds = BakeBounds;
+    Resolution = FIntVector((int32)ResolutionX, (int32)ResolutionY, (int32)ResolutionZ);
+
+    const int32 NumVoxels = Resolution.X * Resolution.Y * Resolution.Z;
+
+    //Narrow band: every triangle only touches the voxels within MaxDistance of it
+    TArray<float> BestDistanceSq;
+    TArray<FVector> BestNormal;
+    TArray<bool> bBestInside;
+    BestDistanceSq.Init(FMath::Square(MaxDistance), NumVoxels);
+    BestNormal.Init(FVector::UpVector, NumVoxels);
+    bBestInside.Init(false, NumVoxels);
+
+    for (int32 Index = 0; Index + 2 < Indices.Num(); Index += 3)
+    {
+        const FVector& A = Positions[Indices[Index]];
+        const FVector& B = Positions[Indices[Index + 1]];
+        const FVector& C = Positions[Indices[Index + 2]];
+        const FVector FaceNormal = FVector::CrossProduct(C - A, B - A).GetSafeNormal();
+
+        if (FaceNormal.IsZero()) { continue; }
+
+        FBox TriangleBounds(ForceInit);
+        TriangleBounds += A;
+        TriangleBounds += B;
+        TriangleBounds += C;
+        TriangleBounds = TriangleBounds.ExpandBy(MaxDistance);
+
+        const FIntVector Min(
+            FMath::Max(0, FMath::FloorToInt((TriangleBounds.Min.X - LocalBounds.Min.X) / VoxelSize)),
+            FMath::Max(0, FMath::FloorToInt((TriangleBounds.Min.Y - LocalBounds.Min.Y) / VoxelSize)),
+            FMath::Max(0, FMath::FloorToInt((TriangleBounds.Min.Z - LocalBounds.Min.Z) / VoxelSize))
+        );
+        const FIntVector Max(
+            FMath::Min(Resolution.X - 1, FMath::FloorToInt((TriangleBounds.Max.X - LocalBounds.Min.X) / VoxelSize)),
+            FMath::Min(Resolution.Y - 1, FMath::FloorToInt((TriangleBounds.Max.Y - LocalBounds.Min.Y) / VoxelSize)),
+            FMath::Min(Resolution.Z - 1, FMath::FloorToInt((TriangleBounds.Max.Z - LocalBounds.Min.Z) / VoxelSize))
+        );
+
+        for (int32 Z = Min.Z; Z <= Max.Z; Z++)
+        {
+            for (int32 Y = Min.Y; Y <= Max.Y; Y++)
+            {
+                for (int32 X = Min.X; X <= Max.X; X++)
+                {
+                    const FVector VoxelCenter = LocalBounds.Min + (FVector(X, Y, Z) + 0.5f) * VoxelSize;
+                    const FVector Closest = FMath::ClosestPointOnTriangleToPoint(VoxelCenter, A, B, C);
+                    const float DistanceSq = FVector::DistSquared(VoxelCenter, Closest);
+
+                    const int32 VoxelIndex = (Z * Resolution.Y + Y) * Resolution.X + X;
+                    if (DistanceSq >= BestDistanceSq[VoxelIndex]) { continue; }
+
+                    const FVector ToPoint = VoxelCenter - Closest;
+                    const bool bInside = FVector::DotProduct(ToPoint, FaceNormal) < 0.0f;
+
+                    BestDistanceSq[VoxelIndex] = DistanceSq;
+                    bBestInside[VoxelIndex] = bInside;
+                    //Near edges the direction to the closest point is smoother than the face normal
+                    BestNormal[VoxelIndex] = (!bInside && DistanceSq > KINDA_SMALL_NUMBER) ? ToPoint.GetUnsafeNormal() : FaceNormal;
+                }
+            }
+        }
+    }
+
+    TArray<FVoxel> BakedVoxels;
+    BakedVoxels.SetNumUninitialized(NumVoxels);
+
+    for (int32 VoxelIndex = 0; VoxelIndex < NumVoxels; VoxelIndex++)
+    {
+        const float Distance = FMath::Sqrt(BestDistanceSq[VoxelIndex]) * (bBestInside[VoxelIndex] ? -1.0f : 1.0f);
+
+        FVoxel& Voxel = BakedVoxels[VoxelIndex];
+        Voxel.Distance = (int16)FMath::Clamp(FMath::RoundToInt(Distance / MaxDistance * MAX_int16), -MAX_int16, MAX_int16);
+        ClimbSurfaceField::EncodeNormal(BestNormal[VoxelIndex], Voxel.NormalX, Voxel.NormalY);
+    }
+
+    VoxelData.SetBulkDataFlags(BULKDATA_Force_NOT_InlinePayload | BULKDATA_MemoryMappedPayload);
+    VoxelData.Lock(LOCK_READ_WRITE);
+    void* Payload = VoxelData.Realloc(BakedVoxels.Num() * sizeof(FVoxel));
+    FMemory::Memcpy(Payload, BakedVoxels.GetData(), BakedVoxels.Num() * sizeof(FVoxel));
+    VoxelData.Unlock();
+
+    LockVoxels();
+    return IsValidField();
+}
+#endif
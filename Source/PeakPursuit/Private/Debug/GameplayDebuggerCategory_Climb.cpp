@@ -0,0 +1,211 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Debug/GameplayDebuggerCategory_Climb.h"
+
+#if WITH_GAMEPLAY_DEBUGGER && WITH_CLIMB_PROBE_RECORDER
+
+#include "Components/ClimbMovementComponent.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+
+
+FGameplayDebuggerCategory_Climb::FGameplayDebuggerCategory_Climb()
+{
+    bShowOnlyWithDebugActor = true;
+
+    //Replicated, so the server side category of the selected climber scrubs on a dedicated server
+    const FGameplayDebuggerInputHandlerConfig OlderConfig(TEXT("Older"), EKeys::LeftBracket.GetFName());
+    const FGameplayDebuggerInputHandlerConfig NewerConfig(TEXT("Newer"), EKeys::RightBracket.GetFName());
+    const FGameplayDebuggerInputHandlerConfig LiveConfig(TEXT("Live"), EKeys::Backslash.GetFName());
+
+    BindKeyPress(OlderConfig, this, &FGameplayDebuggerCategory_Climb::ShowOlderFrame, EGameplayDebuggerInputMode::Replicated);
+    BindKeyPress(NewerConfig, this, &FGameplayDebuggerCategory_Climb::ShowNewerFrame, EGameplayDebuggerInputMode::Replicated);
+    BindKeyPress(LiveConfig, this, &FGameplayDebuggerCategory_Climb::ShowLiveFrame, EGameplayDebuggerInputMode::Replicated);
+}
+
+
+FGameplayDebuggerCategory_Climb::~FGameplayDebuggerCategory_Climb()
+{
+    SetRecordedMovement(nullptr);
+}
+
+
+TSharedRef<FGameplayDebuggerCategory> FGameplayDebuggerCategory_Climb::MakeInstance()
+{
+    return MakeShareable(new FGameplayDebuggerCategory_Climb());
+}
+
+
+void FGameplayDebuggerCategory_Climb::OnGameplayDebuggerDeactivated()
+{
+    SetRecordedMovement(nullptr);
+}
+
+
+void FGameplayDebuggerCategory_Climb::SetRecordedMovement(UClimbMovementComponent* Movement)
+{
+    if (RecordedMovement.Get() == Movement) { return; }
+
+    if (UClimbMovementComponent* PreviousMovement = RecordedMovement.Get())
+    {
+        PreviousMovement->GetProbeRecorder().SetRecording(false);
+        PreviousMovement->GetProbeRecorder().SetFrozen(false);
+    }
+
+    RecordedMovement = Movement;
+    ScrubFrame.Reset();
+
+    if (Movement)
+    {
+        Movement->GetProbeRecorder().SetRecording(true);
+    }
+}
+
+
+void FGameplayDebuggerCategory_Climb::ShowOlderFrame()
+{
+    UClimbMovementComponent* Movement = RecordedMovement.Get();
+    if (!Movement) { return; }
+
+    FClimbProbeRecorder& ProbeRecorder = Movement->GetProbeRecorder();
+    if (ProbeRecorder.Num() == 0) { return; }
+
+    //Newest first, the first record older than the shown frame starts the previous frame
+    const uint32 ShownFrame = ScrubFrame.Get(ProbeRecorder.GetRecord(0).Frame);
+    for (int32 Age = 0; Age < ProbeRecorder.Num(); Age++)
+    {
+        if (ProbeRecorder.GetRecord(Age).Frame < ShownFrame)
+        {
+            ScrubFrame = ProbeRecorder.GetRecord(Age).Frame;
+            ProbeRecorder.SetFrozen(true);
+            return;
+        }
+    }
+}
+
+
+void FGameplayDebuggerCategory_Climb::ShowNewerFrame()
+{
+    UClimbMovementComponent* Movement = RecordedMovement.Get();
+    if (!Movement || !ScrubFrame.IsSet()) { return; }
+
+    const FClimbProbeRecorder& ProbeRecorder = Movement->GetProbeRecorder();
+
+    //Oldest first, the first record newer than the shown frame starts the next frame
+    for (int32 Age = ProbeRecorder.Num() - 1; Age >= 0; Age--)
+    {
+        if (ProbeRecorder.GetRecord(Age).Frame > ScrubFrame.GetValue())
+        {
+            ScrubFrame = ProbeRecorder.GetRecord(Age).Frame;
+            return;
+        }
+    }
+}
+
+
+void FGameplayDebuggerCategory_Climb::ShowLiveFrame()
+{
+    ScrubFrame.Reset();
+
+    if (UClimbMovementComponent* Movement = RecordedMovement.Get())
+    {
+        Movement->GetProbeRecorder().SetFrozen(false);
+    }
+}
+
+
+void FGameplayDebuggerCategory_Climb::AddProbeShapes(const FClimbProbeRecord& ProbeRecord)
+{
+    const FVector Start(ProbeRecord.Start);
+    const FVector End(ProbeRecord.End);
+    const FColor ProbeColor = ProbeRecord.NumHits > 0 ? FColor::Green : FColor::Red;
+
+    if (ProbeRecord.Shape == EClimbProbeShape::Capsule)
+    {
+        AddShape(FGameplayDebuggerShape::MakeCapsule(Start, ProbeRecord.Radius, ProbeRecord.HalfHeight, ProbeColor));
+
+        if (!Start.Equals(End))
+        {
+            AddShape(FGameplayDebuggerShape::MakeCapsule(End, ProbeRecord.Radius, ProbeRecord.HalfHeight, ProbeColor));
+        }
+    }
+
+    AddShape(FGameplayDebuggerShape::MakeSegment(Start, End, 1.0f, ProbeColor));
+
+    if (ProbeRecord.NumHits > 0)
+    {
+        const FVector HitLocation(ProbeRecord.HitLocation);
+        AddShape(FGameplayDebuggerShape::MakePoint(HitLocation, 4.0f, FColor::Blue));
+        AddShape(FGameplayDebuggerShape::MakeSegment(HitLocation, HitLocation + FVector(ProbeRecord.HitNormal) * 25.0f, 1.0f, FColor::Cyan));
+    }
+}
+
+
+void FGameplayDebuggerCategory_Climb::CollectData(APlayerController* OwnerPC, AActor* DebugActor)
+{
+    const ACharacter* Character = Cast<ACharacter>(DebugActor);
+    UClimbMovementComponent* Movement = Character ? Cast<UClimbMovementComponent>(Character->GetCharacterMovement()) : nullptr;
+
+    SetRecordedMovement(Movement);
+
+    if (!Movement)
+    {
+        AddTextLine(TEXT("{red}Debug actor has no climb movement"));
+        return;
+    }
+
+    const FClimbStateMachine& StateMachine = Movement->GetClimbStateMachine();
+    AddTextLine(FString::Printf(TEXT("State: {yellow}%s{white}  Mode: {yellow}%s"),
+        ClimbStateMachine::GetStateName(StateMachine.GetState()), Movement->IsClimbing() ? TEXT("Climbing") : *Movement->GetMovementName()));
+
+    const FClimbProbeRecorder& ProbeRecorder = Movement->GetProbeRecorder();
+
+    if (ProbeRecorder.Num() == 0)
+    {
+        AddTextLine(TEXT("{grey}No probes recorded yet"));
+    }
+    else
+    {
+        const uint32 NewestFrame = ProbeRecorder.GetRecord(0).Frame;
+        const uint32 ShownFrame = ScrubFrame.Get(NewestFrame);
+        int32 NumProbes = 0;
+        int32 NumHits = 0;
+
+        for (int32 Age = 0; Age < ProbeRecorder.Num(); Age++)
+        {
+            const FClimbProbeRecord& ProbeRecord = ProbeRecorder.GetRecord(Age);
+            if (ProbeRecord.Frame < ShownFrame) { break; }
+            if (ProbeRecord.Frame != ShownFrame) { continue; }
+
+            AddProbeShapes(ProbeRecord);
+            NumProbes++;
+            NumHits += ProbeRecord.NumHits > 0 ? 1 : 0;
+        }
+
+        AddTextLine(FString::Printf(TEXT("Frame: {yellow}%u{white} (%s)  Probes: {yellow}%d{white}  Hit: {yellow}%d{white}  Recorded: %d"),
+            ShownFrame, ScrubFrame.IsSet() ? *FString::Printf(TEXT("{orange}%u frames back{white}"), NewestFrame - ShownFrame) : TEXT("live"),
+            NumProbes, NumHits, ProbeRecorder.Num()));
+    }
+
+    TArray<FClimbStateTransitionRecord> History;
+    StateMachine.GetHistory(History);
+
+    const double Now = Movement->GetWorld()->GetTimeSeconds();
+    for (int32 RecordIndex = History.Num() - 1; RecordIndex >= FMath::Max(History.Num() - 6, 0); RecordIndex--)
+    {
+        const FClimbStateTransitionRecord& Transition = History[RecordIndex];
+        AddTextLine(FString::Printf(TEXT("  {grey}-%.2fs{white} %s -> %s on %s"), Now - Transition.Time,
+            ClimbStateMachine::GetStateName(Transition.From), ClimbStateMachine::GetStateName(Transition.To), ClimbStateMachine::GetEventName(Transition.Event)));
+    }
+}
+
+
+void FGameplayDebuggerCategory_Climb::DrawData(APlayerController* OwnerPC, FGameplayDebuggerCanvasContext& CanvasContext)
+{
+    CanvasContext.Printf(TEXT("[{yellow}%s{white}] older  [{yellow}%s{white}] newer  [{yellow}%s{white}] live"),
+        *GetInputHandlerDescription(0), *GetInputHandlerDescription(1), *GetInputHandlerDescription(2));
+}
+
+#endif
@@ -0,0 +1,142 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Mass/ClimbMassProcessors.h"
+#include "Mass/ClimbMassFragments.h"
+#include "Climb/ClimbMathKernels.h"
+#include "Climb/ClimbSettings.h"
+#include "Climb/ClimbStats.h"
+#include "Subsystems/ClimbCrowdSubsystem.h"
+#include "MassCommonFragments.h"
+#include "MassExecutionContext.h"
+#include "Engine/World.h"
+#include "Misc/MemStack.h"
+
+
+UClimbMassProcessor::UClimbMassProcessor()
+    : EntityQuery(*this)
+{
+    ExecutionFlags = (int32)(EProcessorExecutionFlags::Standalone | EProcessorExecutionFlags::Server);
+    ProcessingPhase = EMassProcessingPhase::PrePhysics;
+    bAutoRegisterWithProcessingPhases = true;
+}
+
+
+void UClimbMassProcessor::ConfigureQueries()
+{
+    EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadWrite);
+    EntityQuery.AddRequirement<FClimbSurfaceFragment>(EMassFragmentAccess::ReadWrite);
+    EntityQuery.AddRequirement<FClimbVelocityFragment>(EMassFragmentAccess::ReadWrite);
+    EntityQuery.AddConstSharedRequirement<FClimbMassParameters>();
+    EntityQuery.AddTagRequirement<FClimbPromotedTag>(EMassFragmentPresence::None);
+}
+
+
+void UClimbMassProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+    CLIMB_SCOPE(MassProcessor);
+
+    EntityQuery.ForEachEntityChunk(EntityManager, Context, [](FMassExecutionContext& Context)
+    {
+        const TArrayView<FTransformFragment> Transforms = Context.GetMutableFragmentView<FTransformFragment>();
+        const TArrayView<FClimbSurfaceFragment> Surfaces = Context.GetMutableFragmentView<FClimbSurfaceFragment>();
+        const TArrayView<FClimbVelocityFragment> Velocities = Context.GetMutableFragmentView<FClimbVelocityFragment>();
+        const FClimbMassParameters& Parameters = Context.GetConstSharedFragment<FClimbMassParameters>();
+
+        const int32 NumEntities = Context.GetNumEntities();
+        const float DeltaTime = Context.GetDeltaTimeSeconds();
+        const float SnapAlpha = FMath::Min(DeltaTime * Parameters.SnapInterpSpeed, 1.0f);
+
+        //Gather the chunk as structure of arrays. The surface point travels with the climber, so the offset to the
+        //snap target does not depend on this frame's move and is taken relative to the climber to fit in floats
+        FMemMark Mark(FMemStack::Get());
+        ClimbMathKernels::TVectorArray<TMemStackAllocator<>> ClimbVelocities;
+        ClimbMathKernels::TVectorArray<TMemStackAllocator<>> SurfaceNormals;
+        ClimbMathKernels::TVectorArray<TMemStackAllocator<>> SurfaceOffsets;
+        ClimbMathKernels::TVectorArray<TMemStackAllocator<>> SnapVectors;
+        ClimbMathKernels::TQuatArray<TMemStackAllocator<>> Rotations;
+        ClimbVelocities.SetNum(NumEntities);
+        SurfaceNormals.SetNum(NumEntities);
+        SurfaceOffsets.SetNum(NumEntities);
+        Rotations.SetNum(NumEntities);
+
+        for (int32 EntityIndex = 0; EntityIndex < NumEntities; ++EntityIndex)
+        {
+            const FTransform& Transform = Transforms[EntityIndex].GetTransform();
+            const FClimbSurfaceFragment& Surface = Surfaces[EntityIndex];
+            const FVector SnapTarget = Surface.Location + Surface.Normal * Parameters.SurfaceOffset;
+
+            ClimbVelocities.Set(EntityIndex, FVector3f(Velocities[EntityIndex].Velocity));
+            SurfaceNormals.Set(EntityIndex, FVector3f(Surface.Normal));
+            SurfaceOffsets.Set(EntityIndex, FVector3f(SnapTarget - Transform.GetLocation()));
+            Rotations.Set(EntityIndex, FQuat4f(Transform.GetRotation()));
+        }
+
+        //Stay on the plane of the surface, snap along the current facing, then turn towards the surface
+        ClimbMathKernels::PlaneProjectClamped(ClimbVelocities, SurfaceNormals, Parameters.MaxClimbSpeed);
+        ClimbMathKernels::GetSnapVectors(SurfaceOffsets, Rotations, SurfaceNormals, SnapVectors);
+        ClimbMathKernels::InterpClimbRotations(Rotations, SurfaceNormals, DeltaTime, Parameters.ClimbRotInterpSpeed);
+
+        for (int32 EntityIndex = 0; EntityIndex < NumEntities; ++EntityIndex)
+        {
+            FTransform& Transform = Transforms[EntityIndex].GetMutableTransform();
+            FVector& Velocity = Velocities[EntityIndex].Velocity;
+
+            Velocity = FVector(ClimbVelocities.Get(EntityIndex));
+            const FVector Delta = Velocity * DeltaTime;
+            Surfaces[EntityIndex].Location += Delta;
+
+            Transform.SetLocation(Transform.GetLocation() + Delta + FVector(SnapVectors.Get(EntityIndex)) * SnapAlpha);
+            Transform.SetRotation(FQuat(Rotations.Get(EntityIndex)));
+        }
+
+        CLIMB_COUNTER_ADD(ClimbersMass, NumEntities);
+    });
+}
+
+
+UClimbMassPromotionProcessor::UClimbMassPromotionProcessor()
+    : EntityQuery(*this)
+{
+    ExecutionFlags = (int32)(EProcessorExecutionFlags::Standalone | EProcessorExecutionFlags::Server);
+    ProcessingPhase = EMassProcessingPhase::PostPhysics;
+    bAutoRegisterWithProcessingPhases = true;
+    //Queues into a world subsystem
+    bRequiresGameThreadExecution = true;
+}
+
+
+void UClimbMassPromotionProcessor::ConfigureQueries()
+{
+    EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadOnly);
+    EntityQuery.AddTagRequirement<FClimbPromotedTag>(EMassFragmentPresence::None);
+}
+
+
+void UClimbMassPromotionProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+    UClimbCrowdSubsystem* CrowdSubsystem = UWorld::GetSubsystem<UClimbCrowdSubsystem>(EntityManager.GetWorld());
+    if (!CrowdSubsystem || !CrowdSubsystem->CanPromote()) { return; }
+
+    const TArray<FVector>& Viewpoints = CrowdSubsystem->GetViewpoints();
+    const float PromoteDistanceSquared = FMath::Square(GetDefault<UClimbSettings>()->CrowdPromoteDistance);
+
+    EntityQuery.ForEachEntityChunk(EntityManager, Context, [&](FMassExecutionContext& Context)
+    {
+        const TConstArrayView<FTransformFragment> Transforms = Context.GetFragmentView<FTransformFragment>();
+
+        for (int32 EntityIndex = 0; EntityIndex < Context.GetNumEntities(); ++EntityIndex)
+        {
+            const FVector Location = Transforms[EntityIndex].GetTransform().GetLocation();
+
+            for (const FVector& Viewpoint : Viewpoints)
+            {
+                if (FVector::DistSquared(Location, Viewpoint) <= PromoteDistanceSquared)
+                {
+                    CrowdSubsystem->RequestPromotion(Context.GetEntity(EntityIndex));
+                    break;
+                }
+            }
+        }
+    });
+}
@@ -0,0 +1,19 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Mass/ClimbMassTrait.h"
+#include "MassCommonFragments.h"
+#include "MassEntityTemplateRegistry.h"
+#include "MassEntityUtils.h"
+
+
+void UClimbMassTrait::BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const
+{
+    BuildContext.AddFragment<FTransformFragment>();
+    BuildContext.AddFragment<FClimbSurfaceFragment>();
+    BuildContext.AddFragment<FClimbVelocityFragment>();
+
+    FMassEntityManager& EntityManager = UE::Mass::Utils::GetEntityManagerChecked(World);
+    const FConstSharedStruct ParametersFragment = EntityManager.GetOrCreateConstSharedFragment(Parameters);
+    BuildContext.AddConstSharedFragment(ParametersFragment);
+}
@@ -0,0 +1,182 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Subsystems/ClimbCrowdSubsystem.h"
+#include "PeakPursuitCharacter.h"
+#include "AI/ClimbCrowdController.h"
+#include "Components/ClimbMovementComponent.h"
+#include "Mass/ClimbMassFragments.h"
+#include "Climb/ClimbSettings.h"
+#include "Climb/ClimbStats.h"
+#include "MassCommonFragments.h"
+#include "MassEntitySubsystem.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+
+
+bool UClimbCrowdSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+void UClimbCrowdSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    //Load once up front rather than hitching on the first promotion
+    CrowdClimberClass = GetDefault<UClimbSettings>()->CrowdClimberClass.LoadSynchronous();
+}
+
+
+void UClimbCrowdSubsystem::Deinitialize()
+{
+    Promoted.Reset();
+    PendingPromotions.Reset();
+
+    Super::Deinitialize();
+}
+
+
+bool UClimbCrowdSubsystem::CanPromote() const
+{
+    return CrowdClimberClass && Promoted.Num() + PendingPromotions.Num() < GetDefault<UClimbSettings>()->MaxPromotedCrowdClimbers;
+}
+
+
+void UClimbCrowdSubsystem::RequestPromotion(FMassEntityHandle Entity)
+{
+    if (CanPromote())
+    {
+        PendingPromotions.AddUnique(Entity);
+    }
+}
+
+
+void UClimbCrowdSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    UpdateViewpoints();
+
+    //Actors cannot be spawned while Mass is processing, promotions queued during the frame run here
+    for (const FMassEntityHandle Entity : PendingPromotions)
+    {
+        Promote(Entity);
+    }
+    PendingPromotions.Reset();
+
+    const float DemoteDistanceSquared = FMath::Square(GetDefault<UClimbSettings>()->CrowdDemoteDistance);
+    FMassEntityManager& EntityManager = GetWorld()->GetSubsystem<UMassEntitySubsystem>()->GetMutableEntityManager();
+
+    for (auto It = Promoted.CreateIterator(); It; ++It)
+    {
+        APeakPursuitCharacter* Character = It.Value().Get();
+
+        //Character is gone, the entity has nothing left to represent
+        if (!Character)
+        {
+            EntityManager.DestroyEntity(It.Key());
+            It.RemoveCurrent();
+            continue;
+        }
+
+        //Only climbers can be handed back, anything else stays a character until it climbs again
+        if (!Character->GetClimbMovementComponent()->IsClimbing()) { continue; }
+
+        const FVector Location = Character->GetActorLocation();
+        const bool bNearPlayer = Viewpoints.ContainsByPredicate([&](const FVector& Viewpoint)
+        {
+            return FVector::DistSquared(Location, Viewpoint) <= DemoteDistanceSquared;
+        });
+
+        if (!bNearPlayer)
+        {
+            Demote(It.Key(), Character);
+            It.RemoveCurrent();
+        }
+    }
+
+    CLIMB_COUNTER_SET(ClimbersPromoted, Promoted.Num());
+}
+
+
+void UClimbCrowdSubsystem::UpdateViewpoints()
+{
+    Viewpoints.Reset();
+    for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+    {
+        if (const APlayerController* PlayerController = Iterator->Get())
+        {
+            FVector ViewLocation;
+            FRotator ViewRotation;
+            PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+            Viewpoints.Add(ViewLocation);
+        }
+    }
+}
+
+
+void UClimbCrowdSubsystem::Promote(FMassEntityHandle Entity)
+{
+    FMassEntityManager& EntityManager = GetWorld()->GetSubsystem<UMassEntitySubsystem>()->GetMutableEntityManager();
+    if (!EntityManager.IsEntityValid(Entity) || Promoted.Contains(Entity)) { return; }
+
+    const FTransform& Transform = EntityManager.GetFragmentDataChecked<FTransformFragment>(Entity).GetTransform();
+    const FClimbSurfaceFragment& Surface = EntityManager.GetFragmentDataChecked<FClimbSurfaceFragment>(Entity);
+    const FClimbVelocityFragment& Velocity = EntityManager.GetFragmentDataChecked<FClimbVelocityFragment>(Entity);
+
+    //Possessed by a crowd controller instead of the class's own AI, which would not know where the crowd goes
+    APeakPursuitCharacter* Character = GetWorld()->SpawnActorDeferred<APeakPursuitCharacter>(CrowdClimberClass, Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+    if (!Character) { return; }
+
+    Character->AutoPossessAI = EAutoPossessAI::Disabled;
+    Character->FinishSpawning(Transform);
+
+    AClimbCrowdController* CrowdController = GetWorld()->SpawnActor<AClimbCrowdController>();
+    CrowdController->Possess(Character);
+    //Promoted entities are skipped by the Mass simulation, the velocity they had now is the one the character keeps
+    CrowdController->SetDesiredVelocity(Velocity.Velocity);
+
+    UClimbMovementComponent* ClimbMovement = Character->GetClimbMovementComponent();
+    ClimbMovement->StartClimbingOnSurface(Surface.Location, Surface.Normal);
+    ClimbMovement->Velocity = Velocity.Velocity;
+
+    EntityManager.AddTagToEntity(Entity, FClimbPromotedTag::StaticStruct());
+    Promoted.Add(Entity, Character);
+}
+
+
+void UClimbCrowdSubsystem::Demote(FMassEntityHandle Entity, APeakPursuitCharacter* Character)
+{
+    FMassEntityManager& EntityManager = GetWorld()->GetSubsystem<UMassEntitySubsystem>()->GetMutableEntityManager();
+
+    if (EntityManager.IsEntityValid(Entity))
+    {
+        const UClimbMovementComponent* ClimbMovement = Character->GetClimbMovementComponent();
+
+        EntityManager.GetFragmentDataChecked<FTransformFragment>(Entity).SetTransform(Character->GetActorTransform());
+
+        FClimbSurfaceFragment& Surface = EntityManager.GetFragmentDataChecked<FClimbSurfaceFragment>(Entity);
+        Surface.Location = ClimbMovement->GetClimbableSurfaceLocation();
+        Surface.Normal = ClimbMovement->GetClimbableSurfaceNormal();
+
+        EntityManager.GetFragmentDataChecked<FClimbVelocityFragment>(Entity).Velocity = ClimbMovement->Velocity;
+
+        EntityManager.RemoveTagFromEntity(Entity, FClimbPromotedTag::StaticStruct());
+    }
+
+    AController* CrowdController = Character->GetController();
+    Character->Destroy();
+
+    if (CrowdController)
+    {
+        CrowdController->Destroy();
+    }
+}
+
+
+TStatId UClimbCrowdSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UClimbCrowdSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,228 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Subsystems/ClimbGraphSubsystem.h"
+#include "PeakPursuit/PeakPursuit.h"
+#include "AI/ClimbNavLinkComponent.h"
+#include "Climb/ClimbSettings.h"
+#include "Misc/PackageName.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "NavigationData.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+
+
+bool UClimbGraphSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+FString UClimbGraphSubsystem::GetGraphDataPath(const FString& MapPackageName)
+{
+    const FString AssetName = TEXT("ClimbGraph_") + FPackageName::GetShortName(MapPackageName);
+    return GetDefault<UClimbSettings>()->LedgeDataDirectory / AssetName + TEXT(".") + AssetName;
+}
+
+
+void UClimbGraphSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    const FString MapPackageName = UWorld::RemovePIEPrefix(InWorld.GetOutermost()->GetName());
+    GraphData = LoadObject<UClimbGraphData>(nullptr, *GetGraphDataPath(MapPackageName), nullptr, LOAD_NoWarn | LOAD_Quiet);
+
+    if (!GraphData) { return; }
+
+    InvCellSize = 1.0f / GraphData->CellSize;
+    Cells.Reset();
+
+    for (int32 NodeIndex = 0; NodeIndex < GraphData->Nodes.Num(); NodeIndex++)
+    {
+        Cells.FindOrAdd(GetCell(GraphData->Nodes[NodeIndex].Location)).Add(NodeIndex);
+    }
+
+    UE_LOG(LogClimb, Log, TEXT("Indexed %d climb graph nodes of %s in %d cells"), GraphData->Nodes.Num(), *MapPackageName, Cells.Num());
+
+    if (GetDefault<UClimbSettings>()->bRegisterClimbNavLinks)
+    {
+        RegisterNavLinks(InWorld);
+    }
+}
+
+
+void UClimbGraphSubsystem::Deinitialize()
+{
+    GraphData = nullptr;
+    NavLinksActor = nullptr;
+    Cells.Reset();
+
+    Super::Deinitialize();
+}
+
+
+void UClimbGraphSubsystem::RegisterNavLinks(UWorld& InWorld)
+{
+    if (GraphData->Routes.IsEmpty()) { return; }
+
+    //Links added after the nav mesh is built only show up in tiles that can be regenerated, a static nav mesh ignores them
+    for (TActorIterator<ANavigationData> It(&InWorld); It; ++It)
+    {
+        if (It->GetRuntimeGenerationMode() == ERuntimeGenerationType::Static)
+        {
+            UE_LOG(LogClimb, Warning, TEXT("%s has static runtime generation, set it to Dynamic Modifiers Only in the level to use the %d climb nav links"),
+                *It->GetName(), GraphData->Routes.Num());
+            return;
+        }
+    }
+
+    //Links are relative to their owner, an actor at the origin keeps them in world space
+    FActorSpawnParameters SpawnParameters;
+    SpawnParameters.Name = TEXT("ClimbNavLinks");
+    SpawnParameters.ObjectFlags |= RF_Transient;
+    NavLinksActor = InWorld.SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParameters);
+
+    if (!NavLinksActor) { return; }
+
+    //The nav mesh lies on the floor, below the capsule centers of the ground nodes
+    const FVector FloorOffset = FVector::UpVector * GraphData->StandingHalfHeight;
+
+    for (const FClimbGraphRoute& Route : GraphData->Routes)
+    {
+        UClimbNavLinkComponent* NavLink = NewObject<UClimbNavLinkComponent>(NavLinksActor);
+        NavLink->SetRoute(Route.From, Route.To, GraphData->Nodes[Route.From].Location - FloorOffset, GraphData->Nodes[Route.To].Location - FloorOffset);
+        NavLink->RegisterComponent();
+    }
+
+    UE_LOG(LogClimb, Log, TEXT("Registered %d climb nav links"), GraphData->Routes.Num());
+}
+
+
+FIntVector UClimbGraphSubsystem::GetCell(const FVector& Location) const
+{
+    return FIntVector(
+        FMath::FloorToInt(Location.X * InvCellSize),
+        FMath::FloorToInt(Location.Y * InvCellSize),
+        FMath::FloorToInt(Location.Z * InvCellSize)
+    );
+}
+
+
+int32 UClimbGraphSubsystem::FindNearestNode(const FVector& Location, float MaxDistance, TFunctionRef<bool(const FClimbGraphNode&)> Accept) const
+{
+    if (!GraphData) { return INDEX_NONE; }
+
+    const FIntVector MinCell = GetCell(Location - FVector(MaxDistance));
+    const FIntVector MaxCell = GetCell(Location + FVector(MaxDistance));
+
+    int32 NearestNode = INDEX_NONE;
+    float NearestDistSquared = FMath::Square(MaxDistance);
+
+    for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+    {
+        for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+        {
+            for (int32 Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+            {
+                const TArray<int32>* CellNodes = Cells.Find(FIntVector(X, Y, Z));
+                if (!CellNodes) { continue; }
+
+                for (const int32 NodeIndex : *CellNodes)
+                {
+                    const FClimbGraphNode& Node = GraphData->Nodes[NodeIndex];
+                    const float DistSquared = FVector::DistSquared(Node.Location, Location);
+
+                    if (DistSquared <= NearestDistSquared && Accept(Node))
+                    {
+                        NearestNode = NodeIndex;
+                        NearestDistSquared = DistSquared;
+                    }
+                }
+            }
+        }
+    }
+
+    return NearestNode;
+}
+
+
+int32 UClimbGraphSubsystem::FindNearestNode(const FVector& Location, float MaxDistance, EClimbGraphNodeType Type) const
+{
+    return FindNearestNode(Location, MaxDistance, [Type](const FClimbGraphNode& Node) { return Node.Type == Type; });
+}
+
+
+bool UClimbGraphSubsystem::FindPath(int32 StartNode, int32 GoalNode, FClimbGraphPath& OutPath)
+{
+    if (!GraphData)
+    {
+        OutPath.Reset();
+        return false;
+    }
+
+    return Pathfinder.FindPath(*GraphData, StartNode, GoalNode, OutPath);
+}
+
+
+bool UClimbGraphSubsystem::FindPath(const FVector& Start, const FVector& Goal, FClimbGraphPath& OutPath, float MaxNodeDistance)
+{
+    auto AnyNode = [](const FClimbGraphNode&) { return true; };
+
+    const int32 StartNode = FindNearestNode(Start, MaxNodeDistance, AnyNode);
+    const int32 GoalNode = FindNearestNode(Goal, MaxNodeDistance, AnyNode);
+
+    return FindPath(StartNode, GoalNode, OutPath);
+}
+
+
+#if !UE_BUILD_SHIPPING
+
+namespace ClimbGraphBenchmark
+{
+    static void Run(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+    {
+        const int32 NumQueries = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 1000;
+        const int32 Seed = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 0;
+
+        UClimbGraphSubsystem* ClimbGraphSubsystem = World ? World->GetSubsystem<UClimbGraphSubsystem>() : nullptr;
+        const UClimbGraphData* GraphData = ClimbGraphSubsystem ? ClimbGraphSubsystem->GetGraphData() : nullptr;
+
+        if (!GraphData || GraphData->Nodes.IsEmpty())
+        {
+            Ar.Log(TEXT("climb.BenchGraphPath needs a level with a climb graph, see the ClimbGraphBuild commandlet"));
+            return;
+        }
+
+        //Random pairs, most of them are not connected and search everything reachable from the start
+        FRandomStream Random(Seed);
+        FClimbGraphPath Path;
+        int32 NumFound = 0;
+        double TotalSeconds = 0.0;
+        double MaxSeconds = 0.0;
+
+        for (int32 Query = 0; Query < NumQueries; Query++)
+        {
+            const int32 StartNode = Random.RandHelper(GraphData->Nodes.Num());
+            const int32 GoalNode = Random.RandHelper(GraphData->Nodes.Num());
+
+            const double StartTime = FPlatformTime::Seconds();
+            NumFound += ClimbGraphSubsystem->FindPath(StartNode, GoalNode, Path) ? 1 : 0;
+            const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+            TotalSeconds += Seconds;
+            MaxSeconds = FMath::Max(MaxSeconds, Seconds);
+        }
+
+        Ar.Logf(TEXT("%d climb paths over %d nodes and %d links: %d found, mean %.2fus, max %.2fus"), NumQueries,
+            GraphData->Nodes.Num(), GraphData->Links.Num(), NumFound, TotalSeconds * 1e6 / NumQueries, MaxSeconds * 1e6);
+    }
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice ClimbBenchGraphPathCommand(
+    TEXT("climb.BenchGraphPath"),
+    TEXT("climb.BenchGraphPath [Queries] [Seed] - Times A* climb path queries between random nodes of the level's climb graph"),
+    FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&ClimbGraphBenchmark::Run)
+);
+
+#endif
@@ -0,0 +1,121 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Subsystems/ClimbLODSubsystem.h"
+#include "Components/ClimbMovementComponent.h"
+#include "Climb/ClimbStats.h"
+#include "SignificanceManager.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "Misc/App.h"
+
+const FName UClimbLODSubsystem::ClimberSignificanceTag(TEXT("Climber"));
+
+
+bool UClimbLODSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+void UClimbLODSubsystem::Deinitialize()
+{
+    for (const TWeakObjectPtr<UClimbMovementComponent>& Climber : Climbers)
+    {
+        if (USignificanceManager* SignificanceManager = FSignificanceManagerModule::Get(GetWorld()))
+        {
+            SignificanceManager->UnregisterObject(Climber.Get());
+        }
+    }
+    Climbers.Reset();
+
+    Super::Deinitialize();
+}
+
+
+void UClimbLODSubsystem::RegisterClimber(UClimbMovementComponent* ClimbMovement)
+{
+    USignificanceManager* SignificanceManager = FSignificanceManagerModule::Get(GetWorld());
+    if (!SignificanceManager || !ClimbMovement) { return; }
+
+    Climbers.AddUnique(ClimbMovement);
+
+    //Significance is the tier itself, Full being the most significant, and the best tier over all viewpoints wins
+    auto SignificanceFunction = [this](USignificanceManager::FManagedObjectInfo* ObjectInfo, const FTransform& Viewpoint) -> float
+    {
+        const UClimbMovementComponent* Climber = CastChecked<UClimbMovementComponent>(ObjectInfo->GetObject());
+        const ACharacter* Character = Climber->GetCharacterOwner();
+
+        if (!Character) { return 0.0f; }
+
+        //Nothing is ever rendered on a dedicated server or under -nullrhi, distance alone decides there
+        const bool bVisible = !FApp::CanEverRender() || Character->WasRecentlyRendered(GetDefault<UClimbSettings>()->OffscreenTolerance);
+        const float Distance = FVector::Dist(Character->GetActorLocation(), Viewpoint.GetLocation());
+        const EClimbLODTier Tier = GetDefault<UClimbSettings>()->GetTier(Distance, bVisible, Character->IsPlayerControlled());
+
+        return (float)((int32)EClimbLODTier::Num - 1 - (int32)Tier);
+    };
+
+    auto PostSignificanceFunction = [](USignificanceManager::FManagedObjectInfo* ObjectInfo, float OldSignificance, float Significance, bool bFinal)
+    {
+        UClimbMovementComponent* Climber = CastChecked<UClimbMovementComponent>(ObjectInfo->GetObject());
+        Climber->SetClimbLODTier((EClimbLODTier)((int32)EClimbLODTier::Num - 1 - FMath::RoundToInt(Significance)));
+    };
+
+    SignificanceManager->RegisterObject(ClimbMovement, ClimberSignificanceTag, SignificanceFunction, USignificanceManager::EPostSignificanceType::Sequential, PostSignificanceFunction);
+}
+
+
+void UClimbLODSubsystem::UnregisterClimber(UClimbMovementComponent* ClimbMovement)
+{
+    Climbers.Remove(ClimbMovement);
+
+    if (USignificanceManager* SignificanceManager = FSignificanceManagerModule::Get(GetWorld()))
+    {
+        SignificanceManager->UnregisterObject(ClimbMovement);
+    }
+}
+
+
+void UClimbLODSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    USignificanceManager* SignificanceManager = FSignificanceManagerModule::Get(GetWorld());
+    if (!SignificanceManager || Climbers.IsEmpty()) { return; }
+
+    //Every player counts as a viewpoint, so listen and dedicated servers keep climbers near any client at full detail
+    Viewpoints.Reset();
+    for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+    {
+        if (const APlayerController* PlayerController = Iterator->Get())
+        {
+            FVector ViewLocation;
+            FRotator ViewRotation;
+            PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+            Viewpoints.Emplace(ViewRotation, ViewLocation);
+        }
+    }
+
+    SignificanceManager->Update(Viewpoints);
+
+    FMemory::Memzero(ClimbersPerTier);
+    for (const TWeakObjectPtr<UClimbMovementComponent>& Climber : Climbers)
+    {
+        if (Climber.IsValid() && Climber->IsClimbing())
+        {
+            ClimbersPerTier[(int32)Climber->GetClimbLODTier()]++;
+        }
+    }
+
+    CLIMB_COUNTER_SET(ClimbersFull, ClimbersPerTier[(int32)EClimbLODTier::Full]);
+    CLIMB_COUNTER_SET(ClimbersReduced, ClimbersPerTier[(int32)EClimbLODTier::Reduced]);
+    CLIMB_COUNTER_SET(ClimbersKinematic, ClimbersPerTier[(int32)EClimbLODTier::Kinematic]);
+}
+
+
+TStatId UClimbLODSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UClimbLODSubsystem, STATGROUP_Tickables);
+}
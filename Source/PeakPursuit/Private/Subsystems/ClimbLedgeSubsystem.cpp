@@ -0,0 +1,104 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Subsystems/ClimbLedgeSubsystem.h"
+#include "PeakPursuit/PeakPursuit.h"
+#include "Data/ClimbLedgeData.h"
+#include "Climb/ClimbSettings.h"
+#include "Misc/PackageName.h"
+#include "Engine/World.h"
+
+
+bool UClimbLedgeSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+FString UClimbLedgeSubsystem::GetLedgeDataPath(const FString& MapPackageName)
+{
+    const FString AssetName = TEXT("Ledges_") + FPackageName::GetShortName(MapPackageName);
+    return GetDefault<UClimbSettings>()->LedgeDataDirectory / AssetName + TEXT(".") + AssetName;
+}
+
+
+void UClimbLedgeSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    const FString MapPackageName = UWorld::RemovePIEPrefix(InWorld.GetOutermost()->GetName());
+    LedgeData = LoadObject<UClimbLedgeData>(nullptr, *GetLedgeDataPath(MapPackageName), nullptr, LOAD_NoWarn | LOAD_Quiet);
+
+    if (!LedgeData) { return; }
+
+    InvCellSize = 1.0f / LedgeData->CellSize;
+    Cells.Reset();
+
+    //A segment goes into every cell its bounds touch
+    for (int32 SegmentIndex = 0; SegmentIndex < LedgeData->Segments.Num(); SegmentIndex++)
+    {
+        const FClimbLedgeSegment& Segment = LedgeData->Segments[SegmentIndex];
+        const FIntVector MinCell = GetCell(Segment.Start.ComponentMin(Segment.End));
+        const FIntVector MaxCell = GetCell(Segment.Start.ComponentMax(Segment.End));
+
+        for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+        {
+            for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+            {
+                for (int32 Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+                {
+                    Cells.FindOrAdd(FIntVector(X, Y, Z)).Add(SegmentIndex);
+                }
+            }
+        }
+    }
+
+    UE_LOG(LogClimb, Log, TEXT("Indexed %d ledges of %s in %d cells"), LedgeData->Segments.Num(), *MapPackageName, Cells.Num());
+}
+
+
+void UClimbLedgeSubsystem::Deinitialize()
+{
+    LedgeData = nullptr;
+    Cells.Reset();
+
+    Super::Deinitialize();
+}
+
+
+FIntVector UClimbLedgeSubsystem::GetCell(const FVector& Location) const
+{
+    return FIntVector(
+        FMath::FloorToInt(Location.X * InvCellSize),
+        FMath::FloorToInt(Location.Y * InvCellSize),
+        FMath::FloorToInt(Location.Z * InvCellSize)
+    );
+}
+
+
+bool UClimbLedgeSubsystem::FindLedge(const FBox& Bounds, TFunctionRef<bool(const FClimbLedgeSegment&)> Accept) const
+{
+    if (!LedgeData) { return false; }
+
+    const FIntVector MinCell = GetCell(Bounds.Min);
+    const FIntVector MaxCell = GetCell(Bounds.Max);
+
+    for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+    {
+        for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+        {
+            for (int32 Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+            {
+                const TArray<int32>* CellSegments = Cells.Find(FIntVector(X, Y, Z));
+                if (!CellSegments) { continue; }
+
+                for (const int32 SegmentIndex : *CellSegments)
+                {
+                    if (Accept(LedgeData->Segments[SegmentIndex])) { return true; }
+                }
+            }
+        }
+    }
+
+    return false;
+}
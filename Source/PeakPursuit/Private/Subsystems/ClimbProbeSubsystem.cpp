@@ -0,0 +1,140 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Subsystems/ClimbProbeSubsystem.h"
+#include "PeakPursuit/PeakPursuit.h"
+#include "Components/ClimbMovementComponent.h"
+#include "Climb/ClimbSettings.h"
+#include "Climb/ClimbStats.h"
+#include "GameFramework/Character.h"
+#include "Misc/App.h"
+
+
+bool UClimbProbeSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+EClimbProbePriority UClimbProbeSubsystem::GetProbePriority(const UClimbMovementComponent* Climber)
+{
+    const ACharacter* Character = Climber->GetCharacterOwner();
+
+    if (!Character || Character->IsPlayerControlled()) { return EClimbProbePriority::Player; }
+
+    const bool bVisible = !FApp::CanEverRender() || Character->WasRecentlyRendered(GetDefault<UClimbSettings>()->OffscreenTolerance);
+    return bVisible ? EClimbProbePriority::Visible : EClimbProbePriority::Distant;
+}
+
+
+bool UClimbProbeSubsystem::AcquireProbeSlot(const UClimbMovementComponent* Climber, EClimbProbePriority Priority, int32 FramesDeferred)
+{
+    if (Priority == EClimbProbePriority::Player) { return true; }
+
+    if (FramesDeferred >= GetDefault<UClimbSettings>()->ProbeStalenessFrames)
+    {
+        FrameStats.Forced++;
+        return true;
+    }
+
+    //A grant covers one climb tick, the climbers still holding one are kept room for
+    if (Grants.Remove(Climber) > 0 || HasBudgetFor(Grants.Num() + 1))
+    {
+        FrameStats.Granted++;
+        return true;
+    }
+
+    PendingRequests.Add({ Climber, Priority, FramesDeferred });
+    FrameStats.Deferred++;
+    return false;
+}
+
+
+bool UClimbProbeSubsystem::HasBudgetFor(int32 NumTicks) const
+{
+    const UClimbSettings* Settings = GetDefault<UClimbSettings>();
+
+    //Player climbers that did not tick yet this frame are expected to use what they used last frame
+    const int32 PlayerProbesLeft = FMath::Max(LastFrameStats.PlayerProbesIssued - FrameStats.PlayerProbesIssued, 0);
+    if (FrameStats.ProbesIssued + PlayerProbesLeft + NumTicks * AverageProbesPerTick > Settings->MaxProbesPerFrame) { return false; }
+
+    if (Settings->ProbeBudgetMs <= 0.0f) { return true; }
+
+    const double PlayerSecondsLeft = FMath::Max(LastFrameStats.PlayerProbeSeconds - FrameStats.PlayerProbeSeconds, 0.0);
+    return FrameStats.ProbeSeconds + PlayerSecondsLeft + NumTicks * AverageSecondsPerTick <= Settings->ProbeBudgetMs * 0.001;
+}
+
+
+void UClimbProbeSubsystem::ReportProbeCost(EClimbProbePriority Priority, int32 NumProbes, double Seconds)
+{
+    FrameStats.ProbesIssued += NumProbes;
+    FrameStats.ProbeSeconds += Seconds;
+
+    if (Priority == EClimbProbePriority::Player)
+    {
+        FrameStats.PlayerProbesIssued += NumProbes;
+        FrameStats.PlayerProbeSeconds += Seconds;
+        return;
+    }
+
+    //What a probing climb tick costs, to turn the remaining budget into grants
+    AverageProbesPerTick = FMath::Lerp(AverageProbesPerTick, (float)NumProbes, 0.1f);
+    AverageSecondsPerTick = FMath::Lerp(AverageSecondsPerTick, Seconds, 0.1);
+}
+
+
+void UClimbProbeSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    const UClimbSettings* Settings = GetDefault<UClimbSettings>();
+
+    //Player climbers are never deferred, reserve what they used this frame for the next one
+    FrameStats.ProbeBudget = Settings->MaxProbesPerFrame;
+    const int32 RemainingProbes = FMath::Max(Settings->MaxProbesPerFrame - FrameStats.PlayerProbesIssued, 0);
+    const double RemainingSeconds = Settings->ProbeBudgetMs > 0.0f ? FMath::Max(Settings->ProbeBudgetMs * 0.001 - FrameStats.PlayerProbeSeconds, 0.0) : UE_DOUBLE_BIG_NUMBER;
+
+    const int32 GrantsByProbes = FMath::FloorToInt(RemainingProbes / FMath::Max(AverageProbesPerTick, 1.0f));
+    const int32 GrantsBySeconds = AverageSecondsPerTick > 0.0 ? (int32)FMath::Min(RemainingSeconds / AverageSecondsPerTick, (double)MAX_int32) : MAX_int32;
+    FrameStats.GrantBudget = FMath::Min(GrantsByProbes, GrantsBySeconds);
+
+    CLIMB_COUNTER_SET(ClimbProbeBudget, FrameStats.ProbeBudget);
+    CLIMB_COUNTER_SET(ClimbProbeBudgetUsed, FrameStats.ProbesIssued);
+    CLIMB_COUNTER_SET(ClimbProbesDeferred, FrameStats.Deferred);
+    CLIMB_COUNTER_SET(ClimbProbesForced, FrameStats.Forced);
+
+    UE_LOG(LogClimb, VeryVerbose, TEXT("Climb probe budget: %d / %d probes, %.3f ms, %d granted, %d forced, %d deferred"),
+        FrameStats.ProbesIssued, FrameStats.ProbeBudget, FrameStats.ProbeSeconds * 1000.0, FrameStats.Granted, FrameStats.Forced, FrameStats.Deferred);
+
+    LastFrameStats = FrameStats;
+    FrameStats = FClimbProbeFrameStats();
+
+    //Unused grants lapse, their climbers did not need to probe after all
+    Grants.Reset();
+
+    if (!Settings->bEnableProbeBudget)
+    {
+        PendingRequests.Reset();
+        return;
+    }
+
+    PendingRequests.Sort([](const FProbeRequest& A, const FProbeRequest& B)
+    {
+        return A.Priority != B.Priority ? A.Priority < B.Priority : A.FramesDeferred > B.FramesDeferred;
+    });
+
+    const int32 NumGrants = FMath::Min(LastFrameStats.GrantBudget, PendingRequests.Num());
+    for (int32 RequestIndex = 0; RequestIndex < NumGrants; RequestIndex++)
+    {
+        Grants.Add(PendingRequests[RequestIndex].Climber);
+    }
+
+    //The rest is carried over: the climbers ask again next tick with one more frame of wait
+    PendingRequests.Reset();
+}
+
+
+TStatId UClimbProbeSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UClimbProbeSubsystem, STATGROUP_Tickables);
+}
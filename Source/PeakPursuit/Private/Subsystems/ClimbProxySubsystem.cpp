@@ -0,0 +1,131 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Subsystems/ClimbProxySubsystem.h"
+#include "PeakPursuit/PeakPursuit.h"
+#include "Subsystems/ClimbablePrimitiveSubsystem.h"
+#include "Data/ClimbProxyData.h"
+#include "Climb/ClimbSettings.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "EngineUtils.h"
+
+
+bool UClimbProxySubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    return Super::ShouldCreateSubsystem(Outer) && GetDefault<UClimbSettings>()->bUseClimbProxies;
+}
+
+
+bool UClimbProxySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+void UClimbProxySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    ActorSpawnedHandle = GetWorld()->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UClimbProxySubsystem::OnActorSpawned));
+    LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UClimbProxySubsystem::OnLevelAdded);
+}
+
+
+void UClimbProxySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    //Before any actor begins play, so climbers registering with the primitive registry already see the proxies
+    for (TActorIterator<AActor> ActorIt(&InWorld); ActorIt; ++ActorIt)
+    {
+        AddProxies(*ActorIt);
+    }
+
+    UE_LOG(LogClimb, Log, TEXT("Attached %d climb proxies"), NumProxies);
+}
+
+
+void UClimbProxySubsystem::Deinitialize()
+{
+    GetWorld()->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+    FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+
+    Super::Deinitialize();
+}
+
+
+void UClimbProxySubsystem::AddProxies(AActor* Actor)
+{
+    if (!Actor) { return; }
+
+    static const FName ClimbProxyTag(TEXT("ClimbProxy"));
+    UClimbablePrimitiveSubsystem* ClimbablePrimitiveSubsystem = GetWorld()->GetSubsystem<UClimbablePrimitiveSubsystem>();
+
+    TInlineComponentArray<UStaticMeshComponent*> MeshComponents(Actor);
+    for (UStaticMeshComponent* MeshComponent : MeshComponents)
+    {
+        const UStaticMesh* Mesh = MeshComponent->GetStaticMesh();
+        const UClimbProxyData* ProxyData = Mesh ? Mesh->GetAssetUserData<UClimbProxyData>() : nullptr;
+
+        if (!ProxyData || !ProxyData->ProxyMesh || !MeshComponent->IsRegistered() || !MeshComponent->IsQueryCollisionEnabled()) { continue; }
+
+        //Streaming a level back in or a second spawn callback must not stack proxies
+        const bool bHasProxy = MeshComponent->GetAttachChildren().ContainsByPredicate([](const USceneComponent* Child) { return Child && Child->ComponentHasTag(ClimbProxyTag); });
+        if (bHasProxy) { continue; }
+
+        UInstancedStaticMeshComponent* InstancedMeshComponent = Cast<UInstancedStaticMeshComponent>(MeshComponent);
+        UStaticMeshComponent* ProxyComponent = InstancedMeshComponent
+            ? NewObject<UInstancedStaticMeshComponent>(Actor, NAME_None, RF_Transient)
+            : NewObject<UStaticMeshComponent>(Actor, NAME_None, RF_Transient);
+
+        ProxyComponent->ComponentTags.Add(ClimbProxyTag);
+        ProxyComponent->SetMobility(MeshComponent->Mobility);
+        ProxyComponent->SetStaticMesh(ProxyData->ProxyMesh);
+        ProxyComponent->SetCollisionProfileName(UClimbProxyData::GetCollisionProfileName());
+        ProxyComponent->SetVisibility(false);
+        ProxyComponent->SetCastShadow(false);
+        ProxyComponent->SetCanEverAffectNavigation(false);
+        ProxyComponent->SetupAttachment(MeshComponent);
+        ProxyComponent->RegisterComponent();
+
+        //Instance transforms are relative to the component, the proxy sits on its source so they carry over as is
+        if (InstancedMeshComponent)
+        {
+            UInstancedStaticMeshComponent* InstancedProxyComponent = CastChecked<UInstancedStaticMeshComponent>(ProxyComponent);
+            for (int32 InstanceIndex = 0; InstanceIndex < InstancedMeshComponent->GetInstanceCount(); InstanceIndex++)
+            {
+                FTransform InstanceTransform;
+                InstancedMeshComponent->GetInstanceTransform(InstanceIndex, InstanceTransform, false);
+                InstancedProxyComponent->AddInstance(InstanceTransform);
+            }
+        }
+
+        //The registry added the proxy when it registered, before its instances grew its bounds
+        if (ClimbablePrimitiveSubsystem && InstancedMeshComponent)
+        {
+            ClimbablePrimitiveSubsystem->UpdatePrimitiveBounds(ProxyComponent);
+        }
+
+        NumProxies++;
+    }
+}
+
+
+void UClimbProxySubsystem::OnActorSpawned(AActor* Actor)
+{
+    AddProxies(Actor);
+}
+
+
+void UClimbProxySubsystem::OnLevelAdded(ULevel* Level, UWorld* World)
+{
+    if (!Level || World != GetWorld()) { return; }
+
+    for (AActor* Actor : Level->Actors)
+    {
+        AddProxies(Actor);
+    }
+}
@@ -0,0 +1,199 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Subsystems/ClimbablePrimitiveSubsystem.h"
+#include "PeakPursuit/PeakPursuit.h"
+#include "Climb/ClimbSettings.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "CollisionQueryParams.h"
+
+
+bool UClimbablePrimitiveSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    return Super::ShouldCreateSubsystem(Outer) && GetDefault<UClimbSettings>()->bEnableClimbablePrimitiveRegistry;
+}
+
+
+bool UClimbablePrimitiveSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+void UClimbablePrimitiveSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    const UClimbSettings* Settings = GetDefault<UClimbSettings>();
+    ClimbableTree = FClimbAABBTree(Settings->ClimbableBoundsMargin);
+    MaxCandidates = Settings->MaxClimbableCandidates;
+
+    //Global, OnPhysicsStateCreated filters on the world
+    PhysicsStateCreatedHandle = UActorComponent::GlobalCreatePhysicsDelegate.AddUObject(this, &UClimbablePrimitiveSubsystem::OnPhysicsStateCreated);
+    PhysicsStateDestroyedHandle = UActorComponent::GlobalDestroyPhysicsDelegate.AddUObject(this, &UClimbablePrimitiveSubsystem::OnPhysicsStateDestroyed);
+}
+
+
+void UClimbablePrimitiveSubsystem::Deinitialize()
+{
+    UActorComponent::GlobalCreatePhysicsDelegate.Remove(PhysicsStateCreatedHandle);
+    UActorComponent::GlobalDestroyPhysicsDelegate.Remove(PhysicsStateDestroyedHandle);
+
+    for (const FClimbablePrimitive& Primitive : Primitives)
+    {
+        if (UPrimitiveComponent* Component = Primitive.Component.Get())
+        {
+            Component->TransformUpdated.Remove(Primitive.TransformUpdatedHandle);
+        }
+    }
+
+    Primitives.Empty();
+    PrimitiveIndices.Empty();
+    ClimbableTree.Reset();
+    RegisteredObjectTypes = 0;
+
+    Super::Deinitialize();
+}
+
+
+void UClimbablePrimitiveSubsystem::RegisterObjectTypes(const FCollisionObjectQueryParams& ObjectQueryParams)
+{
+    const int32 NewObjectTypes = ObjectQueryParams.GetQueryBitfield() & ~RegisteredObjectTypes;
+    if (NewObjectTypes == 0) { return; }
+
+    const bool bStartTracking = RegisteredObjectTypes == 0;
+    RegisteredObjectTypes |= NewObjectTypes;
+
+    //Every type is tracked once tracking starts, later primitives come in through their physics state
+    if (!bStartTracking) { return; }
+
+    for (TActorIterator<AActor> ActorIt(GetWorld()); ActorIt; ++ActorIt)
+    {
+        TInlineComponentArray<UPrimitiveComponent*> ActorPrimitives(*ActorIt);
+        for (UPrimitiveComponent* Primitive : ActorPrimitives)
+        {
+            if (Primitive->IsPhysicsStateCreated())
+            {
+                AddPrimitive(Primitive);
+            }
+        }
+    }
+
+    UE_LOG(LogClimb, Log, TEXT("Tracking %d climbable primitives, tree height %d"), ClimbableTree.GetNumProxies(), ClimbableTree.GetHeight());
+}
+
+
+void UClimbablePrimitiveSubsystem::UpdatePrimitiveBounds(UPrimitiveComponent* Primitive)
+{
+    if (const int32* PrimitiveIndex = PrimitiveIndices.Find(Primitive))
+    {
+        ClimbableTree.MoveProxy(Primitives[*PrimitiveIndex].ProxyId, Primitive->Bounds.GetBox());
+    }
+}
+
+
+void UClimbablePrimitiveSubsystem::AddPrimitive(UPrimitiveComponent* Primitive)
+{
+    if (PrimitiveIndices.Contains(Primitive)) { return; }
+
+    const int32 PrimitiveIndex = Primitives.Add(FClimbablePrimitive());
+    FClimbablePrimitive& ClimbablePrimitive = Primitives[PrimitiveIndex];
+    ClimbablePrimitive.Component = Primitive;
+    ClimbablePrimitive.Key = Primitive;
+    ClimbablePrimitive.ProxyId = ClimbableTree.CreateProxy(Primitive->Bounds.GetBox(), PrimitiveIndex);
+
+    //Static and stationary primitives never move, only movable ones pay for the callback
+    if (Primitive->Mobility == EComponentMobility::Movable)
+    {
+        ClimbablePrimitive.TransformUpdatedHandle = Primitive->TransformUpdated.AddUObject(this, &UClimbablePrimitiveSubsystem::OnPrimitiveMoved, PrimitiveIndex);
+    }
+
+    PrimitiveIndices.Add(ClimbablePrimitive.Key, PrimitiveIndex);
+}
+
+
+void UClimbablePrimitiveSubsystem::RemovePrimitive(int32 PrimitiveIndex)
+{
+    const FClimbablePrimitive& ClimbablePrimitive = Primitives[PrimitiveIndex];
+
+    if (UPrimitiveComponent* Component = ClimbablePrimitive.Component.Get())
+    {
+        Component->TransformUpdated.Remove(ClimbablePrimitive.TransformUpdatedHandle);
+    }
+
+    ClimbableTree.DestroyProxy(ClimbablePrimitive.ProxyId);
+    PrimitiveIndices.Remove(ClimbablePrimitive.Key);
+    Primitives.RemoveAt(PrimitiveIndex);
+}
+
+
+void UClimbablePrimitiveSubsystem::OnPhysicsStateCreated(UActorComponent* Component)
+{
+    if (RegisteredObjectTypes == 0 || Component->GetWorld() != GetWorld()) { return; }
+
+    //Registration, deferred spawns finishing, streaming and collision turned on all create the physics state
+    if (UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Component))
+    {
+        AddPrimitive(Primitive);
+    }
+}
+
+
+void UClimbablePrimitiveSubsystem::OnPhysicsStateDestroyed(UActorComponent* Component)
+{
+    const UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Component);
+    if (!Primitive || Primitives.IsEmpty()) { return; }
+
+    //Unregistering, destroying the actor and unloading its level all destroy the physics state
+    if (const int32* PrimitiveIndex = PrimitiveIndices.Find(Primitive))
+    {
+        RemovePrimitive(*PrimitiveIndex);
+    }
+}
+
+
+void UClimbablePrimitiveSubsystem::OnPrimitiveMoved(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport, int32 PrimitiveIndex)
+{
+    //Bounds are already updated when the transform update is broadcast
+    const UPrimitiveComponent* Primitive = CastChecked<UPrimitiveComponent>(UpdatedComponent);
+    ClimbableTree.MoveProxy(Primitives[PrimitiveIndex].ProxyId, Primitive->Bounds.GetBox());
+}
+
+
+bool UClimbablePrimitiveSubsystem::GatherCandidates(const FBox& QueryBounds, const FCollisionObjectQueryParams& ObjectQueryParams, FClimbablePrimitiveCandidates& OutCandidates) const
+{
+    OutCandidates.Reset();
+
+    //Types no climber registered are not in the tree, only the scene knows about them
+    const int32 QueryObjectTypes = ObjectQueryParams.GetQueryBitfield();
+    if ((QueryObjectTypes & ~RegisteredObjectTypes) != 0) { return false; }
+
+    bool bTooManyCandidates = false;
+
+    ClimbableTree.Query(QueryBounds, [this, &QueryBounds, QueryObjectTypes, &OutCandidates, &bTooManyCandidates](int32 PrimitiveIndex)
+    {
+        const FClimbablePrimitive& ClimbablePrimitive = Primitives[PrimitiveIndex];
+        UPrimitiveComponent* Component = ClimbablePrimitive.Component.Get();
+
+        //The fat box only says where the primitive may be, its own bounds decide. Object type queries ignore
+        //responses, the type alone decides what a climber hits, and both it and the collision may have changed
+        if (!Component || !Component->IsQueryCollisionEnabled() || !(QueryObjectTypes & ECC_TO_BITFIELD(Component->GetCollisionObjectType()))
+            || !Component->Bounds.GetBox().Intersect(QueryBounds))
+        {
+            return true;
+        }
+
+        if (OutCandidates.Num() >= MaxCandidates)
+        {
+            bTooManyCandidates = true;
+            return false;
+        }
+
+        OutCandidates.Add(Component);
+        return true;
+    });
+
+    return !bTooManyCandidates;
+}
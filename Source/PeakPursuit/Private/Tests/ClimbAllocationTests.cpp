@@ -0,0 +1,45 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Climb/ClimbBenchmark.h"
+#include "Climb/ClimbSettings.h"
+
+//The allocation count is process wide, other threads show up as the odd allocating tick. A steady state climb tick
+//that allocates does so every tick, so up to 1% of the ticks may see an allocation before the test fails
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FClimbTickAllocationTest, "PeakPursuit.Climb.TickAllocations", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FClimbTickAllocationTest::RunTest(const FString& Parameters)
+{
+    FClimbBenchmarkWorld BenchmarkWorld;
+    FString Error;
+
+    if (!BenchmarkWorld.Initialize(GetDefault<UClimbSettings>()->ClimbCharacterClass.ToString(), Error))
+    {
+        AddError(Error);
+        return false;
+    }
+
+    //Climbing in place and along the wall, the warmup fills the probe caches and the first sweep buffers
+    for (const TCHAR* ScenarioName : { TEXT("PhysClimb.Idle"), TEXT("PhysClimb.Up"), TEXT("PhysClimb.Side") })
+    {
+        FClimbBenchmarkSamples Samples;
+
+        if (!BenchmarkWorld.RunScenario(ScenarioName, 60, 600, Samples, Error))
+        {
+            AddError(Error);
+            continue;
+        }
+
+        const int32 MaxAllocatingTicks = Samples.Micros.Num() / 100;
+        AddInfo(FString::Printf(TEXT("%s: %d of %d ticks saw %lld allocations"), ScenarioName, Samples.AllocatingCalls, Samples.Micros.Num(), Samples.Allocations));
+        TestTrue(FString::Printf(TEXT("%s allocates in at most %d of %d steady state ticks"), ScenarioName, MaxAllocatingTicks, Samples.Micros.Num()), Samples.AllocatingCalls <= MaxAllocatingTicks);
+    }
+
+    return !HasAnyErrors();
+}
+
+#endif
@@ -0,0 +1,74 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Climb/ClimbBenchmark.h"
+#include "Climb/ClimbSettings.h"
+#include "Dom/JsonObject.h"
+#include "Misc/CommandLine.h"
+
+//One test per benchmark scenario, run headless with
+//UnrealEditor PeakPursuit.uproject -game -nullrhi -ExecCmds="Automation RunTests Climb; Quit" [-ClimbBenchmarkIterations=2000] [-ClimbBenchmarkBaseline=...] [-ClimbBenchmarkTolerance=10]
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FClimbBenchmarkTest, "PeakPursuit.Climb.Benchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+void FClimbBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+    FClimbBenchmarkWorld::GetScenarioNames(OutTestCommands);
+    OutBeautifiedNames = OutTestCommands;
+}
+
+bool FClimbBenchmarkTest::RunTest(const FString& Parameters)
+{
+    int32 Iterations = 2000;
+    int32 WarmupIterations = 100;
+    float TolerancePercent = 10.0f;
+    FString BaselinePath;
+
+    FParse::Value(FCommandLine::Get(), TEXT("ClimbBenchmarkIterations="), Iterations);
+    FParse::Value(FCommandLine::Get(), TEXT("ClimbBenchmarkWarmup="), WarmupIterations);
+    FParse::Value(FCommandLine::Get(), TEXT("ClimbBenchmarkTolerance="), TolerancePercent);
+    FParse::Value(FCommandLine::Get(), TEXT("ClimbBenchmarkBaseline="), BaselinePath);
+
+    FClimbBenchmarkWorld BenchmarkWorld;
+    FClimbBenchmarkSamples Samples;
+    FString Error;
+
+    if (!BenchmarkWorld.Initialize(GetDefault<UClimbSettings>()->ClimbCharacterClass.ToString(), Error)
+        || !BenchmarkWorld.RunScenario(Parameters, WarmupIterations, Iterations, Samples, Error))
+    {
+        AddError(Error);
+        return false;
+    }
+
+    const TSharedRef<FJsonObject> Summary = Samples.Summarize();
+    AddInfo(FClimbBenchmarkWorld::Describe(Parameters, *Summary));
+
+    if (BaselinePath.IsEmpty()) { return true; }
+
+    const TSharedPtr<FJsonObject> BaselineFunctions = FClimbBenchmarkWorld::LoadBaselineFunctions(BaselinePath);
+    const TSharedPtr<FJsonObject>* Baseline = nullptr;
+
+    if (!BaselineFunctions.IsValid())
+    {
+        AddError(FString::Printf(TEXT("Could not read baseline %s"), *BaselinePath));
+        return false;
+    }
+
+    //Scenarios added after the baseline was written have nothing to compare against
+    if (!BaselineFunctions->TryGetObjectField(Parameters, Baseline)) { return true; }
+
+    FString Description;
+    if (FClimbBenchmarkWorld::IsRegression(*Summary, **Baseline, TolerancePercent, Description))
+    {
+        AddError(FString::Printf(TEXT("Regression against %s: %s"), *BaselinePath, *Description));
+        return false;
+    }
+
+    AddInfo(Description);
+    return true;
+}
+
+#endif
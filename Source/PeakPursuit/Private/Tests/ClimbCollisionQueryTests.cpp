@@ -0,0 +1,108 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Climb/ClimbBenchmark.h"
+#include "Climb/ClimbCollisionQuery.h"
+#include "Climb/ClimbSettings.h"
+#include "Components/ClimbMovementComponent.h"
+#include "PeakPursuitCharacter.h"
+#include "Subsystems/ClimbablePrimitiveSubsystem.h"
+#include "Engine/World.h"
+
+namespace ClimbCollisionQueryTests
+{
+    /** What the climb tick keeps of a sweep, see ProcessClimbableSurfaceInfo */
+    struct FAveragedHits
+    {
+        int32 Num = 0;
+        FVector Location = FVector::ZeroVector;
+        FVector Normal = FVector::ZeroVector;
+
+        explicit FAveragedHits(TConstArrayView<FHitResult> Hits)
+            : Num(Hits.Num())
+        {
+            for (const FHitResult& Hit : Hits)
+            {
+                Location += Hit.ImpactPoint / Hits.Num();
+                Normal += Hit.ImpactNormal;
+            }
+
+            Normal = Normal.GetSafeNormal();
+        }
+    };
+}
+
+//Sweeps answered by the climbable primitive candidates against the same sweeps answered by the scene
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FClimbCandidateSweepParityTest, "PeakPursuit.Climb.CollisionQuery.CandidateSweepParity", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FClimbCandidateSweepParityTest::RunTest(const FString& Parameters)
+{
+    using namespace ClimbCollisionQueryTests;
+
+    FClimbBenchmarkWorld BenchmarkWorld;
+    FString Error;
+
+    if (!BenchmarkWorld.Initialize(GetDefault<UClimbSettings>()->ClimbCharacterClass.ToString(), Error))
+    {
+        AddError(Error);
+        return false;
+    }
+
+    const UWorld* World = BenchmarkWorld.GetCharacter()->GetWorld();
+    const UClimbablePrimitiveSubsystem* PrimitiveRegistry = World->GetSubsystem<UClimbablePrimitiveSubsystem>();
+
+    if (!TestTrue(TEXT("Climbable primitives are registered"), PrimitiveRegistry && PrimitiveRegistry->GetNumPrimitives() > 0))
+    {
+        return false;
+    }
+
+    FClimbCollisionQuery CandidateQuery;
+    FClimbCollisionQuery SceneQuery;
+    CandidateQuery.SetClimbableSurfaceTypes(BenchmarkWorld.GetMovement()->GetClimbableSurfaceTypes());
+    SceneQuery.SetClimbableSurfaceTypes(BenchmarkWorld.GetMovement()->GetClimbableSurfaceTypes());
+    CandidateQuery.SetPrimitiveRegistry(PrimitiveRegistry);
+
+    const float Radius = 50.0f;
+    const float HalfHeight = 72.0f;
+    int32 NumSweepsWithHits = 0;
+
+    //In front of the wall, the ledge and the vault box, moving into them by one unit as the surface probe does and not moving at all
+    for (const float Y : { -400.0f, 0.0f, 2600.0f, 3000.0f, -3000.0f })
+    {
+        for (float X = 150.0f; X <= 300.0f; X += 50.0f)
+        {
+            for (float Z = 50.0f; Z <= 450.0f; Z += 100.0f)
+            {
+                for (const float Length : { 1.0f, 0.0f })
+                {
+                    const FVector Start(X, Y, Z);
+                    const FVector End = Start + FVector::ForwardVector * Length;
+
+                    FClimbHitResults CandidateHits;
+                    FClimbHitResults SceneHits;
+                    CandidateQuery.SweepCapsule(World, Start, End, Radius, HalfHeight, CandidateHits);
+                    SceneQuery.SweepCapsule(World, Start, End, Radius, HalfHeight, SceneHits);
+
+                    const FAveragedHits Candidate(CandidateHits);
+                    const FAveragedHits Scene(SceneHits);
+                    const FString Where = FString::Printf(TEXT("Sweep from %s length %.0f"), *Start.ToCompactString(), Length);
+
+                    if (!TestEqual(Where + TEXT(" hits"), Candidate.Num, Scene.Num) || Scene.Num == 0) { continue; }
+
+                    TestTrue(Where + TEXT(" averaged location"), Candidate.Location.Equals(Scene.Location, 0.5f));
+                    TestTrue(Where + TEXT(" averaged normal"), FVector::DotProduct(Candidate.Normal, Scene.Normal) >= FMath::Cos(FMath::DegreesToRadians(0.5f)));
+                    NumSweepsWithHits++;
+                }
+            }
+        }
+    }
+
+    AddInfo(FString::Printf(TEXT("%d sweeps with hits compared"), NumSweepsWithHits));
+    return TestTrue(TEXT("Some sweeps hit"), NumSweepsWithHits > 0) && !HasAnyErrors();
+}
+
+#endif
@@ -0,0 +1,255 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Climb/ClimbMathKernels.h"
+
+//Every kernel against ClimbMath and the scalar code it replaced, on the same random inputs each run
+namespace ClimbMathKernelsTests
+{
+    using namespace ClimbMathKernels;
+
+    static constexpr int32 NumSamples = 4096;
+    static constexpr int32 Seed = 0;
+    static constexpr uint32 TestFlags = EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::SmokeFilter;
+
+    /** Worst error and number of results out of tolerance, reported once per kernel instead of once per sample */
+    struct FKernelCheck
+    {
+        double Tolerance;
+        double MaxError = 0.0;
+        int32 Mismatches = 0;
+
+        void Check(double Error)
+        {
+            MaxError = FMath::Max(MaxError, Error);
+            if (!(Error <= Tolerance)) { Mismatches++; }
+        }
+
+        bool Report(FAutomationTestBase& Test, const TCHAR* Name) const
+        {
+            return Test.TestEqual(FString::Printf(TEXT("%s mismatches, max error %.3g (tolerance %.3g)"), Name, MaxError, Tolerance), Mismatches, 0);
+        }
+    };
+
+    /** Largest component difference, Q and -Q are the same rotation */
+    static double GetQuatError(const FQuat& A, const FQuat& B)
+    {
+        const double SameSign = FMath::Max(FMath::Max(FMath::Abs(A.X - B.X), FMath::Abs(A.Y - B.Y)), FMath::Max(FMath::Abs(A.Z - B.Z), FMath::Abs(A.W - B.W)));
+        const double OppositeSign = FMath::Max(FMath::Max(FMath::Abs(A.X + B.X), FMath::Abs(A.Y + B.Y)), FMath::Max(FMath::Abs(A.Z + B.Z), FMath::Abs(A.W + B.W)));
+        return FMath::Min(SameSign, OppositeSign);
+    }
+
+    static FVector GetRandomVector(FRandomStream& Random, float Size)
+    {
+        return FVector(Random.FRandRange(-Size, Size), Random.FRandRange(-Size, Size), Random.FRandRange(-Size, Size));
+    }
+
+    static FVector GetRandomSurfaceNormal(FRandomStream& Random, int32 Index)
+    {
+        //Every sixteenth one is a floor or a ceiling, which takes the scalar fallback
+        if (Index % 16 == 0) { return FVector(0.0f, 0.0f, Index % 32 == 0 ? 1.0f : -1.0f); }
+        return Random.GetUnitVector();
+    }
+
+    /** Random climbers as scalar arrays and as the structure of arrays batches the kernels take */
+    struct FKernelInputs
+    {
+        TArray<FVector> Locations;
+        TArray<FVector> SurfaceLocations;
+        TArray<FVector> Normals;
+        TArray<FQuat> Rotations;
+        TArray<FVector> Velocities;
+
+        FVectorArray SurfaceOffsets;
+        FVectorArray SurfaceNormals;
+        FVectorArray ClimbVelocities;
+        FQuatArray ClimbRotations;
+
+        FKernelInputs()
+        {
+            FRandomStream Random(Seed);
+
+            Locations.SetNum(NumSamples);
+            SurfaceLocations.SetNum(NumSamples);
+            Normals.SetNum(NumSamples);
+            Rotations.SetNum(NumSamples);
+            Velocities.SetNum(NumSamples);
+
+            for (int32 Index = 0; Index < NumSamples; Index++)
+            {
+                Locations[Index] = GetRandomVector(Random, 100000.0f);
+                SurfaceLocations[Index] = Locations[Index] + GetRandomVector(Random, 100.0f);
+                Normals[Index] = GetRandomSurfaceNormal(Random, Index);
+                Rotations[Index] = FQuat(Random.GetUnitVector(), Random.FRandRange(-PI, PI));
+                Velocities[Index] = GetRandomVector(Random, 300.0f);
+            }
+
+            //Half the rotations already face their surface, so the reached and near lerp lanes are covered too
+            for (int32 Index = 1; Index < NumSamples; Index += 2)
+            {
+                Rotations[Index] = ClimbMath::GetSurfaceRotation(Normals[Index]);
+            }
+
+            SurfaceOffsets.SetNum(NumSamples);
+            SurfaceNormals.SetNum(NumSamples);
+            ClimbVelocities.SetNum(NumSamples);
+            ClimbRotations.SetNum(NumSamples);
+
+            for (int32 Index = 0; Index < NumSamples; Index++)
+            {
+                SurfaceOffsets.Set(Index, FVector3f(SurfaceLocations[Index] - Locations[Index]));
+                SurfaceNormals.Set(Index, FVector3f(Normals[Index]));
+                ClimbVelocities.Set(Index, FVector3f(Velocities[Index]));
+                ClimbRotations.Set(Index, FQuat4f(Rotations[Index]));
+            }
+        }
+    };
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FClimbKernelSnapVectorTest, "PeakPursuit.Climb.MathKernels.GetSnapVector", ClimbMathKernelsTests::TestFlags)
+
+bool FClimbKernelSnapVectorTest::RunTest(const FString& Parameters)
+{
+    using namespace ClimbMathKernelsTests;
+
+    const FKernelInputs Inputs;
+    FKernelCheck Check{ 1e-3 };
+
+    FVectorArray SnapVectors;
+    GetSnapVectors(Inputs.SurfaceOffsets, Inputs.ClimbRotations, Inputs.SurfaceNormals, SnapVectors);
+
+    for (int32 Index = 0; Index < NumSamples; Index++)
+    {
+        const FVector Expected = ClimbMath::GetSnapVector(Inputs.Locations[Index], Inputs.Rotations[Index].GetForwardVector(), Inputs.SurfaceLocations[Index], Inputs.Normals[Index]);
+        Check.Check((FVector(SnapVectors.Get(Index)) - Expected).GetAbsMax());
+    }
+
+    return Check.Report(*this, TEXT("GetSnapVector"));
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FClimbKernelInterpRotationTest, "PeakPursuit.Climb.MathKernels.InterpClimbRotation", ClimbMathKernelsTests::TestFlags)
+
+bool FClimbKernelInterpRotationTest::RunTest(const FString& Parameters)
+{
+    using namespace ClimbMathKernelsTests;
+
+    const FKernelInputs Inputs;
+    const float DeltaTime = 1.0f / 60.0f;
+
+    //Regular, alpha clamped to one, and a zero speed that returns the target
+    const TPair<const TCHAR*, float> InterpSpeeds[] =
+    {
+        { TEXT("InterpClimbRotation"), 5.0f },
+        { TEXT("InterpClimbRotation.Clamped"), 100.0f },
+        { TEXT("InterpClimbRotation.Snap"), 0.0f },
+    };
+
+    bool bPassed = true;
+
+    for (const TPair<const TCHAR*, float>& Speed : InterpSpeeds)
+    {
+        FKernelCheck Check{ 1e-3 };
+        const float InterpSpeed = Speed.Value;
+
+        FQuatArray Interpolated = Inputs.ClimbRotations;
+        InterpClimbRotations(Interpolated, Inputs.SurfaceNormals, DeltaTime, InterpSpeed);
+
+        for (int32 Index = 0; Index < NumSamples; Index++)
+        {
+            const FQuat Expected = ClimbMath::InterpClimbRotation(Inputs.Rotations[Index], Inputs.Normals[Index], DeltaTime, InterpSpeed);
+            Check.Check(GetQuatError(FQuat(Interpolated.Get(Index)), Expected));
+        }
+
+        bPassed &= Check.Report(*this, Speed.Key);
+    }
+
+    return bPassed;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FClimbKernelPlaneProjectTest, "PeakPursuit.Climb.MathKernels.PlaneProjectClamped", ClimbMathKernelsTests::TestFlags)
+
+bool FClimbKernelPlaneProjectTest::RunTest(const FString& Parameters)
+{
+    using namespace ClimbMathKernelsTests;
+
+    const FKernelInputs Inputs;
+    FKernelCheck Check{ 1e-3 };
+    const float MaxSize = 100.0f;
+
+    FVectorArray Projected = Inputs.ClimbVelocities;
+    PlaneProjectClamped(Projected, Inputs.SurfaceNormals, MaxSize);
+
+    for (int32 Index = 0; Index < NumSamples; Index++)
+    {
+        const FVector Expected = FVector::VectorPlaneProject(Inputs.Velocities[Index], Inputs.Normals[Index]).GetClampedToMaxSize(MaxSize);
+        Check.Check((FVector(Projected.Get(Index)) - Expected).GetAbsMax());
+    }
+
+    return Check.Report(*this, TEXT("PlaneProjectClamped"));
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FClimbKernelWithinAngleTest, "PeakPursuit.Climb.MathKernels.IsWithinAngle", ClimbMathKernelsTests::TestFlags)
+
+bool FClimbKernelWithinAngleTest::RunTest(const FString& Parameters)
+{
+    using namespace ClimbMathKernelsTests;
+
+    const FKernelInputs Inputs;
+    //Booleans, the error is 1 for a disagreement
+    FKernelCheck Check{ 0.0 };
+    const float Degrees[] = { 30.0f, 45.0f, 60.0f, 89.0f };
+    const FVectorLanes Up = Splat(FVector::UpVector);
+
+    for (const float Threshold : Degrees)
+    {
+        const VectorRegister4Float MinDot = VectorSetFloat1(GetMinDotForAngle(Threshold));
+
+        for (int32 Index = 0; Index < Inputs.SurfaceNormals.NumPadded(); Index += NumLanes)
+        {
+            const int32 Mask = VectorMaskBits(IsWithinAngle(Inputs.SurfaceNormals.Load(Index), Up, MinDot));
+
+            for (int32 Lane = 0; Lane < NumLanes && Index + Lane < NumSamples; Lane++)
+            {
+                //Previous ShouldStopClimbing test, skipped on the threshold itself where float rounding decides
+                const float DegreeDiff = FMath::RadiansToDegrees(FMath::Acos(FVector::DotProduct(FVector(Inputs.SurfaceNormals.Get(Index + Lane)), FVector::UpVector)));
+                if (FMath::IsNaN(DegreeDiff) || FMath::IsNearlyEqual(DegreeDiff, Threshold, 1e-3f)) { continue; }
+
+                Check.Check((DegreeDiff <= Threshold) == ((Mask & (1 << Lane)) != 0) ? 0.0 : 1.0);
+            }
+        }
+    }
+
+    return Check.Report(*this, TEXT("IsWithinAngle"));
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FClimbKernelSumTest, "PeakPursuit.Climb.MathKernels.Sum", ClimbMathKernelsTests::TestFlags)
+
+bool FClimbKernelSumTest::RunTest(const FString& Parameters)
+{
+    using namespace ClimbMathKernelsTests;
+
+    const FKernelInputs Inputs;
+    FKernelCheck Check{ 1e-3 };
+
+    FVector Expected = FVector::ZeroVector;
+    for (int32 Index = 0; Index < NumSamples; Index++)
+    {
+        Expected += Inputs.SurfaceLocations[Index] - Inputs.Locations[Index];
+    }
+
+    //Compared as means, a float sum of thousands of offsets drifts in absolute terms
+    Check.Check((FVector(Sum(Inputs.SurfaceOffsets)) - Expected).GetAbsMax() / NumSamples);
+
+    return Check.Report(*this, TEXT("Sum"));
+}
+
+#endif
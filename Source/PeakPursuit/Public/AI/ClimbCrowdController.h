@@ -0,0 +1,29 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIController.h"
+#include "ClimbCrowdController.generated.h"
+
+/**
+ * Drives a crowd climber promoted to a full character with the desired velocity of its Mass entity, so it keeps
+ * going where the crowd sent it. UClimbCrowdSubsystem spawns one per promotion and hands it the entity's
+ * FClimbVelocityFragment once; the velocity is turned into movement input on the surface plane, or the ground
+ * while not climbing.
+ */
+UCLASS()
+class PEAKPURSUIT_API AClimbCrowdController : public AAIController
+{
+	GENERATED_BODY()
+
+public:
+	AClimbCrowdController();
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	void SetDesiredVelocity(const FVector& InDesiredVelocity) { DesiredVelocity = InDesiredVelocity; }
+
+private:
+	FVector DesiredVelocity = FVector::ZeroVector;
+};
@@ -0,0 +1,28 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NavLinkCustomComponent.h"
+#include "ClimbNavLinkComponent.generated.h"
+
+/**
+ * One baked climb route as a one way custom nav link between its ground nodes. Path following that reaches it hands
+ * the controller's UClimbRouteFollowerComponent the climb path and waits until the climber is back on the ground.
+ * Controllers without one get no custom move and walk the link like a plain one.
+ */
+UCLASS()
+class PEAKPURSUIT_API UClimbNavLinkComponent : public UNavLinkCustomComponent
+{
+	GENERATED_BODY()
+
+public:
+	/** Nodes of the route in the level's UClimbGraphData, both ground nodes */
+	void SetRoute(int32 InFromNode, int32 InToNode, const FVector& FromLocation, const FVector& ToLocation);
+
+	virtual bool OnLinkMoveStarted(UObject* PathComp, const FVector& DestPoint) override;
+
+private:
+	int32 FromNode = INDEX_NONE;
+	int32 ToNode = INDEX_NONE;
+};
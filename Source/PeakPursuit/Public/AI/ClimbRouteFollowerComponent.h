@@ -0,0 +1,68 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Climb/ClimbGraphPathfinder.h"
+#include "ClimbRouteFollowerComponent.generated.h"
+
+DECLARE_DELEGATE_OneParam(FOnClimbRouteFinished, bool /*bSuccess*/);
+
+class APeakPursuitCharacter;
+class UClimbMovementComponent;
+struct FClimbInputFrame;
+
+/**
+ * Drives the controlled APeakPursuitCharacter along a climb graph path by pressing the same climb, hop and move inputs
+ * a player would, through APeakPursuitCharacter::ApplyRecordedInput. Add it to AI controllers that should climb,
+ * UClimbNavLinkComponent hands it the climb routes their nav paths go through.
+ */
+UCLASS(ClassGroup = AI, meta = (BlueprintSpawnableComponent))
+class PEAKPURSUIT_API UClimbRouteFollowerComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UClimbRouteFollowerComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/** Follows InPath from its first point, where the climber should be. A path already being followed finishes as failed */
+	void FollowPath(const FClimbGraphPath& InPath, FOnClimbRouteFinished InOnFinished);
+	void AbortPath();
+	bool IsFollowingPath() const { return Path.Points.IsValidIndex(TargetIndex); }
+
+	/** Seconds a single link may take before the path is given up */
+	UPROPERTY(EditAnywhere, Category = "Climb Route", meta = (ClampMin = "0"))
+	float LinkTimeout = 6.0f;
+
+	/** Seconds after pressing an action for its montage to start, longer means the check failed at runtime */
+	UPROPERTY(EditAnywhere, Category = "Climb Route", meta = (ClampMin = "0"))
+	float ActionStartTimeout = 0.5f;
+
+	/** Distance to a node that counts as reaching it */
+	UPROPERTY(EditAnywhere, Category = "Climb Route", meta = (ClampMin = "0"))
+	float AcceptanceRadius = 25.0f;
+
+private:
+	enum class ELinkProgress : uint8
+	{
+		InProgress,
+		Done,
+		Failed
+	};
+
+	ELinkProgress UpdateLink(APeakPursuitCharacter& Climber, const UClimbMovementComponent& Movement, FClimbInputFrame& Frame);
+	ELinkProgress UpdateAction(const UClimbMovementComponent& Movement, bool bEndsClimbing) const;
+	void Finish(bool bSuccess);
+
+	FClimbGraphPath Path;
+	/** Point being moved to, reached over its LinkType */
+	int32 TargetIndex = INDEX_NONE;
+	float LinkTime = 0.0f;
+	float ActionPressedTime = 0.0f;
+	bool bActionPressed = false;
+	bool bActionStarted = false;
+	FOnClimbRouteFinished OnFinished;
+};
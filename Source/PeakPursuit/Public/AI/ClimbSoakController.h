@@ -0,0 +1,72 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIController.h"
+#include "Climb/ClimbStateMachine.h"
+#include "ClimbSoakController.generated.h"
+
+/** What one soak climber did since the stats were last reset */
+struct FClimbSoakStats
+{
+	int64 Queries = 0;
+	int32 MontageFailures = 0;
+	int32 StuckEvents = 0;
+	int32 Respawns = 0;
+	/** Times each state was entered, to tell the climbers actually hop, vault and mantle */
+	int32 StateEntries[(int32)EClimbState::Num] = {};
+};
+
+/**
+ * Roams around its home location and presses the same climb, hop and jump actions a player would, through
+ * APeakPursuitCharacter::ApplyRecordedInput. Spawned by APeakPursuitGameMode in -ClimbSoak runs.
+ */
+UCLASS()
+class PEAKPURSUIT_API AClimbSoakController : public AAIController
+{
+	GENERATED_BODY()
+
+public:
+	AClimbSoakController();
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	void SetHome(const FVector& InHome, float InRoamRadius) { Home = InHome; RoamRadius = InRoamRadius; }
+	void SetRandomSeed(int32 Seed) { Random.Initialize(Seed); }
+	const FVector& GetHome() const { return Home; }
+
+	/** Seconds climbing without moving, or inside one climb action, before the climber counts as stuck */
+	float StuckTime = 5.0f;
+
+	const FClimbSoakStats& GetSoakStats() const { return SoakStats; }
+	void ResetSoakStats() { SoakStats = FClimbSoakStats(); }
+	void AddRespawn() { SoakStats.Respawns++; }
+
+protected:
+	virtual void OnPossess(APawn* InPawn) override;
+
+private:
+	void Decide(const class UClimbMovementComponent& Movement);
+	void UpdateSoakStats(const class UClimbMovementComponent& Movement, float DeltaSeconds);
+	bool UpdateStuck(const class UClimbMovementComponent& Movement, float DeltaSeconds);
+
+	FRandomStream Random;
+	FVector Home = FVector::ZeroVector;
+	float RoamRadius = 1500.0f;
+
+	/** Input held until the next decision, actions are pressed for a single frame */
+	FVector2f GroundMoveValue = FVector2f::ZeroVector;
+	FVector2f ClimbMoveValue = FVector2f::ZeroVector;
+	uint8 PendingActions = 0;
+	float TimeToDecide = 0.0f;
+
+	EClimbState LastState = EClimbState::Idle;
+	float TimeInState = 0.0f;
+	FVector StuckCheckLocation = FVector::ZeroVector;
+	float TimeWithoutMoving = 0.0f;
+
+	int32 LastQueries = 0;
+	int32 LastMontageFailures = 0;
+	FClimbSoakStats SoakStats;
+};
@@ -4,10 +4,14 @@
 
 #include "CoreMinimal.h"
 #include "Animation/AnimInstance.h"
+#include "Animation/ClimbAnimSnapshot.h"
 #include "CharacterAnimInstance.generated.h"
 
 /**
- * 
+ * Copies the movement component's FClimbAnimSnapshot on the game thread and derives everything else from that copy
+ * in NativeThreadSafeUpdateAnimation, so the anim graph can update on worker threads.
+ * ABP_ClimbCharacter still implements BlueprintUpdateAnimation in its event graph, which keeps its update on the game
+ * thread until that logic moves to BlueprintThreadSafeUpdateAnimation and reads Snapshot through property access.
  */
 UCLASS()
 class PEAKPURSUIT_API UCharacterAnimInstance : public UAnimInstance
@@ -22,6 +26,9 @@ private:
 	class UClimbMovementComponent* ClimbMovementComponent;
 
 protected:
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Reference)
+	FClimbAnimSnapshot Snapshot;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Reference)
 	float GroundSpeed;
 
@@ -43,6 +50,7 @@ protected:
 public:
 	virtual void NativeInitializeAnimation() override;
 	virtual void NativeUpdateAnimation(float DeltaSeconds) override;
+	virtual void NativeThreadSafeUpdateAnimation(float DeltaSeconds) override;
 
 private:
 	void GetGroundSpeed();
@@ -0,0 +1,38 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ClimbAnimSnapshot.generated.h"
+
+/**
+ * Movement state the animation needs, published by UClimbMovementComponent once per tick on the game thread.
+ * Anim instances take a copy and never touch the component from worker threads.
+ */
+USTRUCT(BlueprintType)
+struct PEAKPURSUIT_API FClimbAnimSnapshot
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Climb")
+	float GroundSpeed = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Climb")
+	float AirSpeed = 0.0f;
+
+	/** Velocity in the capsule's local space, X into the surface, Y right, Z up */
+	UPROPERTY(BlueprintReadOnly, Category = "Climb")
+	FVector ClimbVelocity = FVector::ZeroVector;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Climb")
+	FVector SurfaceNormal = FVector::ZeroVector;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Climb")
+	bool bIsAccelerating = false;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Climb")
+	bool bIsFalling = false;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Climb")
+	bool bIsClimbing = false;
+};
@@ -0,0 +1,92 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Dynamic bounding volume hierarchy over fattened boxes.
+ * Leaves are inserted next to the sibling that grows the tree's surface area the least and the tree is kept
+ * height balanced with rotations. A leaf keeps its fat box while its bounds stay inside, so objects that move a
+ * little every frame only touch the tree once in a while. Proxy ids stay valid until DestroyProxy.
+ */
+class PEAKPURSUIT_API FClimbAABBTree
+{
+public:
+	explicit FClimbAABBTree(float InFatMargin = 50.0f);
+
+	int32 CreateProxy(const FBox& Bounds, int32 UserData);
+	void DestroyProxy(int32 ProxyId);
+
+	/** Reinserts the proxy once Bounds leave its fat box, returns true when it did */
+	bool MoveProxy(int32 ProxyId, const FBox& Bounds);
+
+	int32 GetUserData(int32 ProxyId) const { return Nodes[ProxyId].UserData; }
+	const FBox& GetFatBounds(int32 ProxyId) const { return Nodes[ProxyId].Bounds; }
+
+	int32 GetNumProxies() const { return NumProxies; }
+	int32 GetHeight() const { return Root != INDEX_NONE ? Nodes[Root].Height : 0; }
+
+	void Reset();
+
+	/** Calls Visitor(UserData) for every proxy whose fat box overlaps Bounds until it returns false */
+	template<typename VisitorType>
+	void Query(const FBox& Bounds, VisitorType&& Visitor) const
+	{
+		if (Root == INDEX_NONE) { return; }
+
+		TArray<int32, TInlineAllocator<64>> Stack;
+		Stack.Add(Root);
+
+		while (!Stack.IsEmpty())
+		{
+			const FNode& Node = Nodes[Stack.Pop(false)];
+			if (!Node.Bounds.Intersect(Bounds)) { continue; }
+
+			if (Node.IsLeaf())
+			{
+				if (!Visitor(Node.UserData)) { return; }
+			}
+			else
+			{
+				Stack.Add(Node.Child1);
+				Stack.Add(Node.Child2);
+			}
+		}
+	}
+
+private:
+	struct FNode
+	{
+		FBox Bounds = FBox(ForceInit);
+		/** Next free node while on the free list */
+		int32 Parent = INDEX_NONE;
+		int32 Child1 = INDEX_NONE;
+		int32 Child2 = INDEX_NONE;
+		int32 UserData = INDEX_NONE;
+		/** Leaves are 0, free nodes INDEX_NONE */
+		int32 Height = INDEX_NONE;
+
+		bool IsLeaf() const { return Child1 == INDEX_NONE; }
+	};
+
+	int32 AllocateNode();
+	void FreeNode(int32 NodeIndex);
+
+	void InsertLeaf(int32 Leaf);
+	void RemoveLeaf(int32 Leaf);
+
+	/** Rotates the subtree at NodeIndex when its children heights differ by more than one, returns its new root */
+	int32 Balance(int32 NodeIndex);
+
+	/** Refits bounds and heights from NodeIndex up to the root, balancing on the way */
+	void RefitAncestors(int32 NodeIndex);
+
+	static double GetSurfaceArea(const FBox& Box);
+
+	TArray<FNode> Nodes;
+	int32 Root = INDEX_NONE;
+	int32 FreeList = INDEX_NONE;
+	int32 NumProxies = 0;
+	float FatMargin;
+};
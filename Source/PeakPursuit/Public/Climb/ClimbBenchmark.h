@@ -0,0 +1,80 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FJsonObject;
+class UWorld;
+class APeakPursuitCharacter;
+class UClimbMovementComponent;
+class UStaticMeshComponent;
+namespace ClimbBenchmark { struct FScenario; }
+
+#if !UE_BUILD_SHIPPING
+
+/** Per call timings and counts of one benchmark scenario */
+struct PEAKPURSUIT_API FClimbBenchmarkSamples
+{
+	TArray<double> Micros;
+	int64 Queries = 0;
+	int64 Allocations = 0;
+	/** Calls during which anything in the process allocated, other threads included */
+	int32 AllocatingCalls = 0;
+	int64 MoveSweeps = 0;
+	int64 TransformUpdates = 0;
+
+	/** Mean, p50 and p99 timings and the per call counts, as written to the benchmark report */
+	TSharedRef<FJsonObject> Summarize();
+};
+
+/**
+ * Transient level with a climbable wall, a ledge, a vault box and a moving platform, and one climbing character to drive through the
+ * scripted benchmark scenarios. Used by the ClimbBenchmark commandlet and the PeakPursuit.Climb automation tests.
+ */
+class PEAKPURSUIT_API FClimbBenchmarkWorld
+{
+public:
+	static constexpr float DeltaTime = 1.0f / 60.0f;
+
+	~FClimbBenchmarkWorld();
+
+	/** Builds the level and spawns the character, OutError says why it could not */
+	bool Initialize(const FString& CharacterClassPath, FString& OutError);
+
+	static void GetScenarioNames(TArray<FString>& OutNames);
+
+	/** Runs WarmupIterations untimed then Iterations timed calls of the scenario, false when it could not be started */
+	bool RunScenario(const FString& ScenarioName, int32 WarmupIterations, int32 Iterations, FClimbBenchmarkSamples& OutSamples, FString& OutError);
+
+	/** One line summary of a scenario for the log */
+	static FString Describe(const FString& ScenarioName, const FJsonObject& Summary);
+
+	/** Reads the Functions object of a previous report */
+	static TSharedPtr<FJsonObject> LoadBaselineFunctions(const FString& BaselinePath);
+
+	/**
+	 * Compares one scenario against its baseline. Timings are noisy and get a tolerance, query, allocation and move
+	 * counts are deterministic and may not grow.
+	 */
+	static bool IsRegression(const FJsonObject& Summary, const FJsonObject& BaselineSummary, float TolerancePercent, FString& OutDescription);
+
+	APeakPursuitCharacter* GetCharacter() const { return Character; }
+	UClimbMovementComponent* GetMovement() const { return Movement; }
+
+private:
+	void ResetScenario(const ClimbBenchmark::FScenario& Scenario);
+	void StepScenario(const ClimbBenchmark::FScenario& Scenario);
+
+	UWorld* World = nullptr;
+	APeakPursuitCharacter* Character = nullptr;
+	UClimbMovementComponent* Movement = nullptr;
+	int64 NumTransformUpdates = 0;
+
+	/** Climbable platform of the moving base scenario, the only movable geometry */
+	UStaticMeshComponent* MovingBase = nullptr;
+	FVector MovingBaseOrigin = FVector::ZeroVector;
+	int32 NumMovingBaseSteps = 0;
+};
+
+#endif
@@ -0,0 +1,85 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "Climb/ClimbRayFan.h"
+#include "Climb/ClimbProbeRecorder.h"
+#include "Subsystems/ClimbablePrimitiveSubsystem.h"
+
+class UWorld;
+
+/** Object channel of the simplified climb proxies, declared as ClimbProxy in DefaultEngine.ini */
+#define ECC_ClimbProxy ECC_GameTraceChannel1
+
+/** Capsule sweep results, a climb sweep rarely touches more than a few surfaces so they stay off the heap */
+using FClimbHitResults = TArray<FHitResult, TInlineAllocator<8>>;
+
+/**
+ * Native climb collision queries against ClimbableSurfaceTypes.
+ * Query params are built once when the surface types change and every result is written into
+ * caller owned buffers, so a steady state climb tick does not allocate. Debug drawing is left to the caller.
+ */
+class PEAKPURSUIT_API FClimbCollisionQuery
+{
+public:
+	FClimbCollisionQuery();
+
+	void SetClimbableSurfaceTypes(const TArray<TEnumAsByte<EObjectTypeQuery>>& InClimbableSurfaceTypes);
+
+	/** Multi capsule sweep, OutHits is reset before it is filled */
+	bool SweepCapsule(const UWorld* World, const FVector& Start, const FVector& End, float Radius, float HalfHeight, FClimbHitResults& OutHits) const;
+
+	/** Single line trace, OutHit always carries TraceStart/TraceEnd */
+	bool LineTrace(const UWorld* World, const FVector& Start, const FVector& End, FHitResult& OutHit) const;
+
+	/**
+	 * Traces the rays of a fan in order with shared query params.
+	 * Rays outside RayMask are skipped and tracing stops as soon as IsDecided returns true.
+	 * @return number of rays traced
+	 */
+	int32 TraceRayFan(const UWorld* World, FClimbRayFan& Fan, uint32 RayMask, TFunctionRef<bool(const FClimbRayFan&)> IsDecided) const;
+	int32 TraceRayFan(const UWorld* World, FClimbRayFan& Fan) const;
+
+	const FCollisionObjectQueryParams& GetObjectQueryParams() const { return ObjectQueryParams; }
+	const FCollisionQueryParams& GetSweepQueryParams() const { return SweepQueryParams; }
+	const FCollisionQueryParams& GetLineQueryParams() const { return LineQueryParams; }
+
+	/** Queries issued since the last reset */
+	int32 GetNumQueries() const { return NumQueries; }
+	void ResetNumQueries() { NumQueries = 0; }
+
+	/** Culls queries against the registry's climbable primitives first, the scene answers when there are too many */
+	void SetPrimitiveRegistry(const UClimbablePrimitiveSubsystem* InPrimitiveRegistry) { PrimitiveRegistry = InPrimitiveRegistry; }
+
+#if WITH_CLIMB_PROBE_RECORDER
+	/** Every query is recorded into it while it is recording, it must outlive this query */
+	void SetProbeRecorder(FClimbProbeRecorder* InProbeRecorder) { ProbeRecorder = InProbeRecorder; }
+#endif
+
+private:
+	/**
+	 * True when the registry can answer a query within Bounds, OutCandidates are the only primitives it may hit.
+	 * Multi sweeps pass bSingleShapesOnly, a primitive with several shapes has one scene hit per shape.
+	 */
+	bool GatherCandidates(const FBox& Bounds, FClimbablePrimitiveCandidates& OutCandidates, bool bSingleShapesOnly = false) const;
+
+	/** Closest hit of a line over the candidates, what the single line trace against the scene would return */
+	bool LineTraceCandidates(const FClimbablePrimitiveCandidates& Candidates, const FVector& Start, const FVector& End, FHitResult& OutHit) const;
+
+	FCollisionObjectQueryParams ObjectQueryParams;
+	FCollisionQueryParams SweepQueryParams;
+	FCollisionQueryParams LineQueryParams;
+
+	mutable int32 NumQueries = 0;
+
+	/** Scene sweep results before they are copied into the caller's inline buffer */
+	mutable TArray<FHitResult> SceneHits;
+
+	const UClimbablePrimitiveSubsystem* PrimitiveRegistry = nullptr;
+
+#if WITH_CLIMB_PROBE_RECORDER
+	FClimbProbeRecorder* ProbeRecorder = nullptr;
+#endif
+};
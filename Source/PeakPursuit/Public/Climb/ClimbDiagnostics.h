@@ -0,0 +1,17 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/MemoryBase.h"
+
+namespace ClimbDiagnostics
+{
+#if !UE_BUILD_SHIPPING
+	/** Process wide count of malloc and realloc calls, only meaningful as a delta */
+	inline uint64 GetAllocationCount()
+	{
+		return static_cast<uint64>(FMalloc::TotalMallocCalls) + static_cast<uint64>(FMalloc::TotalReallocCalls);
+	}
+#endif
+}
@@ -0,0 +1,68 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Data/ClimbGraphData.h"
+
+/** One stop of a climb path, with the link taken to get there */
+struct FClimbGraphPathPoint
+{
+	int32 Node = INDEX_NONE;
+	FVector Location = FVector::ZeroVector;
+	FVector Normal = FVector::ZeroVector;
+	EClimbGraphNodeType NodeType = EClimbGraphNodeType::Ground;
+	/** Unused on the first point */
+	EClimbGraphLinkType LinkType = EClimbGraphLinkType::Climb;
+};
+
+struct FClimbGraphPath
+{
+	TArray<FClimbGraphPathPoint> Points;
+	float Cost = 0.0f;
+
+	void Reset() { Points.Reset(); Cost = 0.0f; }
+};
+
+/**
+ * A* over a UClimbGraphData. Keeps its scratch arrays between searches and tells stale entries apart
+ * with a search generation, so a search only touches the nodes it expands.
+ */
+class PEAKPURSUIT_API FClimbGraphPathfinder
+{
+public:
+	/** Cheapest path from StartNode to GoalNode, false when the goal cannot be reached */
+	bool FindPath(const UClimbGraphData& Graph, int32 StartNode, int32 GoalNode, FClimbGraphPath& OutPath);
+
+	/**
+	 * Cheapest cost from a ground node to every other ground node reachable over climb links,
+	 * without walking through a ground node on the way. Used to bake the nav link routes.
+	 */
+	void FindGroundRoutes(const UClimbGraphData& Graph, int32 StartNode, TArray<FClimbGraphRoute>& OutRoutes);
+
+	/** Nodes expanded by the last search */
+	int32 GetNumExpanded() const { return NumExpanded; }
+
+private:
+	struct FOpenNode
+	{
+		float Estimate;
+		int32 Node;
+
+		bool operator<(const FOpenNode& Other) const { return Estimate < Other.Estimate; }
+	};
+
+	void BeginSearch(const UClimbGraphData& Graph, int32 StartNode);
+	bool IsVisited(int32 Node) const { return Generations[Node] == Generation; }
+	bool IsClosed(int32 Node) const { return ClosedGenerations[Node] == Generation; }
+	void Visit(int32 Node, int32 Parent, EClimbGraphLinkType Link, float Cost, float Estimate);
+
+	TArray<float> Costs;
+	TArray<int32> Parents;
+	TArray<EClimbGraphLinkType> ParentLinks;
+	TArray<uint32> Generations;
+	TArray<uint32> ClosedGenerations;
+	TArray<FOpenNode> Open;
+	uint32 Generation = 0;
+	int32 NumExpanded = 0;
+};
@@ -0,0 +1,83 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Input actions seen during one frame, each optional field is only serialized when its flag is set */
+struct PEAKPURSUIT_API FClimbInputFrame
+{
+	enum EFlags : uint8
+	{
+		GroundMove = 1 << 0,
+		ClimbMove = 1 << 1,
+		JumpTriggered = 1 << 2,
+		JumpCompleted = 1 << 3,
+		ClimbStarted = 1 << 4,
+		HopStarted = 1 << 5,
+		ControlRotation = 1 << 6,
+	};
+
+	float DeltaTime = 0.0f;
+	uint8 Flags = 0;
+	FVector2f GroundMoveValue = FVector2f::ZeroVector;
+	FVector2f ClimbMoveValue = FVector2f::ZeroVector;
+	FRotator3f ControlRotationValue = FRotator3f::ZeroRotator;
+	/** Actor location when the frame started, used to find the first diverging frame on playback */
+	FVector3f Location = FVector3f::ZeroVector;
+
+	bool HasFlag(EFlags Flag) const { return (Flags & Flag) != 0; }
+
+	friend FArchive& operator<<(FArchive& Ar, FClimbInputFrame& Frame);
+};
+
+/** A recorded session: the starting state, every frame of input and the final transform */
+struct PEAKPURSUIT_API FClimbInputRecording
+{
+	static constexpr uint32 Magic = 0x434C4952; // CLIR
+	static constexpr uint32 Version = 2;
+	/** Version 1 recordings have no CharacterClassPath */
+	static constexpr uint32 MinVersion = 1;
+
+	FString MapName;
+	/** Class of the recorded pawn, replayed with the same one */
+	FString CharacterClassPath;
+	int32 RandomSeed = 0;
+	FTransform StartTransform;
+	FRotator StartControlRotation;
+	bool bStartClimbing = false;
+	FVector StartSurfaceLocation = FVector::ZeroVector;
+	FVector StartSurfaceNormal = FVector::ZeroVector;
+	TArray<FClimbInputFrame> Frames;
+	FTransform FinalTransform;
+
+	bool SaveToFile(const FString& Filename) const;
+	bool LoadFromFile(const FString& Filename);
+
+	friend FArchive& operator<<(FArchive& Ar, FClimbInputRecording& Recording);
+};
+
+/** Accumulates the input of the current frame and commits it to the recording once per tick */
+class PEAKPURSUIT_API FClimbInputRecorder
+{
+public:
+	explicit FClimbInputRecorder(const FString& InFilename) : Filename(InFilename) {}
+
+	FClimbInputRecording& GetRecording() { return Recording; }
+	const FString& GetFilename() const { return Filename; }
+
+	void RecordGroundMove(const FVector2D& Value);
+	void RecordClimbMove(const FVector2D& Value);
+	void RecordAction(FClimbInputFrame::EFlags Action);
+
+	/** Closes the current frame, called once per character tick before movement */
+	void CommitFrame(float DeltaTime, const FVector& Location, const FRotator& ControlRotation);
+
+	bool Finish(const FTransform& FinalTransform);
+
+private:
+	FString Filename;
+	FClimbInputRecording Recording;
+	FClimbInputFrame PendingFrame;
+	FRotator LastControlRotation = FRotator::ZeroRotator;
+};
@@ -0,0 +1,37 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Scalar climb math, kept free of any component or world access. Single climbers run it as is, the Mass climb
+ * processors run batches of it through ClimbMathKernels, which are validated against it and fall back to it for floors.
+ */
+namespace ClimbMath
+{
+	/** Offset that pulls a climber at Location, facing Forward, back onto the surface plane */
+	FORCEINLINE FVector GetSnapVector(const FVector& Location, const FVector& Forward, const FVector& SurfaceLocation, const FVector& SurfaceNormal)
+	{
+		const FVector ProjectedToSurface = (SurfaceLocation - Location).ProjectOnTo(Forward);
+		return -SurfaceNormal * ProjectedToSurface.Length();
+	}
+
+	/** Rotation facing into the surface */
+	FORCEINLINE FQuat GetSurfaceRotation(const FVector& SurfaceNormal)
+	{
+		return FRotationMatrix::MakeFromX(-SurfaceNormal).ToQuat();
+	}
+
+	FORCEINLINE FQuat InterpClimbRotation(const FQuat& CurrentQuat, const FVector& SurfaceNormal, float DeltaTime, float InterpSpeed)
+	{
+		return FMath::QInterpTo(CurrentQuat, GetSurfaceRotation(SurfaceNormal), DeltaTime, InterpSpeed);
+	}
+
+	/** Surface plane axes the climb input moves along, from the climber's right and up vectors */
+	FORCEINLINE void GetClimbInputAxes(const FVector& SurfaceNormal, const FVector& Right, const FVector& Up, FVector& OutForward, FVector& OutRight)
+	{
+		OutForward = FVector::CrossProduct(-SurfaceNormal, Right);
+		OutRight = FVector::CrossProduct(-SurfaceNormal, -Up);
+	}
+}
@@ -0,0 +1,419 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/VectorRegister.h"
+#include "Climb/ClimbMath.h"
+
+/**
+ * ClimbMath on VectorRegister4Float, four climbers or contacts per register. Batches are structure of arrays,
+ * one float array per component zero padded to whole registers. A single climber calls ClimbMath directly, spreading
+ * one input over four float lanes would be four times the work at lower precision. Positions go in relative to the
+ * climber, float lanes lose precision at world scale. ClimbMath stays the scalar reference, the PeakPursuit.Climb.MathKernels automation tests compare the two.
+ */
+namespace ClimbMathKernels
+{
+	static constexpr int32 NumLanes = 4;
+
+	struct FVectorLanes
+	{
+		VectorRegister4Float X;
+		VectorRegister4Float Y;
+		VectorRegister4Float Z;
+	};
+
+	struct FQuatLanes
+	{
+		VectorRegister4Float X;
+		VectorRegister4Float Y;
+		VectorRegister4Float Z;
+		VectorRegister4Float W;
+	};
+
+	/** N vectors as one float array per component, padded with zeros to a multiple of NumLanes */
+	template<typename AllocatorType = FDefaultAllocator>
+	struct TVectorArray
+	{
+		TArray<float, AllocatorType> X;
+		TArray<float, AllocatorType> Y;
+		TArray<float, AllocatorType> Z;
+
+		int32 Num() const { return NumElements; }
+		int32 NumPadded() const { return X.Num(); }
+
+		void SetNum(int32 InNum)
+		{
+			NumElements = InNum;
+			const int32 Padded = Align(InNum, NumLanes);
+			X.SetNumUninitialized(Padded, false);
+			Y.SetNumUninitialized(Padded, false);
+			Z.SetNumUninitialized(Padded, false);
+
+			//Padding lanes take part in sums
+			for (int32 Index = InNum; Index < Padded; Index++)
+			{
+				X[Index] = Y[Index] = Z[Index] = 0.0f;
+			}
+		}
+
+		void Set(int32 Index, const FVector3f& Value) { X[Index] = Value.X; Y[Index] = Value.Y; Z[Index] = Value.Z; }
+		FVector3f Get(int32 Index) const { return FVector3f(X[Index], Y[Index], Z[Index]); }
+
+		FVectorLanes Load(int32 Index) const { return { VectorLoad(&X[Index]), VectorLoad(&Y[Index]), VectorLoad(&Z[Index]) }; }
+		void Store(int32 Index, const FVectorLanes& Lanes) { VectorStore(Lanes.X, &X[Index]); VectorStore(Lanes.Y, &Y[Index]); VectorStore(Lanes.Z, &Z[Index]); }
+
+	private:
+		int32 NumElements = 0;
+	};
+
+	/** N quaternions as one float array per component, padding lanes hold the identity */
+	template<typename AllocatorType = FDefaultAllocator>
+	struct TQuatArray
+	{
+		TArray<float, AllocatorType> X;
+		TArray<float, AllocatorType> Y;
+		TArray<float, AllocatorType> Z;
+		TArray<float, AllocatorType> W;
+
+		int32 Num() const { return NumElements; }
+		int32 NumPadded() const { return X.Num(); }
+
+		void SetNum(int32 InNum)
+		{
+			NumElements = InNum;
+			const int32 Padded = Align(InNum, NumLanes);
+			X.SetNumUninitialized(Padded, false);
+			Y.SetNumUninitialized(Padded, false);
+			Z.SetNumUninitialized(Padded, false);
+			W.SetNumUninitialized(Padded, false);
+
+			for (int32 Index = InNum; Index < Padded; Index++)
+			{
+				X[Index] = Y[Index] = Z[Index] = 0.0f;
+				W[Index] = 1.0f;
+			}
+		}
+
+		void Set(int32 Index, const FQuat4f& Value) { X[Index] = Value.X; Y[Index] = Value.Y; Z[Index] = Value.Z; W[Index] = Value.W; }
+		FQuat4f Get(int32 Index) const { return FQuat4f(X[Index], Y[Index], Z[Index], W[Index]); }
+
+		FQuatLanes Load(int32 Index) const { return { VectorLoad(&X[Index]), VectorLoad(&Y[Index]), VectorLoad(&Z[Index]), VectorLoad(&W[Index]) }; }
+		void Store(int32 Index, const FQuatLanes& Lanes) { VectorStore(Lanes.X, &X[Index]); VectorStore(Lanes.Y, &Y[Index]); VectorStore(Lanes.Z, &Z[Index]); VectorStore(Lanes.W, &W[Index]); }
+
+	private:
+		int32 NumElements = 0;
+	};
+
+	using FVectorArray = TVectorArray<>;
+	using FQuatArray = TQuatArray<>;
+
+	// Lane helpers
+
+	FORCEINLINE FVectorLanes Splat(const FVector& Value)
+	{
+		return { VectorSetFloat1((float)Value.X), VectorSetFloat1((float)Value.Y), VectorSetFloat1((float)Value.Z) };
+	}
+
+	FORCEINLINE FQuatLanes Splat(const FQuat& Value)
+	{
+		return { VectorSetFloat1((float)Value.X), VectorSetFloat1((float)Value.Y), VectorSetFloat1((float)Value.Z), VectorSetFloat1((float)Value.W) };
+	}
+
+	FORCEINLINE float GetLane0(const VectorRegister4Float& Lanes)
+	{
+		float Value;
+		VectorStoreFloat1(Lanes, &Value);
+		return Value;
+	}
+
+	FORCEINLINE FVector GetLane0(const FVectorLanes& Lanes)
+	{
+		return FVector(GetLane0(Lanes.X), GetLane0(Lanes.Y), GetLane0(Lanes.Z));
+	}
+
+	FORCEINLINE FQuat GetLane0(const FQuatLanes& Lanes)
+	{
+		return FQuat(GetLane0(Lanes.X), GetLane0(Lanes.Y), GetLane0(Lanes.Z), GetLane0(Lanes.W));
+	}
+
+	FORCEINLINE FVectorLanes Add(const FVectorLanes& A, const FVectorLanes& B)
+	{
+		return { VectorAdd(A.X, B.X), VectorAdd(A.Y, B.Y), VectorAdd(A.Z, B.Z) };
+	}
+
+	FORCEINLINE FVectorLanes Subtract(const FVectorLanes& A, const FVectorLanes& B)
+	{
+		return { VectorSubtract(A.X, B.X), VectorSubtract(A.Y, B.Y), VectorSubtract(A.Z, B.Z) };
+	}
+
+	FORCEINLINE FVectorLanes Scale(const FVectorLanes& A, const VectorRegister4Float& Scale)
+	{
+		return { VectorMultiply(A.X, Scale), VectorMultiply(A.Y, Scale), VectorMultiply(A.Z, Scale) };
+	}
+
+	FORCEINLINE FVectorLanes Negate(const FVectorLanes& A)
+	{
+		return { VectorNegate(A.X), VectorNegate(A.Y), VectorNegate(A.Z) };
+	}
+
+	FORCEINLINE FVectorLanes Select(const VectorRegister4Float& Mask, const FVectorLanes& A, const FVectorLanes& B)
+	{
+		return { VectorSelect(Mask, A.X, B.X), VectorSelect(Mask, A.Y, B.Y), VectorSelect(Mask, A.Z, B.Z) };
+	}
+
+	FORCEINLINE VectorRegister4Float Dot(const FVectorLanes& A, const FVectorLanes& B)
+	{
+		return VectorMultiplyAdd(A.X, B.X, VectorMultiplyAdd(A.Y, B.Y, VectorMultiply(A.Z, B.Z)));
+	}
+
+	FORCEINLINE VectorRegister4Float Dot(const FQuatLanes& A, const FQuatLanes& B)
+	{
+		return VectorMultiplyAdd(A.X, B.X, VectorMultiplyAdd(A.Y, B.Y, VectorMultiplyAdd(A.Z, B.Z, VectorMultiply(A.W, B.W))));
+	}
+
+	FORCEINLINE FVectorLanes Cross(const FVectorLanes& A, const FVectorLanes& B)
+	{
+		return {
+			VectorNegateMultiplyAdd(A.Z, B.Y, VectorMultiply(A.Y, B.Z)),
+			VectorNegateMultiplyAdd(A.X, B.Z, VectorMultiply(A.Z, B.X)),
+			VectorNegateMultiplyAdd(A.Y, B.X, VectorMultiply(A.X, B.Y))
+		};
+	}
+
+	/** Lanes with every component of A and B within Tolerance, FQuat::Equals treats Q and -Q as equal */
+	FORCEINLINE VectorRegister4Float NearlyEqual(const FQuatLanes& A, const FQuatLanes& B, const VectorRegister4Float& Tolerance)
+	{
+		const VectorRegister4Float SameSign = VectorBitwiseAnd(
+			VectorBitwiseAnd(VectorCompareLE(VectorAbs(VectorSubtract(A.X, B.X)), Tolerance), VectorCompareLE(VectorAbs(VectorSubtract(A.Y, B.Y)), Tolerance)),
+			VectorBitwiseAnd(VectorCompareLE(VectorAbs(VectorSubtract(A.Z, B.Z)), Tolerance), VectorCompareLE(VectorAbs(VectorSubtract(A.W, B.W)), Tolerance)));
+		const VectorRegister4Float OppositeSign = VectorBitwiseAnd(
+			VectorBitwiseAnd(VectorCompareLE(VectorAbs(VectorAdd(A.X, B.X)), Tolerance), VectorCompareLE(VectorAbs(VectorAdd(A.Y, B.Y)), Tolerance)),
+			VectorBitwiseAnd(VectorCompareLE(VectorAbs(VectorAdd(A.Z, B.Z)), Tolerance), VectorCompareLE(VectorAbs(VectorAdd(A.W, B.W)), Tolerance)));
+		return VectorBitwiseOr(SameSign, OppositeSign);
+	}
+
+	// Climb math on lanes
+
+	/** GetSnapVector with SurfaceOffset = SurfaceLocation - Location */
+	FORCEINLINE FVectorLanes GetSnapVector(const FVectorLanes& SurfaceOffset, const FVectorLanes& Forward, const FVectorLanes& SurfaceNormal)
+	{
+		//Length of the offset projected on Forward, |Offset.Forward| / |Forward|
+		const VectorRegister4Float Projected = VectorDivide(VectorAbs(Dot(SurfaceOffset, Forward)), VectorSqrt(Dot(Forward, Forward)));
+		return Scale(SurfaceNormal, VectorNegate(Projected));
+	}
+
+	/** FQuat::GetForwardVector */
+	FORCEINLINE FVectorLanes GetForwardVector(const FQuatLanes& Rotation)
+	{
+		const VectorRegister4Float Two = VectorSetFloat1(2.0f);
+		const VectorRegister4Float YY = VectorMultiply(Rotation.Y, Rotation.Y);
+		const VectorRegister4Float ZZ = VectorMultiply(Rotation.Z, Rotation.Z);
+
+		return {
+			VectorNegateMultiplyAdd(Two, VectorAdd(YY, ZZ), GlobalVectorConstants::FloatOne),
+			VectorMultiply(Two, VectorMultiplyAdd(Rotation.X, Rotation.Y, VectorMultiply(Rotation.W, Rotation.Z))),
+			VectorMultiply(Two, VectorNegateMultiplyAdd(Rotation.W, Rotation.Y, VectorMultiply(Rotation.X, Rotation.Z)))
+		};
+	}
+
+	/**
+	 * Minimum dot product with the up vector for a surface within Degrees of flat,
+	 * acos(Dot) <= Degrees is Dot >= cos(Degrees) since acos decreases over [-1, 1]
+	 */
+	FORCEINLINE float GetMinDotForAngle(float Degrees)
+	{
+		return FMath::Cos(FMath::DegreesToRadians(FMath::Clamp(Degrees, 0.0f, 180.0f)));
+	}
+
+	/** Lanes whose normal is within the angle GetMinDotForAngle returned MinDot for */
+	FORCEINLINE VectorRegister4Float IsWithinAngle(const FVectorLanes& Normal, const FVectorLanes& Up, const VectorRegister4Float& MinDot)
+	{
+		return VectorCompareGE(Dot(Normal, Up), MinDot);
+	}
+
+	/** Lanes FRotationMatrix::MakeFromX builds from the world up vector, the others need ClimbMath::GetSurfaceRotation */
+	FORCEINLINE VectorRegister4Float IsSurfaceRotationUpright(const FVectorLanes& SurfaceNormal)
+	{
+		const VectorRegister4Float ZSquared = VectorMultiply(SurfaceNormal.Z, SurfaceNormal.Z);
+		const VectorRegister4Float Threshold = VectorSetFloat1(FMath::Square(1.0f - KINDA_SMALL_NUMBER));
+		return VectorCompareLT(ZSquared, VectorMultiply(Dot(SurfaceNormal, SurfaceNormal), Threshold));
+	}
+
+	/** Normalized (Cos, Sin) of a half angle from a direction proportional to it */
+	FORCEINLINE void NormalizeHalfAngle(VectorRegister4Float& Cos, VectorRegister4Float& Sin)
+	{
+		const VectorRegister4Float InvLength = VectorReciprocalSqrtAccurate(VectorMultiplyAdd(Cos, Cos, VectorMultiply(Sin, Sin)));
+		Cos = VectorMultiply(Cos, InvLength);
+		Sin = VectorMultiply(Sin, InvLength);
+	}
+
+	/**
+	 * ClimbMath::GetSurfaceRotation for upright lanes. Facing -SurfaceNormal is a yaw followed by a pitch with no roll,
+	 * both half angles come from their cosine and sine without any trigonometry.
+	 */
+	FORCEINLINE FQuatLanes GetSurfaceRotation(const FVectorLanes& SurfaceNormal)
+	{
+		const FVectorLanes Facing = Scale(SurfaceNormal, VectorNegate(VectorReciprocalSqrtAccurate(Dot(SurfaceNormal, SurfaceNormal))));
+
+		const VectorRegister4Float CosPitch = VectorSqrt(VectorMultiplyAdd(Facing.X, Facing.X, VectorMultiply(Facing.Y, Facing.Y)));
+		const VectorRegister4Float CosYaw = VectorDivide(Facing.X, CosPitch);
+		const VectorRegister4Float SinYaw = VectorDivide(Facing.Y, CosPitch);
+
+		//(cos a/2, sin a/2) is proportional to (1 + cos a, sin a), and to (sin a, 1 - cos a) near a = 180 where the first vanishes
+		const VectorRegister4Float YawFront = VectorCompareGE(CosYaw, GlobalVectorConstants::FloatZero);
+		VectorRegister4Float HalfCosYaw = VectorSelect(YawFront, VectorAdd(GlobalVectorConstants::FloatOne, CosYaw), SinYaw);
+		VectorRegister4Float HalfSinYaw = VectorSelect(YawFront, SinYaw, VectorSubtract(GlobalVectorConstants::FloatOne, CosYaw));
+		NormalizeHalfAngle(HalfCosYaw, HalfSinYaw);
+
+		//Pitch stays within +-90 so its cosine is never negative
+		VectorRegister4Float HalfCosPitch = VectorAdd(GlobalVectorConstants::FloatOne, CosPitch);
+		VectorRegister4Float HalfSinPitch = Facing.Z;
+		NormalizeHalfAngle(HalfCosPitch, HalfSinPitch);
+
+		//FRotator(Pitch, Yaw, 0).Quaternion()
+		return {
+			VectorMultiply(HalfSinPitch, HalfSinYaw),
+			VectorNegate(VectorMultiply(HalfSinPitch, HalfCosYaw)),
+			VectorMultiply(HalfCosPitch, HalfSinYaw),
+			VectorMultiply(HalfCosPitch, HalfCosYaw)
+		};
+	}
+
+	/** FMath::QInterpTo, Alpha is the clamped DeltaTime * InterpSpeed */
+	FORCEINLINE FQuatLanes InterpTo(const FQuatLanes& Current, const FQuatLanes& Target, const VectorRegister4Float& Alpha)
+	{
+		const VectorRegister4Float RawCosom = Dot(Current, Target);
+		const VectorRegister4Float Cosom = VectorMin(VectorAbs(RawCosom), GlobalVectorConstants::FloatOne);
+
+		//FQuat::Slerp_NotNormalized
+		const VectorRegister4Float Omega = VectorACos(Cosom);
+		const VectorRegister4Float InvSin = VectorReciprocalAccurate(VectorSin(Omega));
+		const VectorRegister4Float OneMinusAlpha = VectorSubtract(GlobalVectorConstants::FloatOne, Alpha);
+
+		const VectorRegister4Float Linear = VectorCompareGE(Cosom, VectorSetFloat1(0.9999f));
+		const VectorRegister4Float Scale0 = VectorSelect(Linear, OneMinusAlpha, VectorMultiply(VectorSin(VectorMultiply(OneMinusAlpha, Omega)), InvSin));
+		VectorRegister4Float Scale1 = VectorSelect(Linear, Alpha, VectorMultiply(VectorSin(VectorMultiply(Alpha, Omega)), InvSin));
+		Scale1 = VectorSelect(VectorCompareGE(RawCosom, GlobalVectorConstants::FloatZero), Scale1, VectorNegate(Scale1));
+
+		FQuatLanes Result = {
+			VectorMultiplyAdd(Current.X, Scale0, VectorMultiply(Target.X, Scale1)),
+			VectorMultiplyAdd(Current.Y, Scale0, VectorMultiply(Target.Y, Scale1)),
+			VectorMultiplyAdd(Current.Z, Scale0, VectorMultiply(Target.Z, Scale1)),
+			VectorMultiplyAdd(Current.W, Scale0, VectorMultiply(Target.W, Scale1))
+		};
+
+		//FQuat::GetNormalized, degenerate lanes become the identity
+		const VectorRegister4Float SquareSum = Dot(Result, Result);
+		const VectorRegister4Float Valid = VectorCompareGE(SquareSum, VectorSetFloat1(SMALL_NUMBER));
+		const VectorRegister4Float InvLength = VectorReciprocalSqrtAccurate(SquareSum);
+		Result.X = VectorSelect(Valid, VectorMultiply(Result.X, InvLength), GlobalVectorConstants::FloatZero);
+		Result.Y = VectorSelect(Valid, VectorMultiply(Result.Y, InvLength), GlobalVectorConstants::FloatZero);
+		Result.Z = VectorSelect(Valid, VectorMultiply(Result.Z, InvLength), GlobalVectorConstants::FloatZero);
+		Result.W = VectorSelect(Valid, VectorMultiply(Result.W, InvLength), GlobalVectorConstants::FloatOne);
+
+		//QInterpTo returns the target as is once it is reached
+		const VectorRegister4Float Reached = NearlyEqual(Current, Target, VectorSetFloat1(KINDA_SMALL_NUMBER));
+		return {
+			VectorSelect(Reached, Target.X, Result.X),
+			VectorSelect(Reached, Target.Y, Result.Y),
+			VectorSelect(Reached, Target.Z, Result.Z),
+			VectorSelect(Reached, Target.W, Result.W)
+		};
+	}
+
+	/** FVector::VectorPlaneProject(Value, Normal).GetClampedToMaxSize(MaxSize) */
+	FORCEINLINE FVectorLanes PlaneProjectClamped(const FVectorLanes& Value, const FVectorLanes& Normal, float MaxSize)
+	{
+		if (MaxSize < KINDA_SMALL_NUMBER)
+		{
+			return { GlobalVectorConstants::FloatZero, GlobalVectorConstants::FloatZero, GlobalVectorConstants::FloatZero };
+		}
+
+		const FVectorLanes Projected = Subtract(Value, Scale(Normal, Dot(Value, Normal)));
+		const VectorRegister4Float SizeSquared = Dot(Projected, Projected);
+		const VectorRegister4Float MaxSizeLanes = VectorSetFloat1(MaxSize);
+		const VectorRegister4Float TooLong = VectorCompareGT(SizeSquared, VectorMultiply(MaxSizeLanes, MaxSizeLanes));
+
+		return Select(TooLong, Scale(Projected, VectorMultiply(MaxSizeLanes, VectorReciprocalSqrtAccurate(SizeSquared))), Projected);
+	}
+
+	// Batches
+
+	/** Sum of every element, padding is zero and adds nothing */
+	template<typename AllocatorType>
+	FVector3f Sum(const TVectorArray<AllocatorType>& Values)
+	{
+		FVectorLanes Total = { GlobalVectorConstants::FloatZero, GlobalVectorConstants::FloatZero, GlobalVectorConstants::FloatZero };
+		for (int32 Index = 0; Index < Values.NumPadded(); Index += NumLanes)
+		{
+			Total = Add(Total, Values.Load(Index));
+		}
+
+		alignas(16) float X[NumLanes];
+		alignas(16) float Y[NumLanes];
+		alignas(16) float Z[NumLanes];
+		VectorStoreAligned(Total.X, X);
+		VectorStoreAligned(Total.Y, Y);
+		VectorStoreAligned(Total.Z, Z);
+		return FVector3f(X[0] + X[1] + X[2] + X[3], Y[0] + Y[1] + Y[2] + Y[3], Z[0] + Z[1] + Z[2] + Z[3]);
+	}
+
+	/** Offsets from each climber to the point its snap pulls it towards, see GetSnapVector */
+	template<typename AllocatorType>
+	void GetSnapVectors(const TVectorArray<AllocatorType>& SurfaceOffsets, const TQuatArray<AllocatorType>& Rotations, const TVectorArray<AllocatorType>& SurfaceNormals, TVectorArray<AllocatorType>& OutSnapVectors)
+	{
+		OutSnapVectors.SetNum(SurfaceOffsets.Num());
+		for (int32 Index = 0; Index < SurfaceOffsets.NumPadded(); Index += NumLanes)
+		{
+			OutSnapVectors.Store(Index, GetSnapVector(SurfaceOffsets.Load(Index), GetForwardVector(Rotations.Load(Index)), SurfaceNormals.Load(Index)));
+		}
+	}
+
+	template<typename AllocatorType>
+	void PlaneProjectClamped(TVectorArray<AllocatorType>& Values, const TVectorArray<AllocatorType>& Normals, float MaxSize)
+	{
+		for (int32 Index = 0; Index < Values.NumPadded(); Index += NumLanes)
+		{
+			Values.Store(Index, PlaneProjectClamped(Values.Load(Index), Normals.Load(Index), MaxSize));
+		}
+	}
+
+	/** ClimbMath::InterpClimbRotation in place, lanes facing straight up or down fall back to the scalar version */
+	template<typename AllocatorType>
+	void InterpClimbRotations(TQuatArray<AllocatorType>& Rotations, const TVectorArray<AllocatorType>& SurfaceNormals, float DeltaTime, float InterpSpeed)
+	{
+		const VectorRegister4Float Alpha = VectorSetFloat1(FMath::Clamp(DeltaTime * InterpSpeed, 0.0f, 1.0f));
+
+		for (int32 Index = 0; Index < Rotations.NumPadded(); Index += NumLanes)
+		{
+			const FVectorLanes Normal = SurfaceNormals.Load(Index);
+			const FQuatLanes Current = Rotations.Load(Index);
+			const FQuatLanes Target = GetSurfaceRotation(Normal);
+			const int32 UprightBits = VectorMaskBits(IsSurfaceRotationUpright(Normal));
+			const FQuatLanes Result = InterpSpeed <= 0.0f ? Target : InterpTo(Current, Target, Alpha);
+
+			if (UprightBits == 0xF)
+			{
+				Rotations.Store(Index, Result);
+				continue;
+			}
+
+			//Floors and ceilings build their rotation from another axis, rare enough to go through the scalar path
+			FQuat4f Fallback[NumLanes];
+			const int32 NumValidLanes = FMath::Min(NumLanes, Rotations.Num() - Index);
+			for (int32 Lane = 0; Lane < NumValidLanes; Lane++)
+			{
+				if (UprightBits & (1 << Lane)) { continue; }
+				Fallback[Lane] = FQuat4f(ClimbMath::InterpClimbRotation(FQuat(Rotations.Get(Index + Lane)), FVector(SurfaceNormals.Get(Index + Lane)), DeltaTime, InterpSpeed));
+			}
+
+			Rotations.Store(Index, Result);
+			for (int32 Lane = 0; Lane < NumValidLanes; Lane++)
+			{
+				if (UprightBits & (1 << Lane)) { continue; }
+				Rotations.Set(Index + Lane, Fallback[Lane]);
+			}
+		}
+	}
+}
@@ -0,0 +1,47 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UStaticMesh;
+struct FClimbLedgeSegment;
+struct FMeshDescription;
+
+/** Editor helpers shared by the climb bake commandlets */
+namespace ClimbMeshUtils
+{
+#if WITH_EDITOR
+	/**
+	 * Gathers the LOD0 source triangles of a mesh in mesh space.
+	 * Sections whose material slot is rejected by the filter are skipped.
+	 */
+	PEAKPURSUIT_API bool GatherTriangles(const UStaticMesh* Mesh, TArray<FVector>& OutPositions, TArray<int32>& OutIndices, TFunctionRef<bool(FName MaterialSlotName)> SectionFilter);
+	PEAKPURSUIT_API bool GatherTriangles(const UStaticMesh* Mesh, TArray<FVector>& OutPositions, TArray<int32>& OutIndices);
+	PEAKPURSUIT_API bool GatherTriangles(const FMeshDescription& MeshDescription, TArray<FVector>& OutPositions, TArray<int32>& OutIndices, TFunctionRef<bool(FName MaterialSlotName)> SectionFilter);
+
+	/** Mesh description with one polygon group holding the triangles, normals are smoothed across shared vertices */
+	PEAKPURSUIT_API void BuildMeshDescription(const TArray<FVector>& Positions, const TArray<int32>& Indices, FName MaterialSlotName, FMeshDescription& OutMeshDescription);
+
+	/** Moves every vertex Weight of the way towards the average of its neighbours, Iterations times */
+	PEAKPURSUIT_API void SmoothTriangles(TArray<FVector>& Positions, const TArray<int32>& Indices, int32 Iterations, float Weight = 0.5f);
+
+	/**
+	 * Distance from points spread over the source triangles, one per SampleSpacing squared of area, to the closest
+	 * proxy triangle. Both meshes are in the same space.
+	 */
+	PEAKPURSUIT_API void MeasureDeviation(const TArray<FVector>& SourcePositions, const TArray<int32>& SourceIndices, const TArray<FVector>& ProxyPositions, const TArray<int32>& ProxyIndices, float SampleSpacing, float& OutMeanDeviation, float& OutMaxDeviation);
+
+	/**
+	 * Finds the convex edges where a wall triangle (|normal Z| below MaxWallNormalZ) meets a walkable triangle
+	 * (normal Z at least WalkableFloorZ) lying behind it, in the space given by Transform.
+	 */
+	PEAKPURSUIT_API void ExtractLedgeSegments(const TArray<FVector>& Positions, const TArray<int32>& Indices, const FTransform& Transform, float WalkableFloorZ, float MaxWallNormalZ, float MinSegmentLength, TArray<FClimbLedgeSegment>& OutSegments);
+
+	/** True when the mesh's default collision object type is one of the climbable types */
+	PEAKPURSUIT_API bool IsClimbableMesh(const UStaticMesh* Mesh, const TArray<TEnumAsByte<EObjectTypeQuery>>& ClimbableSurfaceTypes);
+
+	/** Reads ClimbableSurfaceTypes from the climb movement component of a character class, e.g. the third person blueprint */
+	PEAKPURSUIT_API bool GetClimbableSurfaceTypes(const FString& CharacterClassPath, TArray<TEnumAsByte<EObjectTypeQuery>>& OutTypes);
+#endif
+}
@@ -0,0 +1,112 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CoreGlobals.h"
+#include "Engine/HitResult.h"
+
+/** Compiles the recorder and every call site out, on outside shipping unless the target defines it */
+#ifndef WITH_CLIMB_PROBE_RECORDER
+#define WITH_CLIMB_PROBE_RECORDER !UE_BUILD_SHIPPING
+#endif
+
+enum class EClimbProbeShape : uint8
+{
+	Line,
+	Capsule
+};
+
+/** One climb query as it was issued. Single precision keeps a record in one cache line */
+struct FClimbProbeRecord
+{
+	FVector3f Start;
+	FVector3f End;
+	/** First impact, only set when NumHits is not zero */
+	FVector3f HitLocation;
+	FVector3f HitNormal;
+	/** Low bits of GFrameCounter */
+	uint32 Frame;
+	/** Zero for lines */
+	float Radius;
+	float HalfHeight;
+	EClimbProbeShape Shape;
+	uint8 NumHits;
+};
+
+#if WITH_CLIMB_PROBE_RECORDER
+
+/**
+ * Ring of the last climb queries of one climber, filled by FClimbCollisionQuery as they are issued.
+ * Recording is a branch and a record copy into memory allocated on the first record, nothing is drawn or formatted
+ * until the Climb gameplay debugger category reads the history back. A climber records while the category has it
+ * selected, or with climb.RecordProbes for every climber.
+ */
+class PEAKPURSUIT_API FClimbProbeRecorder
+{
+public:
+	/** Records kept, a power of two */
+	static constexpr int32 Capacity = 1024;
+
+	FORCEINLINE bool IsRecording() const { return !bFrozen && (bRecording || bRecordAll); }
+
+	void SetRecording(bool bInRecording) { bRecording = bInRecording; }
+
+	/** Frozen recorders keep their history while it is scrubbed through */
+	void SetFrozen(bool bInFrozen) { bFrozen = bInFrozen; }
+	bool IsFrozen() const { return bFrozen; }
+
+	FORCEINLINE void RecordLine(const FVector& Start, const FVector& End, bool bHit, const FVector& HitLocation, const FVector& HitNormal)
+	{
+		Record(EClimbProbeShape::Line, Start, End, 0.0f, 0.0f, bHit ? 1 : 0, HitLocation, HitNormal);
+	}
+
+	FORCEINLINE void RecordCapsule(const FVector& Start, const FVector& End, float Radius, float HalfHeight, TConstArrayView<FHitResult> Hits)
+	{
+		const bool bHit = !Hits.IsEmpty();
+		Record(EClimbProbeShape::Capsule, Start, End, Radius, HalfHeight, Hits.Num(),
+			bHit ? Hits[0].ImpactPoint : FVector::ZeroVector, bHit ? Hits[0].ImpactNormal : FVector::ZeroVector);
+	}
+
+	int32 Num() const { return (int32)FMath::Min<uint64>(NumRecorded, Capacity); }
+
+	/** Age 0 is the newest record, up to Num() - 1 */
+	const FClimbProbeRecord& GetRecord(int32 Age) const { return Records[(NumRecorded - 1 - Age) & (Capacity - 1)]; }
+
+	void Reset();
+
+	/** climb.RecordProbes */
+	static bool bRecordAll;
+
+private:
+	FORCEINLINE void Record(EClimbProbeShape Shape, const FVector& Start, const FVector& End, float Radius, float HalfHeight, int32 NumHits, const FVector& HitLocation, const FVector& HitNormal)
+	{
+		if (Records.IsEmpty())
+		{
+			Allocate();
+		}
+
+		FClimbProbeRecord& ProbeRecord = Records[NumRecorded & (Capacity - 1)];
+		ProbeRecord.Start = FVector3f(Start);
+		ProbeRecord.End = FVector3f(End);
+		ProbeRecord.HitLocation = FVector3f(HitLocation);
+		ProbeRecord.HitNormal = FVector3f(HitNormal);
+		ProbeRecord.Frame = (uint32)GFrameCounter;
+		ProbeRecord.Radius = Radius;
+		ProbeRecord.HalfHeight = HalfHeight;
+		ProbeRecord.Shape = Shape;
+		ProbeRecord.NumHits = (uint8)FMath::Min(NumHits, 255);
+		NumRecorded++;
+	}
+
+	void Allocate();
+
+	static_assert(FMath::IsPowerOfTwo(Capacity), "The ring index is masked");
+
+	TArray<FClimbProbeRecord> Records;
+	uint64 NumRecorded = 0;
+	bool bRecording = false;
+	bool bFrozen = false;
+};
+
+#endif
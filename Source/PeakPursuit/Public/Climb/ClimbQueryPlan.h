@@ -0,0 +1,192 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/HitResult.h"
+#include "Components/PrimitiveComponent.h"
+
+/** World probes a climb tick can issue */
+enum class EClimbProbe : uint8
+{
+	Surface,
+	Floor,
+	Ledge,
+
+	Num
+};
+
+/**
+ * Result of a probe and the capsule transform it was taken from,
+ * so it can be reused while the capsule stays put. With a base the transform is kept relative to it,
+ * so the probe also stays valid while the capsule rides along on a moving base.
+ */
+struct FClimbProbeCache
+{
+	FVector Location = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	TWeakObjectPtr<const USceneComponent> Base;
+	bool bValid = false;
+	bool bHit = false;
+	bool bHasBase = false;
+
+	void Store(const FTransform& InTransform, bool bInHit, const USceneComponent* InBase = nullptr)
+	{
+		const FTransform CacheTransform = InBase ? InTransform.GetRelativeTransform(InBase->GetComponentTransform()) : InTransform;
+		Location = CacheTransform.GetLocation();
+		Rotation = CacheTransform.GetRotation();
+		Base = InBase;
+		bHasBase = InBase != nullptr;
+		bValid = true;
+		bHit = bInHit;
+	}
+
+	/** Transform in the space the cache was stored in, false once its base is gone */
+	bool ToCacheSpace(const FTransform& Transform, FTransform& OutTransform) const
+	{
+		if (!bHasBase)
+		{
+			OutTransform = Transform;
+			return true;
+		}
+
+		const USceneComponent* BaseComponent = Base.Get();
+		if (!BaseComponent) { return false; }
+
+		OutTransform = Transform.GetRelativeTransform(BaseComponent->GetComponentTransform());
+		return true;
+	}
+
+	void Invalidate() { bValid = false; }
+};
+
+/**
+ * Surface contacts kept in the space of the movable component they were found on,
+ * so a climber on a moving platform is carried along and keeps using them instead of sweeping again.
+ */
+struct FClimbBaseContacts
+{
+	TWeakObjectPtr<const USceneComponent> Base;
+	/** Base transform the contacts were last moved to */
+	FTransform BaseTransform;
+	TArray<FVector, TInlineAllocator<8>> LocalPoints;
+	TArray<FVector, TInlineAllocator<8>> LocalNormals;
+
+	const USceneComponent* GetBase() const { return Base.Get(); }
+
+	/** Keeps Hits relative to their component when they all lie on the same movable one, forgets the base otherwise */
+	void Store(TConstArrayView<FHitResult> Hits)
+	{
+		Reset();
+
+		const USceneComponent* HitComponent = Hits.IsEmpty() ? nullptr : Hits[0].GetComponent();
+		if (!HitComponent || HitComponent->Mobility != EComponentMobility::Movable) { return; }
+
+		for (const FHitResult& Hit : Hits)
+		{
+			if (Hit.GetComponent() != HitComponent) { return; }
+		}
+
+		Base = HitComponent;
+		BaseTransform = HitComponent->GetComponentTransform();
+
+		for (const FHitResult& Hit : Hits)
+		{
+			LocalPoints.Add(BaseTransform.InverseTransformPosition(Hit.ImpactPoint));
+			LocalNormals.Add(BaseTransform.InverseTransformVectorNoScale(Hit.ImpactNormal));
+		}
+	}
+
+	/**
+	 * Moves Hits with the base since it was last stored or followed, OutDelta maps the old world space onto the new one.
+	 * Returns false when there is no base, it did not move or Hits are not the stored contacts anymore.
+	 */
+	bool Follow(TArrayView<FHitResult> Hits, FTransform& OutDelta)
+	{
+		const USceneComponent* BaseComponent = Base.Get();
+		if (!BaseComponent || Hits.Num() != LocalPoints.Num()) { return false; }
+
+		const FTransform& NewBaseTransform = BaseComponent->GetComponentTransform();
+		if (NewBaseTransform.Equals(BaseTransform, KINDA_SMALL_NUMBER)) { return false; }
+
+		OutDelta = BaseTransform.Inverse() * NewBaseTransform;
+		BaseTransform = NewBaseTransform;
+
+		for (int32 ContactIndex = 0; ContactIndex < Hits.Num(); ContactIndex++)
+		{
+			Hits[ContactIndex].ImpactPoint = BaseTransform.TransformPosition(LocalPoints[ContactIndex]);
+			Hits[ContactIndex].ImpactNormal = BaseTransform.TransformVectorNoScale(LocalNormals[ContactIndex]);
+		}
+
+		return true;
+	}
+
+	void Reset()
+	{
+		Base.Reset();
+		LocalPoints.Reset();
+		LocalNormals.Reset();
+	}
+};
+
+/**
+ * Per-tick plan of the probes PhysClimb needs.
+ * Each probe is either skipped because it cannot change the answer, reused from a previous tick
+ * because the capsule barely moved, or issued against the world.
+ */
+struct FClimbQueryPlan
+{
+	/** Transform delta under which cached probes are reused */
+	float ReuseDistance = 0.1f;
+	float ReuseRadians = 0.0f;
+
+	/** Reuse any valid cache regardless of how far the capsule moved, used by the reduced climb LOD between probes */
+	bool bAllowStaleReuse = false;
+
+	int32 NumRequested = 0;
+	int32 NumSkipped = 0;
+	int32 NumReused = 0;
+	int32 NumIssued = 0;
+
+	void Begin(float InReuseDistance, float InReuseDegrees, bool bInAllowStaleReuse = false)
+	{
+		bAllowStaleReuse = bInAllowStaleReuse;
+		ReuseDistance = InReuseDistance;
+		ReuseRadians = FMath::DegreesToRadians(InReuseDegrees);
+		NumRequested = NumSkipped = NumReused = NumIssued = 0;
+	}
+
+	bool CanReuse(const FClimbProbeCache& Cache, const FTransform& Transform) const
+	{
+		FTransform CacheSpaceTransform;
+		if (!Cache.bValid || !Cache.ToCacheSpace(Transform, CacheSpaceTransform)) { return false; }
+
+		if (bAllowStaleReuse) { return true; }
+
+		return FVector::DistSquared(Cache.Location, CacheSpaceTransform.GetLocation()) <= FMath::Square(ReuseDistance)
+			&& Cache.Rotation.AngularDistance(CacheSpaceTransform.GetRotation()) <= ReuseRadians;
+	}
+
+	/** Returns true when the probe has to hit the world, otherwise the caller keeps its cached answer */
+	bool ShouldIssue(const FClimbProbeCache& Cache, const FTransform& Transform, bool bCanAffectResult = true)
+	{
+		++NumRequested;
+
+		if (!bCanAffectResult)
+		{
+			++NumSkipped;
+			return false;
+		}
+
+		if (CanReuse(Cache, Transform))
+		{
+			++NumReused;
+			return false;
+		}
+
+		++NumIssued;
+		return true;
+	}
+
+	int32 GetNumSaved() const { return NumSkipped + NumReused; }
+};
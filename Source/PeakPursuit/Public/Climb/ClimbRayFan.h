@@ -0,0 +1,52 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * A batch of up to 32 line probes traced in one call through FClimbCollisionQuery::TraceRayFan.
+ * Results are kept as bit masks plus inline hit points and normals.
+ */
+struct FClimbRayFan
+{
+	static constexpr int32 MaxRays = 32;
+
+	TArray<FVector, TInlineAllocator<8>> Starts;
+	TArray<FVector, TInlineAllocator<8>> Ends;
+	TArray<FVector, TInlineAllocator<8>> HitPoints;
+	TArray<FVector, TInlineAllocator<8>> HitNormals;
+
+	/** Bit i is set once ray i was traced / hit something */
+	uint32 TracedMask = 0;
+	uint32 HitMask = 0;
+
+	void Reset()
+	{
+		Starts.Reset();
+		Ends.Reset();
+		HitPoints.Reset();
+		HitNormals.Reset();
+		TracedMask = 0;
+		HitMask = 0;
+	}
+
+	int32 AddRay(const FVector& Start, const FVector& End)
+	{
+		check(Starts.Num() < MaxRays);
+
+		Ends.Add(End);
+		HitPoints.Add(FVector::ZeroVector);
+		HitNormals.Add(FVector::ZeroVector);
+		return Starts.Add(Start);
+	}
+
+	int32 Num() const { return Starts.Num(); }
+	uint32 GetAllRaysMask() const { return Num() >= MaxRays ? MAX_uint32 : (1u << Num()) - 1u; }
+
+	bool WasTraced(int32 RayIndex) const { return (TracedMask & (1u << RayIndex)) != 0; }
+	bool IsHit(int32 RayIndex) const { return (HitMask & (1u << RayIndex)) != 0; }
+
+	/** True when any traced ray came back without a hit */
+	bool HasMiss() const { return (TracedMask & ~HitMask) != 0; }
+};
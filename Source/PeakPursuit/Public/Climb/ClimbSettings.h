@@ -0,0 +1,129 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "ClimbSettings.generated.h"
+
+/** How much of the climb simulation a climber runs */
+UENUM(BlueprintType)
+enum class EClimbLODTier : uint8
+{
+	/** Every probe, every tick */
+	Full,
+	/** Surface probe every few ticks, no ledge or floor checks, interpolated snap */
+	Reduced,
+	/** Swept moves along the last known surface, a full probe tick every few ticks */
+	Kinematic,
+
+	Num UMETA(Hidden)
+};
+
+/**
+ * Project wide climbing settings, stored in DefaultGame.ini
+ */
+UCLASS(config = Game, defaultconfig, meta = (DisplayName = "Climbing"))
+class PEAKPURSUIT_API UClimbSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(config, EditAnywhere, Category = "LOD")
+	bool bEnableClimbLOD = true;
+
+	/** Visible climbers closer than this run the full simulation */
+	UPROPERTY(config, EditAnywhere, Category = "LOD", meta = (ClampMin = "0"))
+	float FullTierDistance = 2000.0f;
+
+	/** Visible climbers closer than this run the reduced simulation, further ones go kinematic */
+	UPROPERTY(config, EditAnywhere, Category = "LOD", meta = (ClampMin = "0"))
+	float ReducedTierDistance = 8000.0f;
+
+	/** Off-screen climbers closer than this keep the reduced simulation, further ones go kinematic */
+	UPROPERTY(config, EditAnywhere, Category = "LOD", meta = (ClampMin = "0"))
+	float OffscreenReducedTierDistance = 1500.0f;
+
+	/** Seconds without being rendered before a climber counts as off-screen */
+	UPROPERTY(config, EditAnywhere, Category = "LOD", meta = (ClampMin = "0"))
+	float OffscreenTolerance = 0.5f;
+
+	/** Ticks between surface probes in the reduced tier */
+	UPROPERTY(config, EditAnywhere, Category = "LOD", meta = (ClampMin = "1"))
+	int32 ReducedProbeInterval = 4;
+
+	/** Snap interpolation speed in the reduced tier, smooths the steps between sparse probes */
+	UPROPERTY(config, EditAnywhere, Category = "LOD", meta = (ClampMin = "0"))
+	float ReducedSnapInterpSpeed = 10.0f;
+
+	/** Ticks between the probing climb ticks in the kinematic tier, the ones in between only follow the last surface */
+	UPROPERTY(config, EditAnywhere, Category = "LOD", meta = (ClampMin = "1"))
+	int32 KinematicProbeInterval = 15;
+
+	/** Character spawned when a Mass crowd climber gets close to a player */
+	UPROPERTY(config, EditAnywhere, Category = "Crowd", meta = (MetaClass = "/Script/PeakPursuit.PeakPursuitCharacter"))
+	TSoftClassPtr<class APeakPursuitCharacter> CrowdClimberClass;
+
+	/** Crowd climbers closer than this to a player become full characters */
+	UPROPERTY(config, EditAnywhere, Category = "Crowd", meta = (ClampMin = "0"))
+	float CrowdPromoteDistance = 1500.0f;
+
+	/** Promoted climbers further than this from every player go back to Mass, keep it above the promote distance */
+	UPROPERTY(config, EditAnywhere, Category = "Crowd", meta = (ClampMin = "0"))
+	float CrowdDemoteDistance = 2500.0f;
+
+	UPROPERTY(config, EditAnywhere, Category = "Crowd", meta = (ClampMin = "0"))
+	int32 MaxPromotedCrowdClimbers = 8;
+
+	/** Cap the world probes of all climbers per frame through UClimbProbeSubsystem */
+	UPROPERTY(config, EditAnywhere, Category = "Probe Budget")
+	bool bEnableProbeBudget = true;
+
+	/** Surface, floor and ledge probes all climbers may issue per frame, player climbers included */
+	UPROPERTY(config, EditAnywhere, Category = "Probe Budget", meta = (ClampMin = "1"))
+	int32 MaxProbesPerFrame = 48;
+
+	/** Milliseconds of probing climb ticks per frame, 0 to only budget by probe count */
+	UPROPERTY(config, EditAnywhere, Category = "Probe Budget", meta = (ClampMin = "0"))
+	float ProbeBudgetMs = 0.5f;
+
+	/** Ticks a climber may be denied probes in a row before it probes regardless of the budget */
+	UPROPERTY(config, EditAnywhere, Category = "Probe Budget", meta = (ClampMin = "1"))
+	int32 ProbeStalenessFrames = 6;
+
+	/** Cull climb queries against the climbable primitives kept by UClimbablePrimitiveSubsystem before they reach the scene */
+	UPROPERTY(config, EditAnywhere, Category = "Primitive Registry")
+	bool bEnableClimbablePrimitiveRegistry = true;
+
+	/** Queries overlapping more primitives than this go to the scene, fewer are tested one primitive at a time */
+	UPROPERTY(config, EditAnywhere, Category = "Primitive Registry", meta = (ClampMin = "1", ClampMax = "8"))
+	int32 MaxClimbableCandidates = 4;
+
+	/** Margin the registry boxes are grown by, a movable primitive only updates the tree once it moved further */
+	UPROPERTY(config, EditAnywhere, Category = "Primitive Registry", meta = (ClampMin = "0"))
+	float ClimbableBoundsMargin = 50.0f;
+
+	/**
+	 * Climbers query only the ClimbProxy channel and the simplified proxies built by the ClimbProxyBuild commandlet are
+	 * spawned next to their source meshes. Meshes without a proxy are not climbable, so enable once proxies are built.
+	 */
+	UPROPERTY(config, EditAnywhere, Category = "Climb Proxies")
+	bool bUseClimbProxies = false;
+
+	/** Climbing character the ClimbSurfaceFieldBake, ClimbBenchmark, ClimbLedgeExtract, ClimbGraphBuild and ClimbProxyBuild commandlets use unless given -Character=. ClimbReplay uses it for recordings that store no pawn class, and -ClimbSoak runs spawn it unless given -SoakPawn= */
+	UPROPERTY(config, EditAnywhere, Category = "Tools", meta = (MetaClass = "/Script/PeakPursuit.PeakPursuitCharacter"))
+	TSoftClassPtr<class APeakPursuitCharacter> ClimbCharacterClass = TSoftClassPtr<class APeakPursuitCharacter>(FSoftObjectPath(TEXT("/Game/PeakPursuit/Pawns/BP_PeakPursuitCharacter.BP_PeakPursuitCharacter_C")));
+
+	/** Content folder holding the Ledges_<Map> and ClimbGraph_<Map> assets written by the ClimbLedgeExtract and ClimbGraphBuild commandlets */
+	UPROPERTY(config, EditAnywhere, Category = "Ledges", meta = (ContentDir))
+	FString LedgeDataDirectory = TEXT("/Game/ClimbData");
+
+	/**
+	 * Register the climb graph routes of the level as custom nav links. The level's RecastNavMesh needs its Runtime Generation
+	 * set to Dynamic Modifiers Only or Dynamic, levels with a static nav mesh skip the links with a warning.
+	 */
+	UPROPERTY(config, EditAnywhere, Category = "Navigation")
+	bool bRegisterClimbNavLinks = true;
+
+	EClimbLODTier GetTier(float Distance, bool bVisible, bool bPlayerControlled) const;
+};
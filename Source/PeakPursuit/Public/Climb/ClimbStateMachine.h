@@ -0,0 +1,138 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StaticArray.h"
+#include "Climb/ClimbQueryPlan.h"
+
+/** Where a character is in the climb flow, on top of its movement mode */
+enum class EClimbState : uint8
+{
+	Idle,
+	/** Idle to climb or climb down ledge montage, the character is not attached yet */
+	EnteringClimb,
+	Climbing,
+	Hopping,
+	/** Climb to top montage */
+	Mantling,
+	Vaulting,
+	/** Let go of the surface, waiting to land */
+	ExitingClimb,
+
+	Num
+};
+
+enum class EClimbEvent : uint8
+{
+	EnterStarted,
+	VaultStarted,
+	HopStarted,
+	LedgeReached,
+	/** Movement mode changed to or from climbing */
+	ClimbStarted,
+	ClimbStopped,
+	Landed,
+	/** A climb action montage blended out */
+	ActionFinished,
+
+	Num
+};
+
+struct FClimbTransition
+{
+	EClimbState From;
+	EClimbEvent Event;
+	EClimbState To;
+};
+
+namespace ClimbStateMachine
+{
+	/** Every legal transition, events without an entry for the current state are ignored */
+	inline constexpr FClimbTransition Transitions[] =
+	{
+		{ EClimbState::Idle,          EClimbEvent::EnterStarted,   EClimbState::EnteringClimb },
+		{ EClimbState::Idle,          EClimbEvent::ClimbStarted,   EClimbState::Climbing },
+		{ EClimbState::Idle,          EClimbEvent::VaultStarted,   EClimbState::Vaulting },
+		{ EClimbState::EnteringClimb, EClimbEvent::ClimbStarted,   EClimbState::Climbing },
+		{ EClimbState::EnteringClimb, EClimbEvent::ActionFinished, EClimbState::Idle },
+		{ EClimbState::Climbing,      EClimbEvent::HopStarted,     EClimbState::Hopping },
+		{ EClimbState::Climbing,      EClimbEvent::LedgeReached,   EClimbState::Mantling },
+		{ EClimbState::Climbing,      EClimbEvent::VaultStarted,   EClimbState::Vaulting },
+		{ EClimbState::Climbing,      EClimbEvent::ClimbStopped,   EClimbState::ExitingClimb },
+		{ EClimbState::Hopping,       EClimbEvent::ActionFinished, EClimbState::Climbing },
+		{ EClimbState::Hopping,       EClimbEvent::ClimbStopped,   EClimbState::ExitingClimb },
+		{ EClimbState::Mantling,      EClimbEvent::ClimbStopped,   EClimbState::ExitingClimb },
+		{ EClimbState::Vaulting,      EClimbEvent::ClimbStopped,   EClimbState::ExitingClimb },
+		{ EClimbState::ExitingClimb,  EClimbEvent::Landed,         EClimbState::Idle },
+		{ EClimbState::ExitingClimb,  EClimbEvent::ClimbStarted,   EClimbState::Climbing },
+	};
+
+	constexpr uint8 ProbeBit(EClimbProbe Probe) { return 1 << (uint8)Probe; }
+
+	/**
+	 * Optional probes PhysClimb runs in each state. The surface probe is not listed, every climb tick needs it for
+	 * the snap and the stop check; floor only matters while climbing or hopping down, ledges only while climbing.
+	 */
+	inline constexpr uint8 StateProbes[(int32)EClimbState::Num] =
+	{
+		0,
+		0,
+		ProbeBit(EClimbProbe::Floor) | ProbeBit(EClimbProbe::Ledge),
+		ProbeBit(EClimbProbe::Floor),
+		0,
+		0,
+		0,
+	};
+
+	/** Destination of Event in From, Num when the event does not apply */
+	constexpr EClimbState FindTransition(EClimbState From, EClimbEvent Event)
+	{
+		for (const FClimbTransition& Transition : Transitions)
+		{
+			if (Transition.From == From && Transition.Event == Event) { return Transition.To; }
+		}
+		return EClimbState::Num;
+	}
+
+	constexpr bool NeedsProbe(EClimbState State, EClimbProbe Probe)
+	{
+		return (StateProbes[(int32)State] & ProbeBit(Probe)) != 0;
+	}
+
+	static_assert(FindTransition(EClimbState::Climbing, EClimbEvent::LedgeReached) == EClimbState::Mantling);
+	static_assert(FindTransition(EClimbState::Idle, EClimbEvent::HopStarted) == EClimbState::Num);
+	static_assert(!NeedsProbe(EClimbState::Mantling, EClimbProbe::Ledge));
+
+	PEAKPURSUIT_API const TCHAR* GetStateName(EClimbState State);
+	PEAKPURSUIT_API const TCHAR* GetEventName(EClimbEvent Event);
+}
+
+/** A transition taken, with the world time it happened at */
+struct FClimbStateTransitionRecord
+{
+	EClimbState From = EClimbState::Idle;
+	EClimbState To = EClimbState::Idle;
+	EClimbEvent Event = EClimbEvent::Num;
+	double Time = 0.0;
+};
+
+/** Current climb state and the last few transitions for diagnostics */
+struct PEAKPURSUIT_API FClimbStateMachine
+{
+	static constexpr int32 HistorySize = 16;
+
+	EClimbState GetState() const { return State; }
+	bool NeedsProbe(EClimbProbe Probe) const { return ClimbStateMachine::NeedsProbe(State, Probe); }
+
+	/** Takes the transition Event leads to from the current state, returns false when there is none */
+	bool Dispatch(EClimbEvent Event, double Time);
+
+	/** Oldest first */
+	void GetHistory(TArray<FClimbStateTransitionRecord>& OutHistory) const;
+
+private:
+	EClimbState State = EClimbState::Idle;
+	TStaticArray<FClimbStateTransitionRecord, HistorySize> History;
+	int32 NumRecorded = 0;
+};
@@ -0,0 +1,78 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+DECLARE_STATS_GROUP(TEXT("Climb"), STATGROUP_Climb, STATCAT_Advanced);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(PEAKPURSUIT_API, Climb);
+
+//Per frame counters, also written to the Climb CSV category
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climbers Full"), STAT_ClimbersFull, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climbers Reduced"), STAT_ClimbersReduced, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climbers Kinematic"), STAT_ClimbersKinematic, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climbers Mass"), STAT_ClimbersMass, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climbers Promoted"), STAT_ClimbersPromoted, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Traces"), STAT_ClimbTraces, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Trace Hits"), STAT_ClimbTraceHits, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Probes Issued"), STAT_ClimbProbesIssued, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Probes Saved"), STAT_ClimbProbesSaved, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Move Sweeps"), STAT_ClimbMoveSweeps, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Probe Budget"), STAT_ClimbProbeBudget, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Probe Budget Used"), STAT_ClimbProbeBudgetUsed, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Probes Deferred"), STAT_ClimbProbesDeferred, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Probes Forced"), STAT_ClimbProbesForced, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Climb Probes Culled"), STAT_ClimbProbesCulled, STATGROUP_Climb, PEAKPURSUIT_API);
+
+//Movement
+DECLARE_CYCLE_STAT_EXTERN(TEXT("PhysClimb"), STAT_Climb_PhysClimb, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("PhysClimbKinematic"), STAT_Climb_PhysClimbKinematic, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("MoveAlongClimbableSurface"), STAT_Climb_MoveAlongClimbableSurface, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Mass Climb Processor"), STAT_Climb_MassProcessor, STATGROUP_Climb, PEAKPURSUIT_API);
+
+//Probes
+DECLARE_CYCLE_STAT_EXTERN(TEXT("GetClimbableSurfaces"), STAT_Climb_GetClimbableSurfaces, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("RequestAsyncClimbableSurfaces"), STAT_Climb_RequestAsyncClimbableSurfaces, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("ConsumeAsyncClimbableSurfaces"), STAT_Climb_ConsumeAsyncClimbableSurfaces, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("SampleClimbableSurfaceField"), STAT_Climb_SampleClimbableSurfaceField, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("TraceFromEyeHeight"), STAT_Climb_TraceFromEyeHeight, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("TraceFromLedgeHeight"), STAT_Climb_TraceFromLedgeHeight, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CanStartClimbing"), STAT_Climb_CanStartClimbing, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CanClimbDownLedge"), STAT_Climb_CanClimbDownLedge, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CanStartVaulting"), STAT_Climb_CanStartVaulting, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CanHopUp"), STAT_Climb_CanHopUp, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CanHopDown"), STAT_Climb_CanHopDown, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("HasReachFloor"), STAT_Climb_HasReachFloor, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("HasReachLedge"), STAT_Climb_HasReachLedge, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("FindClimbLedge"), STAT_Climb_FindClimbLedge, STATGROUP_Climb, PEAKPURSUIT_API);
+
+//Navigation
+DECLARE_CYCLE_STAT_EXTERN(TEXT("FindClimbPath"), STAT_Climb_FindClimbPath, STATGROUP_Climb, PEAKPURSUIT_API);
+
+//Montages
+DECLARE_CYCLE_STAT_EXTERN(TEXT("PlayClimbMontage"), STAT_Climb_PlayClimbMontage, STATGROUP_Climb, PEAKPURSUIT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("OnClimbMontageBlendingOut"), STAT_Climb_OnClimbMontageBlendingOut, STATGROUP_Climb, PEAKPURSUIT_API);
+
+#if !UE_BUILD_SHIPPING
+/** Cycle stat and named Insights scope, CLIMB_SCOPE(PhysClimb) counts into STAT_Climb_PhysClimb */
+#define CLIMB_SCOPE(Name) \
+	SCOPE_CYCLE_COUNTER(STAT_Climb_##Name); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("Climb::" #Name)
+
+/** Adds to the STAT_<Name> counter and the Climb CSV stat of the same name */
+#define CLIMB_COUNTER_ADD(Name, Value) \
+	INC_DWORD_STAT_BY(STAT_##Name, Value); \
+	CSV_CUSTOM_STAT(Climb, Name, (int32)(Value), ECsvCustomStatOp::Accumulate)
+
+#define CLIMB_COUNTER_SET(Name, Value) \
+	SET_DWORD_STAT(STAT_##Name, Value); \
+	CSV_CUSTOM_STAT(Climb, Name, (int32)(Value), ECsvCustomStatOp::Set)
+#else
+#define CLIMB_SCOPE(Name)
+#define CLIMB_COUNTER_ADD(Name, Value)
+#define CLIMB_COUNTER_SET(Name, Value)
+#endif
@@ -0,0 +1,26 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ClimbBenchmarkCommandlet.generated.h"
+
+/**
+ * Headless microbenchmark of the climb movement queries. Builds a transient level with a climbable wall, a ledge and a
+ * vault box, drives the character through scripted scenarios and writes per function timings (mean, p50, p99),
+ * physics queries and allocations per call as JSON. With -Baseline the results are compared against a previous run
+ * and the commandlet fails when a mean regresses by more than -Tolerance percent. The scenarios live in
+ * FClimbBenchmarkWorld and also run as the PeakPursuit.Climb.Benchmark automation tests.
+ * UnrealEditor-Cmd PeakPursuit.uproject -run=ClimbBenchmark -nullrhi [-Iterations=2000] [-Output=Saved/Benchmarks/Climb.json] [-Baseline=...] [-Tolerance=10] [-Character=...]
+ */
+UCLASS()
+class PEAKPURSUIT_API UClimbBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UClimbBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,25 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ClimbGraphBuildCommandlet.generated.h"
+
+/**
+ * Builds the climb graph of a level into a UClimbGraphData. Samples the climbable walls of the level's static meshes,
+ * places the character at every sample and keeps the climb start, hop, mantle, drop, climb down and vault links its own
+ * checks accept, so the graph uses the component's thresholds. Ground to ground routes over the graph are baked for the
+ * custom nav links registered by UClimbGraphSubsystem.
+ * UnrealEditor-Cmd PeakPursuit.uproject -run=ClimbGraphBuild -nullrhi [-Map=/Game/ThirdPerson/Maps/ThirdPersonMap] [-Character=...] [-Spacing=100] [-CellSize=200] [-RouteCellSize=300]
+ */
+UCLASS()
+class PEAKPURSUIT_API UClimbGraphBuildCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UClimbGraphBuildCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
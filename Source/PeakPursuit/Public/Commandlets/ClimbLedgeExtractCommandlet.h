@@ -0,0 +1,22 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ClimbLedgeExtractCommandlet.generated.h"
+
+/**
+ * Extracts the ledges of the climbable static meshes placed in a level into a UClimbLedgeData asset.
+ * UnrealEditor-Cmd PeakPursuit.uproject -run=ClimbLedgeExtract [-Map=/Game/ThirdPerson/Maps/ThirdPersonMap] [-CellSize=200] [-MinLength=20]
+ */
+UCLASS()
+class PEAKPURSUIT_API UClimbLedgeExtractCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UClimbLedgeExtractCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,25 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ClimbProxyBuildCommandlet.generated.h"
+
+/**
+ * Builds a simplified, smoothed climb proxy for every climbable static mesh under a content path and links it to the
+ * mesh through a UClimbProxyData. Foliage sections are left out, the rest is reduced and relaxed, then the deviation
+ * from the source surface is measured and written to Saved/ClimbProxies/Report.csv.
+ * UnrealEditor-Cmd PeakPursuit.uproject -run=ClimbProxyBuild [-Path=/Game/ModularLostRuinKit] [-Filter=SM_Wall_Rock_Set_,SM_Plate_Rock_,SM_Relic_Rock_]
+ *     [-ExcludeSlots=Foliage,Leaf,Grass,Ivy,Vine] [-PercentTriangles=0.1] [-MaxTriangles=512] [-SmoothIterations=1] [-SampleSpacing=10] [-OutPath=/Game/ClimbData/Proxies]
+ */
+UCLASS()
+class PEAKPURSUIT_API UClimbProxyBuildCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UClimbProxyBuildCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
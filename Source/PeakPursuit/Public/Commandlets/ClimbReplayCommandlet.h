@@ -0,0 +1,24 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ClimbReplayCommandlet.generated.h"
+
+/**
+ * Replays a climb.RecordInput recording headlessly in its map with the recorded pawn class, one world tick per
+ * recorded frame with the recorded delta time. Writes a per frame CSV of tick time, climb queries and drift from the recorded location, and fails when
+ * the final transform diverges by more than -Tolerance.
+ * UnrealEditor-Cmd PeakPursuit.uproject -run=ClimbReplay -nullrhi -Recording=Saved/ClimbRecordings/X.climbinput [-Map=/Game/ThirdPerson/Maps/ThirdPersonMap] [-Output=...] [-Tolerance=1] [-Character=...]
+ */
+UCLASS()
+class PEAKPURSUIT_API UClimbReplayCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UClimbReplayCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,22 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ClimbSurfaceFieldBakeCommandlet.generated.h"
+
+/**
+ * Bakes a UClimbSurfaceField onto every climbable static mesh under a content path.
+ * UnrealEditor-Cmd PeakPursuit.uproject -run=ClimbSurfaceFieldBake [-Path=/Game/ModularLostRuinKit] [-Filter=SM_Wall_Rock_Set_,SM_Relic_Rock_] [-VoxelSize=10] [-MaxDistance=100]
+ */
+UCLASS()
+class PEAKPURSUIT_API UClimbSurfaceFieldBakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UClimbSurfaceFieldBakeCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
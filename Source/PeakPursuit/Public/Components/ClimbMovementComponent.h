@@ -4,10 +4,19 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "Climb/ClimbQueryPlan.h"
+#include "Climb/ClimbCollisionQuery.h"
+#include "Climb/ClimbSettings.h"
+#include "Climb/ClimbStateMachine.h"
+#include "Animation/ClimbAnimSnapshot.h"
+#include "Data/ClimbActionTable.h"
 #include "ClimbMovementComponent.generated.h"
 
 DECLARE_DELEGATE(FOnEnterClimbState)
 DECLARE_DELEGATE(FOnExitClimbState)
+DECLARE_DELEGATE(FOnClimbMontageChanged)
+
+struct FStreamableHandle;
 
 UENUM(BlueprintType)
 namespace ECustomMovementMode {
@@ -24,12 +33,28 @@ class PEAKPURSUIT_API UClimbMovementComponent : public UCharacterMovementCompone
 {
 	GENERATED_BODY()
 
+	friend class FSavedMove_Climb;
+	friend class FClimbBenchmarkWorld;
+	friend class UClimbGraphBuildCommandlet;
+
 public:
 	FOnEnterClimbState OnEnterClimbState;
 	FOnExitClimbState OnExitClimbState;
+	/** A climb montage started or ended */
+	FOnClimbMontageChanged OnClimbMontageChanged;
+
+	//Network prediction
+	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+	virtual float GetClientNetSendDeltaTime(const APlayerController* PC, const FNetworkPredictionData_Client_Character* ClientData, const FSavedMovePtr& NewMove) const override;
+	virtual void OnClientCorrectionReceived(class FNetworkPredictionData_Client_Character& ClientData, float TimeStamp, FVector NewLocation, FVector NewVelocity, UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase, bool bBaseRelativePosition, uint8 ServerMovementMode) override;
 
 protected:
+	virtual void UpdateCharacterStateBeforeMovement(float DeltaSeconds) override;
+	virtual void ServerMovePacked_ClientSend(const FCharacterServerMovePackedBits& PackedBits) override;
+
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 	/** Called after MovementMode has changed. Base implementation does special handling for starting certain modes, then notifies the CharacterOwner. */
 	virtual void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode) override;
@@ -86,65 +111,215 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing")
 	float ClimbDownWalkableSurfaceTraceDistance = 200.0f;
 
+	/** Issue the climb surface sweep asynchronously at the end of the frame and consume it on the next one. Disable to use the blocking sweep */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Climbing")
+	bool bUseAsyncClimbSweep = false;
+
+	/** Surface, floor and ledge probes are reused while the capsule moved less than this since they were taken */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Climbing")
+	float ClimbProbeReuseDistance = 0.1f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Climbing")
+	float ClimbProbeReuseDegrees = 0.1f;
+
+	/** Sample the baked UClimbSurfaceField of the surface being climbed instead of sweeping, when its mesh has one */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Climbing")
+	bool bUseClimbSurfaceFields = false;
+
+	/** Longest climb sub-step, capped by MaxSimulationTimeStep. Snap and rotation interpolation are tuned for 60 Hz steps */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing", meta = (ClampMin = "0.0166", ClampMax = "0.50", UIMin = "0.0166", UIMax = "0.50"))
+	float MaxClimbSimulationTimeStep = 1.0f / 60.0f;
+
+	/** Most climb sub-steps per update, capped by MaxSimulationIterations. The last one takes whatever time is left */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing", meta = (ClampMin = "1", ClampMax = "25", UIMin = "1", UIMax = "25"))
+	int32 MaxClimbSimulationIterations = 4;
+
+	/** Sub-steps after the first reuse its surface probe while the capsule stays this close to where it was taken */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing", meta = (ClampMin = "0"))
+	float ClimbSubstepProbeReuseDistance = 10.0f;
+
+	/** Find ledges in the level's extracted UClimbLedgeData instead of tracing, when the level has one */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Climbing")
+	bool bUseClimbLedgeData = false;
+
+	/** Minimum time between ServerMove RPCs while climbing without root motion, climb moves are slow and combine well */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Climbing")
+	float ClimbNetSendDeltaTime = 1.0f / 30.0f;
+
 
 	UPROPERTY()
 	class UAnimInstance* OwningPlayerAnimInstance;
 	
+	/** Montages of the climb actions, the UClimbActionTable class defaults when unset */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Animations")
-	class UAnimMontage* IdleToClimbMontage;
+	class UClimbActionTable* ClimbActionTable;
 
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Animations")
-	class UAnimMontage* ClimbToTopMontage;
+	/** Climbable surfaces closer than this stream the action montages in */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Animations", meta = (ClampMin = "0"))
+	float ClimbActionPreloadRadius = 300.0f;
 
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Animations")
-	class UAnimMontage* ClimbDownLedgeMontage;
+	/** Seconds between the checks for climbable surfaces nearby while not climbing */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Animations", meta = (ClampMin = "0"))
+	float ClimbActionPreloadInterval = 0.5f;
 
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Animations")
-	class UAnimMontage* VaultMontage;
+	/** Seconds away from every climbable surface before the action montages are released */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Animations", meta = (ClampMin = "0"))
+	float ClimbActionReleaseDelay = 15.0f;
 
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Animations")
-	class UAnimMontage* HopUpMontage;
 
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Character Movement: Animations")
-	class UAnimMontage* HopDownMontage;
+	/** Cosine of DegreesSurfaceClimbingThreshold, set in BeginPlay */
+	float StopClimbingMinDot = 0.5f;
 
+	/** Native queries against ClimbableSurfaceTypes, rebuilt when the types change */
+	FClimbCollisionQuery ClimbQuery;
 
-	TArray<FHitResult> ClimbTraceResults;
+	FClimbHitResults ClimbTraceResults;
 	FVector CurrentClimbableSurfaceLocation;
 	FVector CurrentClimbableSurfaceNormal;
 	FHitResult EyesTraceResult;
 	FHitResult LedgeTraceResult;
 
+	/** Async surface sweep issued last frame, and the predicted location it was issued from */
+	FTraceHandle PendingClimbSweepHandle;
+	FVector PendingClimbSweepLocation;
+
+	FClimbQueryPlan ClimbQueryPlan;
+	FClimbProbeCache SurfaceProbeCache;
+	FClimbProbeCache FloorProbeCache;
+	FClimbProbeCache LedgeProbeCache;
+
+	/** Surface contacts relative to the movable component they lie on, the surface and ledge caches are kept relative to it too */
+	FClimbBaseContacts ClimbBaseContacts;
+
+	/** Requests captured from input, sent as compressed flags and consumed by the next movement update */
+	uint8 bWantsToToggleClimb : 1;
+	uint8 bWantsToHop : 1;
+
+	/** Corrections and ServerMove traffic while climbing, logged every climb.NetStatsInterval seconds */
+	struct FClimbNetStats
+	{
+		float ClimbTime = 0.0f;
+		float ElapsedTime = 0.0f;
+		int32 Corrections = 0;
+		int32 ServerMoves = 0;
+		int64 ServerMoveBits = 0;
+	};
+	FClimbNetStats ClimbNetStats;
+
+	/** Assigned by UClimbLODSubsystem from the significance manager */
+	UPROPERTY(VisibleInstanceOnly, Transient, Category = "Character Movement: Climbing")
+	EClimbLODTier ClimbLODTier = EClimbLODTier::Full;
+
+	int32 TicksSinceSurfaceProbe = 0;
+
+	/** Probe budget shared by every climber of the world, see UClimbProbeSubsystem */
+	UPROPERTY(Transient)
+	class UClimbProbeSubsystem* ClimbProbeSubsystem;
+
+	/** Capsule sweeps of climb moves since the benchmark last reset it */
+	int32 NumClimbMoveSweeps = 0;
+
+	/** Actions whose montage was missing or did not play, counted over the component's lifetime for soak runs */
+	int32 NumClimbActionFailures = 0;
+
+	/** Climb ticks in a row denied a probe slot, they reuse their caches meanwhile */
+	int32 ProbeFramesDeferred = 0;
+
+	/** Rebuilt at the end of every tick, see GetAnimSnapshot */
+	FClimbAnimSnapshot AnimSnapshot;
+
+	UPROPERTY(Transient)
+	class UClimbLedgeSubsystem* ClimbLedgeSubsystem;
+
+	/** Keeps the action montages loaded, see UpdateClimbActionMontages */
+	TSharedPtr<FStreamableHandle> ClimbActionMontagesHandle;
+	float ClimbActionPreloadCountdown = 0.0f;
+	float TimeAwayFromClimbableSurfaces = 0.0f;
+
+	FClimbStateMachine ClimbStateMachine;
+
+#if WITH_CLIMB_PROBE_RECORDER
+	/** Queries of ClimbQuery and the async surface sweep, read by the Climb gameplay debugger category */
+	FClimbProbeRecorder ProbeRecorder;
+#endif
+
+	/** Last montage started by PlayClimbMontage */
+	UPROPERTY(Transient)
+	class UAnimMontage* ActiveClimbMontage;
+
 	//Debug
+	/** Draws every probe as it is traced, which skews timings. The Climb gameplay debugger category draws recorded probes instead */
 	UPROPERTY(EditAnywhere, Category = "Character Movement: Debug")
 	bool bShowDebugShape = false;
 
 	UPROPERTY(EditAnywhere, Category = "Character Movement: Debug")
 	float ShowDebugDuration = 0.1f;
+
+	/** Also run the sweep when a surface field was sampled and log when both disagree by more than the tolerance */
+	UPROPERTY(EditAnywhere, Category = "Character Movement: Debug")
+	bool bValidateClimbSurfaceFields = false;
+
+	UPROPERTY(EditAnywhere, Category = "Character Movement: Debug")
+	float ClimbSurfaceFieldTolerance = 5.0f;
+
+	/** Also run the ledge traces when the ledge data was queried, log when both disagree and keep the trace result */
+	UPROPERTY(EditAnywhere, Category = "Character Movement: Debug")
+	bool bValidateClimbLedgeData = false;
 #pragma endregion
 
 #pragma region Methods
 private:
-	TArray<FHitResult> GetClimbCapsuleTraces(const FVector& Start, const FVector& End);
-	FHitResult GetClimbLineTraces(const FVector& Start, const FVector& End);
+	bool GetClimbCapsuleTraces(const FVector& Start, const FVector& End, FClimbHitResults& OutHitResults);
+	bool GetClimbLineTraces(const FVector& Start, const FVector& End, FHitResult& OutHitResult);
+	void DrawDebugClimbCapsuleTrace(const FVector& Start, const FVector& End, TConstArrayView<FHitResult> HitResults) const;
+	void DrawDebugClimbLineTrace(const FHitResult& HitResult) const;
 	bool GetClimbableSurfaces();
+	void RequestAsyncClimbableSurfaces(float DeltaTime);
+	bool ConsumeAsyncClimbableSurfaces();
+	bool SampleClimbableSurfaceField();
+	void ValidateClimbableSurfaceField();
 	bool TraceFromEyeHeight();
-	FHitResult TraceFromHeight(float TraceDistance, float StartOffset);
+	void AddRayFromHeight(FClimbRayFan& Fan, float TraceDistance, float StartOffset) const;
+	void TraceClimbRayFan(FClimbRayFan& Fan, uint32 RayMask, TFunctionRef<bool(const FClimbRayFan&)> IsDecided);
+	void TraceClimbRayFan(FClimbRayFan& Fan);
+	void DrawDebugClimbRayFan(const FClimbRayFan& Fan) const;
 	void TraceFromLedgeHeight(FHitResult& OutHitResult);
+	bool TraceLedgeAbove();
+	bool TraceLedgeBelow();
+	bool FindClimbLedge(float MinForward, float MaxForward, float MinHeight, float MaxHeight, float FacingSign) const;
+	bool ResolveClimbLedge(const TCHAR* CheckName, TFunctionRef<bool()> FindLedge, TFunctionRef<bool()> TraceLedge);
 	bool CanStartClimbing();
 	void StartClimbing();
 	void StopClimbing();
 	bool CanClimbDownLedge();
 	void PhysClimb(float deltaTime, int32 Iterations);
+	void PhysClimbKinematic(float deltaTime);
+	void FollowClimbBase();
+	float GetClimbSimulationTimeStep(float RemainingTime, int32 Iterations) const;
+	int32 GetMaxClimbSimulationIterations() const { return FMath::Min(MaxClimbSimulationIterations, MaxSimulationIterations); }
 	void ProcessClimbableSurfaceInfo();
+	void InvalidateClimbProbeCaches();
+	/** Points ClimbQuery at ClimbableSurfaceTypes, or at the ClimbProxy channel when climb proxies are used */
+	void UpdateClimbQueryTypes();
 	bool ShouldStopClimbing();
 	bool HasReachFloor();
 	bool HasReachLedge();
 	void TryStartVaulting();
 	bool CanStartVaulting(FVector& OutVaultStartPosition, FVector& OutVaultLandPosition);
 	FQuat GetClimbRotation(float DeltaTime);
-	void SnapMovementToClimbableSurfaces(float DeltaTime);
-	void PlayClimbMontage(class UAnimMontage* MontageToPlay);
+	void MoveAlongClimbableSurface(float DeltaTime);
+	FVector GetClimbSnapDelta(const FVector& Location, const FVector& Forward, float DeltaTime) const;
+	bool PlayClimbMontage(class UAnimMontage* MontageToPlay);
+	/** Sets the action's warp targets from WarpTargetLocations, in the table's order, and plays its montage */
+	bool PlayClimbAction(EClimbAction Action, TConstArrayView<FVector> WarpTargetLocations = {});
+	void DispatchClimbEvent(EClimbEvent Event);
+	/** The action's montage when it is resident, otherwise starts streaming it in and returns null */
+	class UAnimMontage* GetClimbActionMontage(const FClimbAction& Action);
+	/** True when the action is in the table and its montage can play right away */
+	bool IsClimbActionReady(EClimbAction Action);
+	void UpdateClimbActionMontages(float DeltaTime);
+	void RequestClimbActionMontages();
+	void ReleaseClimbActionMontages();
 	void SetMotionWarpTarget(const FName& InWarpTargetName, const FVector& InTargetPosition);
 	void HandleHopUp();
 	bool CanHopUp(FVector& OutHopUpTargetPos);
@@ -152,19 +327,93 @@ private:
 	bool CanHopDown(FVector& OutHopDownTargetPos);
 
 
+	/** Applies the ended action's result, once per montage whether it finished or was interrupted */
+	UFUNCTION()
+	void OnClimbMontageBlendingOut(UAnimMontage* Montage, bool bInterrupted);
+
 	UFUNCTION()
 	void OnClimbMontageEnded(UAnimMontage* Montage, bool bInterrupted);
 
 
 public:
 	FORCEINLINE FVector GetClimbableSurfaceNormal() const { return CurrentClimbableSurfaceNormal; }
+	/** Game thread only, anim instances copy it in NativeUpdateAnimation and work from the copy */
+	FORCEINLINE const FClimbAnimSnapshot& GetAnimSnapshot() const { return AnimSnapshot; }
+	FORCEINLINE FVector GetClimbableSurfaceLocation() const { return CurrentClimbableSurfaceLocation; }
+	/** Probes requested, skipped and reused during the last climb tick */
+	FORCEINLINE const FClimbQueryPlan& GetClimbQueryPlan() const { return ClimbQueryPlan; }
+	FORCEINLINE const TArray<TEnumAsByte<EObjectTypeQuery>>& GetClimbableSurfaceTypes() const { return ClimbableSurfaceTypes; }
+	void SetClimbableSurfaceTypes(const TArray<TEnumAsByte<EObjectTypeQuery>>& InClimbableSurfaceTypes);
+	FORCEINLINE const FClimbCollisionQuery& GetClimbQuery() const { return ClimbQuery; }
+	FORCEINLINE EClimbLODTier GetClimbLODTier() const { return ClimbLODTier; }
+	const UClimbActionTable* GetClimbActionTable() const;
+	FORCEINLINE const FClimbStateMachine& GetClimbStateMachine() const { return ClimbStateMachine; }
+#if WITH_CLIMB_PROBE_RECORDER
+	FORCEINLINE FClimbProbeRecorder& GetProbeRecorder() { return ProbeRecorder; }
+#endif
+	FORCEINLINE int32 GetNumClimbActionFailures() const { return NumClimbActionFailures; }
+	bool AreClimbActionMontagesLoaded() const;
+	void SetClimbLODTier(EClimbLODTier InClimbLODTier);
+
+	/** Vault lines, the first one finds the vault start and VaultLandRayIndex the landing spot */
+	static constexpr int32 VaultRayCount = 5;
+	static constexpr int32 VaultLandRayIndex = VaultRayCount - 2;
+	static constexpr uint32 GetVaultRayMask() { return (1u << 0) | (1u << VaultLandRayIndex); }
+
+	/** Probe fans used by the vault, hop and climb down checks, built from the current capsule transform */
+	void BuildVaultRayFan(FClimbRayFan& OutFan) const;
+	void BuildHopUpRayFan(FClimbRayFan& OutFan) const;
+	void BuildHopDownRayFan(FClimbRayFan& OutFan) const;
+	void BuildClimbDownLedgeRayFan(FClimbRayFan& OutFan) const;
 	FVector GetUnrotatedClimbVelocity() const;
 
 	bool IsClimbing() const;
+	/** True from PlayClimbMontage until that montage has fully blended out */
+	bool IsPlayingClimbMontage() const;
+	/** Requests are predicted: they are queued here and run inside the next movement update on client and server */
 	void ToggleClimbing();
 	void RequestHoping();
+	/** Enters climbing directly on a known surface, skipping the start checks and montage. Used when promoting crowd climbers */
+	void StartClimbingOnSurface(const FVector& SurfaceLocation, const FVector& SurfaceNormal);
+
+private:
+	void ProcessClimbToggle();
+	void ProcessHopRequest();
+	/** True while the owning client replays saved moves after a correction */
+	FORCEINLINE bool IsReplayingMove() const { return CharacterOwner && CharacterOwner->bClientUpdating; }
+	void UpdateClimbNetStats(float DeltaTime);
+	void PublishAnimSnapshot();
 #pragma endregion
 
 
 	
 };
+
+/** Saved move carrying the climb requests and the surface the move started on */
+class PEAKPURSUIT_API FSavedMove_Climb : public FSavedMove_Character
+{
+public:
+	typedef FSavedMove_Character Super;
+
+	uint8 bSavedWantsToToggleClimb : 1;
+	uint8 bSavedWantsToHop : 1;
+
+	FVector SavedClimbableSurfaceLocation;
+	FVector SavedClimbableSurfaceNormal;
+
+	virtual void Clear() override;
+	virtual uint8 GetCompressedFlags() const override;
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+	virtual void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, class FNetworkPredictionData_Client_Character& ClientData) override;
+	virtual void PrepMoveFor(ACharacter* C) override;
+};
+
+class PEAKPURSUIT_API FNetworkPredictionData_Client_Climb : public FNetworkPredictionData_Client_Character
+{
+public:
+	typedef FNetworkPredictionData_Client_Character Super;
+
+	FNetworkPredictionData_Client_Climb(const UCharacterMovementComponent& ClientMovement);
+
+	virtual FSavedMovePtr AllocateNewMove() override;
+};
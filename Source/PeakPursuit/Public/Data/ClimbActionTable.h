@@ -0,0 +1,78 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ClimbActionTable.generated.h"
+
+class UAnimMontage;
+
+/** Montage driven moves of the climb movement component */
+UENUM(BlueprintType)
+enum class EClimbAction : uint8
+{
+	IdleToClimb,
+	ClimbToTop,
+	ClimbDownLedge,
+	Vault,
+	HopUp,
+	HopDown,
+
+	Num UMETA(Hidden)
+};
+
+/** Movement mode a climb action leaves the character in once its montage ends */
+UENUM(BlueprintType)
+enum class EClimbActionResult : uint8
+{
+	/** Keep whatever mode the character is in */
+	Unchanged,
+	/** Attach to the surface and stop */
+	Climbing,
+	Walking
+};
+
+USTRUCT(BlueprintType)
+struct PEAKPURSUIT_API FClimbAction
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Climb Action")
+	TSoftObjectPtr<UAnimMontage> Montage;
+
+	/** Motion warping targets of the montage, in the order the action supplies their locations */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Climb Action")
+	TArray<FName> WarpTargetNames;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Climb Action")
+	EClimbActionResult Result = EClimbActionResult::Unchanged;
+};
+
+/**
+ * Montages, warp targets and resulting movement modes of the climb actions.
+ * Montages are soft references, the climb movement component streams them in near climbable surfaces
+ * and releases them after a while away from any. The class defaults hold the project's stock montages
+ * and are used when a character has no table assigned.
+ * BP_PeakPursuitCharacter still imports the montages its removed hard montage properties pointed at, so they keep
+ * loading with the character until it is resaved, e.g. with
+ * UnrealEditor-Cmd PeakPursuit.uproject -run=ResavePackages -Package=/Game/PeakPursuit/Pawns/BP_PeakPursuitCharacter
+ */
+UCLASS(BlueprintType)
+class PEAKPURSUIT_API UClimbActionTable : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UClimbActionTable();
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climb Actions")
+	TMap<EClimbAction, FClimbAction> Actions;
+
+	const FClimbAction* FindAction(EClimbAction Action) const { return Actions.Find(Action); }
+
+	/** Action whose montage is Montage, Num when none */
+	EClimbAction FindActionByMontage(const UAnimMontage* Montage) const;
+
+	void GetMontagePaths(TArray<FSoftObjectPath>& OutPaths) const;
+};
@@ -0,0 +1,139 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ClimbGraphData.generated.h"
+
+UENUM(BlueprintType)
+enum class EClimbGraphNodeType : uint8
+{
+	/** Standing on a walkable floor, where the nav mesh takes over */
+	Ground,
+	/** Hanging on a climbable wall */
+	Wall
+};
+
+/** The action that takes a climber along a link, each one is a check the climb movement component runs at its start */
+UENUM(BlueprintType)
+enum class EClimbGraphLinkType : uint8
+{
+	/** Climb input along the wall between neighbouring wall nodes */
+	Climb,
+	/** CanStartClimbing from a ground node facing the wall */
+	ClimbStart,
+	/** Climbing down until HasReachFloor lets go */
+	Drop,
+	/** CanHopUp */
+	HopUp,
+	/** CanHopDown */
+	HopDown,
+	/** Climbing up until HasReachLedge plays the climb to top montage */
+	Mantle,
+	/** CanClimbDownLedge from a ground node facing away from the ledge */
+	ClimbDownLedge,
+	/** CanStartVaulting from a ground node facing the obstacle */
+	Vault,
+
+	Num UMETA(Hidden)
+};
+
+/** Where a climber stands or hangs, in world space */
+USTRUCT()
+struct PEAKPURSUIT_API FClimbGraphNode
+{
+	GENERATED_BODY()
+
+	/** Capsule center of the climber at the node */
+	UPROPERTY(VisibleAnywhere, Category = "Climb Graph")
+	FVector Location = FVector::ZeroVector;
+
+	/** Wall normal for wall nodes, the direction to face at ground nodes is given by the links leaving them */
+	UPROPERTY(VisibleAnywhere, Category = "Climb Graph")
+	FVector Normal = FVector::ZeroVector;
+
+	UPROPERTY(VisibleAnywhere, Category = "Climb Graph")
+	EClimbGraphNodeType Type = EClimbGraphNodeType::Ground;
+
+	/** Outgoing links are Links[FirstLink, FirstLink + NumLinks) */
+	UPROPERTY(VisibleAnywhere, Category = "Climb Graph")
+	int32 FirstLink = 0;
+
+	UPROPERTY(VisibleAnywhere, Category = "Climb Graph")
+	int32 NumLinks = 0;
+};
+
+USTRUCT()
+struct PEAKPURSUIT_API FClimbGraphLink
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, Category = "Climb Graph")
+	int32 To = INDEX_NONE;
+
+	UPROPERTY(VisibleAnywhere, Category = "Climb Graph")
+	EClimbGraphLinkType Type = EClimbGraphLinkType::Climb;
+
+	/** Estimated seconds to take the link */
+	UPROPERTY(VisibleAnywhere, Category = "Climb Graph")
+	float Cost = 0.0f;
+};
+
+/** Ground to ground connection over climb links, registered with the nav mesh as a custom nav link */
+USTRUCT()
+struct PEAKPURSUIT_API FClimbGraphRoute
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, Category = "Climb Graph")
+	int32 From = INDEX_NONE;
+
+	UPROPERTY(VisibleAnywhere, Category = "Climb Graph")
+	int32 To = INDEX_NONE;
+
+	UPROPERTY(VisibleAnywhere, Category = "Climb Graph")
+	float Cost = 0.0f;
+};
+
+/**
+ * Climb graph of one level, written by the ClimbGraphBuild commandlet to UClimbSettings::LedgeDataDirectory/ClimbGraph_<Map>
+ * and searched by UClimbGraphSubsystem when the level begins play.
+ */
+UCLASS()
+class PEAKPURSUIT_API UClimbGraphData : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(VisibleAnywhere, Category = "Climb Graph")
+	FString SourceMap;
+
+	/** Size of the runtime lookup grid cells */
+	UPROPERTY(EditAnywhere, Category = "Climb Graph", meta = (ClampMin = "10"))
+	float CellSize = 200.0f;
+
+	/** Height of the standing capsule center above the floor at ground nodes */
+	UPROPERTY(VisibleAnywhere, Category = "Climb Graph")
+	float StandingHalfHeight = 96.0f;
+
+	/** Fastest distance per second over any link, keeps the A* heuristic from overestimating */
+	UPROPERTY(VisibleAnywhere, Category = "Climb Graph")
+	float HeuristicSpeed = 600.0f;
+
+	UPROPERTY(VisibleAnywhere, Category = "Climb Graph")
+	TArray<FClimbGraphNode> Nodes;
+
+	/** Grouped by the node they leave from */
+	UPROPERTY(VisibleAnywhere, Category = "Climb Graph")
+	TArray<FClimbGraphLink> Links;
+
+	UPROPERTY(VisibleAnywhere, Category = "Climb Graph")
+	TArray<FClimbGraphRoute> Routes;
+
+	TConstArrayView<FClimbGraphLink> GetLinks(int32 NodeIndex) const
+	{
+		const FClimbGraphNode& Node = Nodes[NodeIndex];
+		return MakeArrayView(Links.GetData() + Node.FirstLink, Node.NumLinks);
+	}
+};
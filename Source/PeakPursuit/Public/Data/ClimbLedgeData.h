@@ -0,0 +1,47 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ClimbLedgeData.generated.h"
+
+/** Convex edge between a climbable wall and the walkable top above it, in world space */
+USTRUCT()
+struct PEAKPURSUIT_API FClimbLedgeSegment
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, Category = "Ledge")
+	FVector Start = FVector::ZeroVector;
+
+	UPROPERTY(VisibleAnywhere, Category = "Ledge")
+	FVector End = FVector::ZeroVector;
+
+	/** Horizontal normal of the wall below the edge, pointing away from the walkable top */
+	UPROPERTY(VisibleAnywhere, Category = "Ledge")
+	FVector OutwardNormal = FVector::ZeroVector;
+
+	FVector GetClosestPoint(const FVector& Point) const { return FMath::ClosestPointOnSegment(Point, Start, End); }
+};
+
+/**
+ * Ledges of one level, written by the ClimbLedgeExtract commandlet to UClimbSettings::LedgeDataDirectory/Ledges_<Map>
+ * and indexed by UClimbLedgeSubsystem when the level begins play.
+ */
+UCLASS()
+class PEAKPURSUIT_API UClimbLedgeData : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(VisibleAnywhere, Category = "Ledges")
+	FString SourceMap;
+
+	/** Size of the runtime lookup grid cells */
+	UPROPERTY(EditAnywhere, Category = "Ledges", meta = (ClampMin = "10"))
+	float CellSize = 200.0f;
+
+	UPROPERTY(VisibleAnywhere, Category = "Ledges")
+	TArray<FClimbLedgeSegment> Segments;
+};
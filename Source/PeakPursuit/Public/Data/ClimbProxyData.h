@@ -0,0 +1,46 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/AssetUserData.h"
+#include "ClimbProxyData.generated.h"
+
+class UStaticMesh;
+
+/**
+ * Simplified climb collision of a static mesh, written by the ClimbProxyBuild commandlet.
+ * Lives as asset user data on the source mesh; UClimbProxySubsystem attaches the proxy next to every component
+ * of that mesh when climb proxies are enabled.
+ */
+UCLASS()
+class PEAKPURSUIT_API UClimbProxyData : public UAssetUserData
+{
+	GENERATED_BODY()
+
+public:
+	/** Mesh space shell on the ClimbProxy channel, collision only */
+	UPROPERTY(VisibleAnywhere, Category = "Climb Proxy")
+	TObjectPtr<UStaticMesh> ProxyMesh;
+
+	/** LOD0 triangles of the source mesh */
+	UPROPERTY(VisibleAnywhere, Category = "Climb Proxy")
+	int32 SourceTriangles = 0;
+
+	/** Source triangles left out as foliage */
+	UPROPERTY(VisibleAnywhere, Category = "Climb Proxy")
+	int32 ExcludedTriangles = 0;
+
+	UPROPERTY(VisibleAnywhere, Category = "Climb Proxy")
+	int32 ProxyTriangles = 0;
+
+	/** Mean distance from the kept source surface to the proxy */
+	UPROPERTY(VisibleAnywhere, Category = "Climb Proxy")
+	float MeanDeviation = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, Category = "Climb Proxy")
+	float MaxDeviation = 0.0f;
+
+	/** Collision profile of the proxy components, declared in DefaultEngine.ini */
+	static FName GetCollisionProfileName() { return TEXT("ClimbProxy"); }
+};
@@ -0,0 +1,67 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/AssetUserData.h"
+#include "Serialization/BulkData.h"
+#include "ClimbSurfaceField.generated.h"
+
+/**
+ * Baked signed distance field with surface normals for a climbable static mesh.
+ * Lives as asset user data on the mesh so it is cooked with it; the voxel payload is
+ * stored as memory-mappable bulk data and is only ever read on the game thread.
+ */
+UCLASS()
+class PEAKPURSUIT_API UClimbSurfaceField : public UAssetUserData
+{
+	GENERATED_BODY()
+
+public:
+	/** Mesh space bounds covered by the field */
+	UPROPERTY(VisibleAnywhere, Category = "Climb Surface Field")
+	FBox LocalBounds = FBox(ForceInit);
+
+	UPROPERTY(VisibleAnywhere, Category = "Climb Surface Field")
+	FIntVector Resolution = FIntVector::ZeroValue;
+
+	UPROPERTY(VisibleAnywhere, Category = "Climb Surface Field")
+	float VoxelSize = 10.0f;
+
+	/** Distances are clamped to this band around the surface */
+	UPROPERTY(VisibleAnywhere, Category = "Climb Surface Field")
+	float MaxDistance = 100.0f;
+
+	virtual void Serialize(FArchive& Ar) override;
+	virtual void PostLoad() override;
+	virtual void BeginDestroy() override;
+
+	bool IsValidField() const { return Voxels != nullptr; }
+
+	/**
+	 * Samples the field at a point in mesh space.
+	 * @return false when the point is outside the field or beyond the baked band
+	 */
+	bool Sample(const FVector& LocalPoint, float& OutDistance, FVector& OutNormal) const;
+
+#if WITH_EDITOR
+	/** Rebuilds the field from the mesh's LOD0 triangles */
+	bool Bake(const class UStaticMesh* Mesh, float InVoxelSize, float InMaxDistance);
+#endif
+
+private:
+	/** Quantized distance and octahedral encoded normal, 4 bytes per voxel */
+	struct FVoxel
+	{
+		int16 Distance;
+		int8 NormalX;
+		int8 NormalY;
+	};
+
+	void LockVoxels();
+	void UnlockVoxels();
+	const FVoxel& GetVoxel(int32 X, int32 Y, int32 Z) const;
+
+	FByteBulkData VoxelData;
+	const FVoxel* Voxels = nullptr;
+};
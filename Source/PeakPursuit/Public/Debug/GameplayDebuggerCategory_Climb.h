@@ -0,0 +1,47 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Climb/ClimbProbeRecorder.h"
+
+#if WITH_GAMEPLAY_DEBUGGER && WITH_CLIMB_PROBE_RECORDER
+
+#include "GameplayDebuggerCategory.h"
+
+class UClimbMovementComponent;
+
+/**
+ * Draws the recorded climb probes of the debug actor, one frame at a time, with its climb state history.
+ * Data is collected where the climber is simulated and replicated by the gameplay debugger, so it also shows the
+ * server side probes on a dedicated server. Selecting a climber starts its recording, scrubbing back freezes it until
+ * the category returns to the live frame.
+ */
+class FGameplayDebuggerCategory_Climb : public FGameplayDebuggerCategory
+{
+public:
+	FGameplayDebuggerCategory_Climb();
+	virtual ~FGameplayDebuggerCategory_Climb() override;
+
+	virtual void CollectData(APlayerController* OwnerPC, AActor* DebugActor) override;
+	virtual void DrawData(APlayerController* OwnerPC, FGameplayDebuggerCanvasContext& CanvasContext) override;
+	virtual void OnGameplayDebuggerDeactivated() override;
+
+	static TSharedRef<FGameplayDebuggerCategory> MakeInstance();
+
+private:
+	void SetRecordedMovement(UClimbMovementComponent* Movement);
+	void ShowOlderFrame();
+	void ShowNewerFrame();
+	void ShowLiveFrame();
+
+	void AddProbeShapes(const FClimbProbeRecord& ProbeRecord);
+
+	/** The climber recording for this category */
+	TWeakObjectPtr<UClimbMovementComponent> RecordedMovement;
+
+	/** Recorded frame shown while scrubbing, the newest one is shown when not set */
+	TOptional<uint32> ScrubFrame;
+};
+
+#endif
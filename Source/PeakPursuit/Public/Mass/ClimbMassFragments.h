@@ -0,0 +1,58 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTypes.h"
+#include "ClimbMassFragments.generated.h"
+
+/** Surface a crowd climber is attached to, mirrors CurrentClimbableSurfaceLocation/Normal on the component */
+USTRUCT()
+struct PEAKPURSUIT_API FClimbSurfaceFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector Location = FVector::ZeroVector;
+
+	UPROPERTY()
+	FVector Normal = FVector::BackwardVector;
+};
+
+/** Desired climb velocity, written by whatever drives the crowd and kept on the surface plane by the processor */
+USTRUCT()
+struct PEAKPURSUIT_API FClimbVelocityFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector Velocity = FVector::ZeroVector;
+};
+
+/** Per config climb tuning, shared by every entity built from the same trait */
+USTRUCT()
+struct PEAKPURSUIT_API FClimbMassParameters : public FMassSharedFragment
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = "Climb", meta = (ClampMin = "0"))
+	float MaxClimbSpeed = 100.0f;
+
+	UPROPERTY(EditAnywhere, Category = "Climb", meta = (ClampMin = "0"))
+	float ClimbRotInterpSpeed = 5.0f;
+
+	/** Crowd climbers do not sweep, so the snap is an interpolation that can never overshoot the surface */
+	UPROPERTY(EditAnywhere, Category = "Climb", meta = (ClampMin = "0"))
+	float SnapInterpSpeed = 10.0f;
+
+	/** Distance kept from the surface, the capsule radius does this for characters */
+	UPROPERTY(EditAnywhere, Category = "Climb", meta = (ClampMin = "0"))
+	float SurfaceOffset = 42.0f;
+};
+
+/** The entity is currently represented by a full character and skipped by the Mass climb simulation */
+USTRUCT()
+struct PEAKPURSUIT_API FClimbPromotedTag : public FMassTag
+{
+	GENERATED_BODY()
+};
@@ -0,0 +1,45 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassProcessor.h"
+#include "MassEntityQuery.h"
+#include "ClimbMassProcessors.generated.h"
+
+/**
+ * Moves crowd climbers along their surface: velocity is kept on the surface plane, then the same snap and
+ * rotation steps as UClimbMovementComponent run chunk by chunk. There are no probes, the surface is assumed planar.
+ */
+UCLASS()
+class PEAKPURSUIT_API UClimbMassProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UClimbMassProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+private:
+	FMassEntityQuery EntityQuery;
+};
+
+/** Finds crowd climbers close to a player and queues them for promotion in UClimbCrowdSubsystem */
+UCLASS()
+class PEAKPURSUIT_API UClimbMassPromotionProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UClimbMassPromotionProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+private:
+	FMassEntityQuery EntityQuery;
+};
@@ -0,0 +1,24 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTraitBase.h"
+#include "Mass/ClimbMassFragments.h"
+#include "ClimbMassTrait.generated.h"
+
+/**
+ * Lightweight climber for background crowds. Add it to a Mass entity config next to a visualization trait;
+ * UClimbMassProcessor moves the entities and UClimbCrowdSubsystem swaps them for full characters near players.
+ */
+UCLASS(meta = (DisplayName = "Climber"))
+class PEAKPURSUIT_API UClimbMassTrait : public UMassEntityTraitBase
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const override;
+
+	UPROPERTY(EditAnywhere, Category = "Climb")
+	FClimbMassParameters Parameters;
+};
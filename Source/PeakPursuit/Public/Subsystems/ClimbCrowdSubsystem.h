@@ -0,0 +1,47 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MassEntityTypes.h"
+#include "ClimbCrowdSubsystem.generated.h"
+
+class APeakPursuitCharacter;
+
+/**
+ * Swaps Mass crowd climbers for full characters near players and back.
+ * UClimbMassPromotionProcessor queues entities in range; promotion spawns UClimbSettings::CrowdClimberClass
+ * on the entity's surface, possessed by an AClimbCrowdController that keeps the entity's FClimbVelocityFragment,
+ * and tags the entity so the Mass simulation skips it. Promoted characters that are
+ * still climbing past CrowdDemoteDistance write their state back to the entity and are destroyed.
+ */
+UCLASS()
+class PEAKPURSUIT_API UClimbCrowdSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	bool CanPromote() const;
+	void RequestPromotion(FMassEntityHandle Entity);
+	const TArray<FVector>& GetViewpoints() const { return Viewpoints; }
+	int32 GetNumPromoted() const { return Promoted.Num(); }
+
+private:
+	void Promote(FMassEntityHandle Entity);
+	void Demote(FMassEntityHandle Entity, APeakPursuitCharacter* Character);
+	void UpdateViewpoints();
+
+	UPROPERTY(Transient)
+	TSubclassOf<APeakPursuitCharacter> CrowdClimberClass;
+
+	TMap<FMassEntityHandle, TWeakObjectPtr<APeakPursuitCharacter>> Promoted;
+	TArray<FMassEntityHandle> PendingPromotions;
+	TArray<FVector> Viewpoints;
+};
@@ -0,0 +1,56 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Data/ClimbGraphData.h"
+#include "Climb/ClimbGraphPathfinder.h"
+#include "ClimbGraphSubsystem.generated.h"
+
+/**
+ * Loads the level's UClimbGraphData on begin play, buckets its nodes into a uniform grid and plans climb paths over it
+ * with A*, without physics queries. Its ground to ground routes are registered as custom nav links, so AI moving on the
+ * nav mesh climbs where the route is shorter, see UClimbNavLinkComponent. A static nav mesh cannot take them.
+ */
+UCLASS()
+class PEAKPURSUIT_API UClimbGraphSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	bool HasGraphData() const { return GraphData != nullptr; }
+	const UClimbGraphData* GetGraphData() const { return GraphData; }
+
+	/** Closest node of the type within MaxDistance of Location, INDEX_NONE when there is none */
+	int32 FindNearestNode(const FVector& Location, float MaxDistance, EClimbGraphNodeType Type) const;
+
+	/** Cheapest climb path between two nodes. Game thread only, the search reuses the subsystem's scratch memory */
+	bool FindPath(int32 StartNode, int32 GoalNode, FClimbGraphPath& OutPath);
+
+	/** Cheapest climb path from the node closest to Start to the node closest to Goal, of any type, within MaxNodeDistance */
+	bool FindPath(const FVector& Start, const FVector& Goal, FClimbGraphPath& OutPath, float MaxNodeDistance = 200.0f);
+
+	static FString GetGraphDataPath(const FString& MapPackageName);
+
+private:
+	FIntVector GetCell(const FVector& Location) const;
+	int32 FindNearestNode(const FVector& Location, float MaxDistance, TFunctionRef<bool(const FClimbGraphNode&)> Accept) const;
+	void RegisterNavLinks(UWorld& InWorld);
+
+	UPROPERTY(Transient)
+	TObjectPtr<UClimbGraphData> GraphData;
+
+	/** Owns one UClimbNavLinkComponent per route */
+	UPROPERTY(Transient)
+	TObjectPtr<AActor> NavLinksActor;
+
+	float InvCellSize = 0.0f;
+	TMap<FIntVector, TArray<int32>> Cells;
+
+	FClimbGraphPathfinder Pathfinder;
+};
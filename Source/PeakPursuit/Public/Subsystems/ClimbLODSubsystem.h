@@ -0,0 +1,39 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Climb/ClimbSettings.h"
+#include "ClimbLODSubsystem.generated.h"
+
+class UClimbMovementComponent;
+
+/**
+ * Assigns climb LOD tiers through the significance manager.
+ * Climbers register on BeginPlay; every tick the subsystem updates the significance manager from the
+ * player viewpoints and the post significance callback pushes the tier to each climb movement component.
+ */
+UCLASS()
+class PEAKPURSUIT_API UClimbLODSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static const FName ClimberSignificanceTag;
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterClimber(UClimbMovementComponent* ClimbMovement);
+	void UnregisterClimber(UClimbMovementComponent* ClimbMovement);
+
+	int32 GetNumClimbersInTier(EClimbLODTier Tier) const { return ClimbersPerTier[(int32)Tier]; }
+
+private:
+	TArray<TWeakObjectPtr<UClimbMovementComponent>> Climbers;
+	TArray<FTransform> Viewpoints;
+	int32 ClimbersPerTier[(int32)EClimbLODTier::Num] = {};
+};
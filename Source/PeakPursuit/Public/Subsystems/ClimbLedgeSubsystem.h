@@ -0,0 +1,41 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ClimbLedgeSubsystem.generated.h"
+
+class UClimbLedgeData;
+struct FClimbLedgeSegment;
+
+/**
+ * Loads the level's UClimbLedgeData on begin play and buckets its segments into a uniform grid,
+ * so ledge checks become a lookup of the few segments around the capsule.
+ */
+UCLASS()
+class PEAKPURSUIT_API UClimbLedgeSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	bool HasLedgeData() const { return LedgeData != nullptr; }
+
+	/** Calls Accept for segments in the cells overlapping Bounds until it returns true. Segments may be visited more than once */
+	bool FindLedge(const FBox& Bounds, TFunctionRef<bool(const FClimbLedgeSegment&)> Accept) const;
+
+	static FString GetLedgeDataPath(const FString& MapPackageName);
+
+private:
+	FIntVector GetCell(const FVector& Location) const;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UClimbLedgeData> LedgeData;
+
+	float InvCellSize = 0.0f;
+	TMap<FIntVector, TArray<int32>> Cells;
+};
@@ -0,0 +1,94 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "Climb/ClimbQueryPlan.h"
+#include "ClimbProbeSubsystem.generated.h"
+
+class UClimbMovementComponent;
+
+/** Who gets world probes first when the frame budget runs out */
+enum class EClimbProbePriority : uint8
+{
+	/** Player controlled climbers, never deferred since corrections and input latency would show */
+	Player,
+	/** Climbers rendered recently */
+	Visible,
+	Distant,
+
+	Num
+};
+
+/** Probe work of one frame */
+struct FClimbProbeFrameStats
+{
+	/** Probes every climber may issue, and the part left to non player climbers after the player reserve */
+	int32 ProbeBudget = 0;
+	int32 GrantBudget = 0;
+
+	int32 ProbesIssued = 0;
+	int32 PlayerProbesIssued = 0;
+	double ProbeSeconds = 0.0;
+	double PlayerProbeSeconds = 0.0;
+
+	/** Climb ticks that probed because they were granted, forced past the staleness limit or deferred to a later frame */
+	int32 Granted = 0;
+	int32 Forced = 0;
+	int32 Deferred = 0;
+
+	float GetBudgetUsage() const { return ProbeBudget > 0 ? (float)ProbesIssued / ProbeBudget : 0.0f; }
+};
+
+/**
+ * Owns the world probe budget of every climber.
+ * A climb tick that needs fresh probes asks for a slot. Player climbers always get one; others get one right away
+ * while the frame's probe and time budget has room, when they were granted a slot at the end of the previous
+ * frame, or once they waited ProbeStalenessFrames.
+ * Denied climbers reuse their cached probes and their request is queued. At the end of the frame the queue
+ * is sorted by priority then wait and granted up to what the player climbers left of the budget, those grants
+ * are kept out of the next frame's room so the deferred climbers go first.
+ */
+UCLASS()
+class PEAKPURSUIT_API UClimbProbeSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** True when the climber may hit the world this tick, FramesDeferred being how many ticks it was denied in a row */
+	bool AcquireProbeSlot(const UClimbMovementComponent* Climber, EClimbProbePriority Priority, int32 FramesDeferred);
+
+	/** Called by every climb tick that hit the world with the probes it issued and how long it took */
+	void ReportProbeCost(EClimbProbePriority Priority, int32 NumProbes, double Seconds);
+
+	const FClimbProbeFrameStats& GetLastFrameStats() const { return LastFrameStats; }
+
+	static EClimbProbePriority GetProbePriority(const UClimbMovementComponent* Climber);
+
+private:
+	struct FProbeRequest
+	{
+		TObjectKey<UClimbMovementComponent> Climber;
+		EClimbProbePriority Priority;
+		int32 FramesDeferred;
+	};
+
+	/** True when NumTicks more non player climb ticks fit in what is left of this frame's budget */
+	bool HasBudgetFor(int32 NumTicks) const;
+
+	TArray<FProbeRequest> PendingRequests;
+	TSet<TObjectKey<UClimbMovementComponent>> Grants;
+
+	FClimbProbeFrameStats FrameStats;
+	FClimbProbeFrameStats LastFrameStats;
+
+	/** Running averages over probing non player climb ticks, used to turn the remaining budget into grants */
+	float AverageProbesPerTick = (float)EClimbProbe::Num;
+	double AverageSecondsPerTick = 0.0;
+};
@@ -0,0 +1,39 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ClimbProxySubsystem.generated.h"
+
+class ULevel;
+
+/**
+ * Attaches the climb proxy of every static mesh carrying a UClimbProxyData, on begin play and as actors are spawned
+ * or streamed in. Proxies are invisible, query only and follow their source through the attachment.
+ */
+UCLASS()
+class PEAKPURSUIT_API UClimbProxySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	int32 GetNumProxies() const { return NumProxies; }
+
+private:
+	void AddProxies(AActor* Actor);
+
+	void OnActorSpawned(AActor* Actor);
+	void OnLevelAdded(ULevel* Level, UWorld* World);
+
+	int32 NumProxies = 0;
+
+	FDelegateHandle ActorSpawnedHandle;
+	FDelegateHandle LevelAddedHandle;
+};
@@ -0,0 +1,80 @@
+// Copyright 2020-2023 NiceBug Games All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "Engine/EngineTypes.h"
+#include "Components/SceneComponent.h"
+#include "Climb/ClimbAABBTree.h"
+#include "ClimbablePrimitiveSubsystem.generated.h"
+
+class UPrimitiveComponent;
+struct FCollisionObjectQueryParams;
+
+/** Primitives a climb query has to test, few enough to query one by one */
+using FClimbablePrimitiveCandidates = TArray<UPrimitiveComponent*, TInlineAllocator<8>>;
+
+/**
+ * Keeps the primitives climbers can hit in a dynamic AABB tree, so a climb query is culled against a small set of
+ * candidates instead of the whole physics scene. Once a climber registers the object types it queries, every primitive
+ * is added when its physics state is created and removed when it is destroyed, which covers spawning, deferred
+ * spawns, streaming, late registration and collision turned on later. Movable primitives follow their transform
+ * updates. Object type and query collision can change at any time, so candidates are filtered on them per query.
+ */
+UCLASS()
+class PEAKPURSUIT_API UClimbablePrimitiveSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Marks the queried object types as answerable, the first call starts tracking and adds the primitives already in the world */
+	void RegisterObjectTypes(const FCollisionObjectQueryParams& ObjectQueryParams);
+
+	/**
+	 * Primitives of the queried types whose bounds overlap QueryBounds.
+	 * Returns false when the query has to go to the scene instead: a type is not tracked or there are more than
+	 * MaxClimbableCandidates candidates.
+	 */
+	bool GatherCandidates(const FBox& QueryBounds, const FCollisionObjectQueryParams& ObjectQueryParams, FClimbablePrimitiveCandidates& OutCandidates) const;
+
+	/** Refreshes the bounds of a primitive that grew without a transform update, such as instances added to a climb proxy */
+	void UpdatePrimitiveBounds(UPrimitiveComponent* Primitive);
+
+	int32 GetNumPrimitives() const { return ClimbableTree.GetNumProxies(); }
+
+private:
+	struct FClimbablePrimitive
+	{
+		TWeakObjectPtr<UPrimitiveComponent> Component;
+		TObjectKey<UPrimitiveComponent> Key;
+		int32 ProxyId = INDEX_NONE;
+		FDelegateHandle TransformUpdatedHandle;
+	};
+
+	void AddPrimitive(UPrimitiveComponent* Primitive);
+	void RemovePrimitive(int32 PrimitiveIndex);
+
+	void OnPhysicsStateCreated(UActorComponent* Component);
+	void OnPhysicsStateDestroyed(UActorComponent* Component);
+	void OnPrimitiveMoved(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport, int32 PrimitiveIndex);
+
+	FClimbAABBTree ClimbableTree;
+	TSparseArray<FClimbablePrimitive> Primitives;
+	TMap<TObjectKey<UPrimitiveComponent>, int32> PrimitiveIndices;
+
+	/** ECC_TO_BITFIELD of every object type a climber queries */
+	int32 RegisteredObjectTypes = 0;
+
+	/** UClimbSettings::MaxClimbableCandidates */
+	int32 MaxCandidates = 4;
+
+	FDelegateHandle PhysicsStateCreatedHandle;
+	FDelegateHandle PhysicsStateDestroyedHandle;
+};